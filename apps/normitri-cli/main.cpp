@@ -7,6 +7,7 @@
 
 #include <normitri/app/config.hpp>
 #include <normitri/app/pipeline_runner.hpp>
+#include <normitri/core/buffer_pool.hpp>
 #include <normitri/core/defect.hpp>
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/frame.hpp>
@@ -17,18 +18,23 @@
 #include <normitri/vision/mock_inference_backend.hpp>
 #include <normitri/vision/normalize_stage.hpp>
 #include <normitri/vision/onnx_inference_backend.hpp>
+#include <normitri/vision/preprocess_stage.hpp>
 #include <normitri/vision/resize_stage.hpp>
 #ifdef NORMITRI_HAS_TENSORRT
 #include <normitri/vision/tensorrt_inference_backend.hpp>
 #endif
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -48,14 +54,45 @@ std::string defect_kind_str(normitri::core::DefectKind k) {
   }
 }
 
+/// Startup time on stderr: session creation (cold or from the optimized-model cache) + warmup.
+void report_onnx_startup(normitri::vision::OnnxCacheStatus cache,
+                         std::chrono::steady_clock::duration session,
+                         std::chrono::steady_clock::duration warmup) {
+  using ms = std::chrono::duration<double, std::milli>;
+  const char *mode = cache == normitri::vision::OnnxCacheStatus::Hit    ? "warm (cache hit)"
+                     : cache == normitri::vision::OnnxCacheStatus::Miss ? "cold (cache miss)"
+                                                                         : "cold (cache off)";
+  std::cerr << "onnx startup: " << ms(session + warmup).count() << " ms " << mode
+            << " [session " << ms(session).count() << " ms, warmup " << ms(warmup).count()
+            << " ms]\n";
+}
+
 normitri::core::Pipeline build_pipeline(const normitri::app::PipelineConfig &cfg) {
   using namespace normitri::core;
   using namespace normitri::vision;
 
   normitri::core::Pipeline pipeline;
 
-  pipeline.add_stage(std::make_unique<ResizeStage>(cfg.resize_width, cfg.resize_height));
-  pipeline.add_stage(std::make_unique<NormalizeStage>(cfg.normalize_mean, cfg.normalize_scale));
+  // One pool per pipeline: stage outputs are recycled instead of reallocated on every frame.
+  std::shared_ptr<BufferPool> pool;
+  if (cfg.buffer_pool_mb > 0) {
+    pool = std::make_shared<BufferPool>(cfg.buffer_pool_mb << 20);
+  }
+
+  if (cfg.preprocess == normitri::app::PreprocessMode::Fused) {
+    PreprocessOptions opts;
+    opts.width = cfg.resize_width;
+    opts.height = cfg.resize_height;
+    opts.mean = cfg.normalize_mean;
+    opts.scale = cfg.normalize_scale;
+    opts.channel_order = cfg.model_channel_order;
+    pipeline.add_stage(std::make_unique<PreprocessStage>(opts, pool));
+  } else {
+    pipeline.add_stage(std::make_unique<ResizeStage>(cfg.resize_width, cfg.resize_height, pool));
+    pipeline.add_stage(
+        std::make_unique<NormalizeStage>(cfg.normalize_mean, cfg.normalize_scale, pool,
+                                         cfg.normalize_layout));
+  }
 
   ClassToDefectKindMap class_to_kind = {
       DefectKind::WrongItem,
@@ -63,15 +100,21 @@ normitri::core::Pipeline build_pipeline(const normitri::app::PipelineConfig &cfg
       DefectKind::ExpiredOrQuality,
       DefectKind::ProcessError,
   };
-  DefectDecoder decoder(cfg.confidence_threshold, std::move(class_to_kind));
+  DefectDecoder decoder(cfg.confidence_threshold, std::move(class_to_kind), cfg.nms);
 
   std::unique_ptr<IInferenceBackend> backend;
   if (cfg.backend_type == normitri::app::InferenceBackendType::Onnx) {
     if (cfg.model_path.empty()) {
       throw std::runtime_error("backend_type=onnx requires model_path to be set in config");
     }
-    auto onnx = std::make_unique<OnnxInferenceBackend>(cfg.model_path);
+    const auto start = std::chrono::steady_clock::now();
+    auto onnx = std::make_unique<OnnxInferenceBackend>(cfg.model_path, std::string{},
+                                                       std::array<std::string, 3>{},
+                                                       cfg.onnx_session);
+    const auto loaded = std::chrono::steady_clock::now();
     onnx->warmup();
+    const auto warm = std::chrono::steady_clock::now();
+    report_onnx_startup(onnx->cache_status(), loaded - start, warm - loaded);
     backend = std::move(onnx);
   }
 #ifdef NORMITRI_HAS_TENSORRT
@@ -104,6 +147,36 @@ normitri::core::Frame make_dummy_frame(std::uint32_t w, std::uint32_t h) {
   return normitri::core::Frame(w, h, normitri::core::PixelFormat::RGB8, std::move(buffer));
 }
 
+/// CLI flags that set one config key each (same values as in the config file).
+struct ConfigFlag {
+  const char *flag;
+  const char *key;
+};
+
+constexpr std::array<ConfigFlag, 14> kConfigFlags{{
+    {"--onnx-intra-threads", "onnx_intra_op_threads"},
+    {"--onnx-inter-threads", "onnx_inter_op_threads"},
+    {"--onnx-execution", "onnx_execution_mode"},
+    {"--onnx-optimization", "onnx_graph_optimization"},
+    {"--onnx-mem-pattern", "onnx_mem_pattern"},
+    {"--onnx-arena", "onnx_cpu_mem_arena"},
+    {"--onnx-spin", "onnx_allow_spinning"},
+    {"--onnx-global-threads", "onnx_global_thread_pool"},
+    {"--onnx-cache-dir", "onnx_cache_dir"},
+    {"--onnx-share-weights", "onnx_share_weights"},
+    {"--nms-iou", "nms_iou_threshold"},
+    {"--nms-top-k", "nms_top_k"},
+    {"--max-detections", "nms_max_detections"},
+    {"--nms-class-aware", "nms_class_aware"},
+}};
+
+const ConfigFlag *find_config_flag(const std::string &arg) {
+  for (const auto &f : kConfigFlags) {
+    if (arg == f.flag) return &f;
+  }
+  return nullptr;
+}
+
 } // namespace
 
 int main(int argc, char *argv[]) {
@@ -111,6 +184,8 @@ int main(int argc, char *argv[]) {
   std::string input_path;
   std::string backend_override;  // "mock", "onnx", or "tensorrt"
   std::string model_override;
+  std::string preprocess_override;  // "chain" or "fused"
+  std::vector<std::pair<const ConfigFlag *, std::string>> config_overrides;
 
   for (int i = 1; i < argc; ++i) {
     const std::string arg = argv[i];
@@ -122,12 +197,32 @@ int main(int argc, char *argv[]) {
       backend_override = argv[++i];
     } else if (arg == "--model" && i + 1 < argc) {
       model_override = argv[++i];
+    } else if (arg == "--preprocess" && i + 1 < argc) {
+      preprocess_override = argv[++i];
+    } else if (const ConfigFlag *flag = find_config_flag(arg); flag && i + 1 < argc) {
+      config_overrides.emplace_back(flag, argv[++i]);
     } else if (arg == "--help" || arg == "-h") {
       std::cout << "Usage: normitri_cli [options] [--input <path>]\n"
                 << "  --config <path>   Pipeline config (key=value file); default: built-in (mock)\n"
                 << "  --backend <type>  Override backend: mock | onnx | tensorrt (default from config)\n"
                 << "  --model <path>    Override model path (required for --backend onnx or tensorrt)\n"
                 << "  --input <path>    Image path (optional; demo uses synthetic frame)\n"
+                << "  --preprocess <m>  chain (Resize+Normalize) | fused (single pass to CHW)\n"
+                << "\nONNX Runtime tuning (same values as the onnx_* config keys):\n"
+                << "  --onnx-intra-threads <n>   Threads inside one operator (0 = ORT default)\n"
+                << "  --onnx-inter-threads <n>   Threads across operators in parallel mode\n"
+                << "  --onnx-execution <m>       sequential | parallel\n"
+                << "  --onnx-optimization <l>    disabled | basic | extended | all\n"
+                << "  --onnx-mem-pattern <b>     on | off (memory pattern planning)\n"
+                << "  --onnx-arena <b>           on | off (CPU memory arena)\n"
+                << "  --onnx-spin <b>            on | off (idle thread spinning)\n"
+                << "  --onnx-global-threads <b>  on | off (share process-wide thread pools)\n"
+                << "  --onnx-cache-dir <dir>     Optimized-model cache (startup time is reported)\n"
+                << "  --onnx-share-weights <b>   on | off (load each model once per process)\n"
+                << "  --nms-iou <t>              Suppress same-class overlaps above IoU t (1 = off)\n"
+                << "  --nms-top-k <n>            Candidates ranked before NMS (0 = all)\n"
+                << "  --max-detections <n>       Detections kept per frame (0 = no limit)\n"
+                << "  --nms-class-aware <b>      on | off (suppress only overlaps of one class)\n"
                 << "\nBackend selection: config file (backend_type=, model_path=) or --backend/--model.\n";
       return 0;
     }
@@ -156,6 +251,27 @@ int main(int argc, char *argv[]) {
   if (!model_override.empty()) {
     cfg.model_path = model_override;
   }
+  for (const auto &[flag, value] : config_overrides) {
+    bool applied = false;
+    try {
+      applied = normitri::app::apply_config_value(cfg, flag->key, value);
+    } catch (const std::exception &) {  // std::stoi on a non-number
+    }
+    if (!applied) {
+      std::cerr << "Invalid value for " << flag->flag << ": " << value << "\n";
+      return 1;
+    }
+  }
+  if (!preprocess_override.empty()) {
+    if (preprocess_override == "fused") {
+      cfg.preprocess = normitri::app::PreprocessMode::Fused;
+    } else if (preprocess_override == "chain") {
+      cfg.preprocess = normitri::app::PreprocessMode::Chain;
+    } else {
+      std::cerr << "Unknown --preprocess " << preprocess_override << " (use chain or fused)\n";
+      return 1;
+    }
+  }
 
   normitri::core::Pipeline pipeline = build_pipeline(cfg);
 
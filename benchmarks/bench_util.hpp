@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace normitri::bench {
+
+/// Timing summary of one benchmark case (milliseconds per iteration).
+struct BenchResult {
+  double median_ms{0.0};
+  double min_ms{0.0};
+};
+
+/// Runs \p fn \p warmup times untimed, then \p iterations times, and returns median/min latency.
+/// Dependency-free (std::chrono) so benchmarks build wherever the library builds.
+template <typename Fn>
+BenchResult measure(std::size_t iterations, Fn&& fn, std::size_t warmup = 5) {
+  for (std::size_t i = 0; i < warmup; ++i) fn();
+  std::vector<double> samples;
+  samples.reserve(iterations);
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+  }
+  std::sort(samples.begin(), samples.end());
+  BenchResult r;
+  if (samples.empty()) return r;
+  r.median_ms = samples[samples.size() / 2];
+  r.min_ms = samples.front();
+  return r;
+}
+
+/// measure() and print median/min latency and throughput in iterations per second.
+template <typename Fn>
+BenchResult run_bench(const char* name, std::size_t iterations, Fn&& fn,
+                      std::size_t warmup = 5) {
+  const BenchResult r = measure(iterations, std::forward<Fn>(fn), warmup);
+  std::printf("%-40s median %8.3f ms  min %8.3f ms  %8.1f it/s\n", name, r.median_ms, r.min_ms,
+              r.median_ms > 0.0 ? 1000.0 / r.median_ms : 0.0);
+  return r;
+}
+
+/// Memory throughput of one iteration moving \p bytes (read + written), at the median time.
+inline double gigabytes_per_second(const BenchResult& r, std::size_t bytes) {
+  return r.median_ms > 0.0 ? static_cast<double>(bytes) / (r.median_ms * 1e6) : 0.0;
+}
+
+/// Resident set size of this process in bytes (VmRSS from /proc/self/status); 0 where that is
+/// not available.
+inline std::size_t resident_set_bytes() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmRSS:") {
+      std::size_t kib = 0;
+      status >> kib;
+      return kib * 1024;
+    }
+    status.ignore(4096, '\n');
+  }
+  return 0;
+}
+
+/// Keeps the optimizer from discarding a computed value.
+template <typename T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace normitri::bench
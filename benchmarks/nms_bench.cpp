@@ -0,0 +1,90 @@
+// Decode + NMS benchmark: DefectDecoder latency at 100 / 1,000 / 10,000 candidate boxes.
+//
+// Candidates are clustered like a non-end-to-end detector's raw output (several overlapping
+// proposals per object, 4 classes), with every score above the confidence threshold so all of
+// them reach NMS. Each size is timed with the threshold only, with class-aware NMS, and with NMS
+// plus top-k; the NMS inner loop runs on every supported SIMD level.
+//
+// Run: ./build/benchmarks/normitri_nms_bench [iterations]
+
+#include "bench_util.hpp"
+
+#include <normitri/core/defect.hpp>
+#include <normitri/vision/defect_decoder.hpp>
+#include <normitri/vision/inference_result.hpp>
+#include <normitri/vision/simd_kernels.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nv = normitri::vision;
+namespace nc = normitri::core;
+namespace simd = normitri::vision::simd;
+
+namespace {
+
+/// \p count candidates around count / 8 objects, in normalized coordinates.
+nv::InferenceResult make_candidates(std::size_t count) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> pos(0.f, 0.9f);
+  std::normal_distribution<float> jitter(0.f, 0.01f);
+  std::uniform_real_distribution<float> score(0.3f, 1.f);
+  const std::size_t objects = count / 8 + 1;
+  std::vector<std::array<float, 2>> centers(objects);
+  for (auto& c : centers) c = {pos(rng), pos(rng)};
+
+  nv::InferenceResult r;
+  r.num_detections = static_cast<std::uint32_t>(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto& c = centers[i % objects];
+    const float x = c[0] + jitter(rng);
+    const float y = c[1] + jitter(rng);
+    r.boxes.insert(r.boxes.end(), {x, y, x + 0.08f + jitter(rng), y + 0.08f + jitter(rng)});
+    r.scores.push_back(score(rng));
+    r.class_ids.push_back(static_cast<std::int64_t>(i % objects % 4));
+  }
+  return r;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t iterations = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 200;
+  const nv::ClassToDefectKindMap kinds = {nc::DefectKind::WrongItem, nc::DefectKind::WrongQuantity,
+                                          nc::DefectKind::ExpiredOrQuality,
+                                          nc::DefectKind::ProcessError};
+
+  std::printf("%zu iterations, detected: %s (cap with NORMITRI_SIMD)\n", iterations,
+              simd::simd_level_name(simd::detected_simd_level()));
+  for (std::size_t count : {std::size_t{100}, std::size_t{1000}, std::size_t{10000}}) {
+    const nv::InferenceResult r = make_candidates(count);
+    const nv::DetectionView view = nv::DetectionView::of(r);
+    const std::size_t bench_iterations = count >= 10000 ? iterations / 10 + 1 : iterations;
+
+    struct Case {
+      const char* name;
+      nv::NmsOptions nms;
+    };
+    for (const Case& c : {Case{"threshold only", {}},
+                          Case{"nms iou 0.5", {.iou_threshold = 0.5f}},
+                          Case{"nms iou 0.5 top-k 300", {.iou_threshold = 0.5f, .top_k = 300}},
+                          Case{"nms iou 0.5 max 100", {.iou_threshold = 0.5f,
+                                                       .max_detections = 100}}}) {
+      const nv::DefectDecoder decoder(0.25f, kinds, c.nms);
+      std::size_t kept = 0;
+      const std::string name = std::to_string(count) + " boxes, " + c.name;
+      normitri::bench::run_bench(name.c_str(), bench_iterations, [&] {
+        const auto defects = decoder.decode(view);
+        kept = defects.size();
+        normitri::bench::do_not_optimize(kept);
+      });
+      std::printf("%-40s kept %zu\n", "", kept);
+    }
+  }
+  return 0;
+}
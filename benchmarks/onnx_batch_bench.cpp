@@ -0,0 +1,79 @@
+// ONNX batching benchmark: frames/s of OnnxInferenceBackend::infer_batch at batch 1/4/8/16.
+//
+// Frames are CHW float tensors (what PreprocessStage produces), so the numbers isolate the
+// session run: one [N,3,H,W] run for dynamic-batch models, N runs for fixed batch-1 models.
+//
+// Run: ./build/benchmarks/normitri_onnx_batch_bench [model.onnx [iterations]]
+// Default model: $NORMITRI_TEST_ONNX_MODEL, else models/onnx-community__yolov10n/onnx/model.onnx
+
+#include "bench_util.hpp"
+
+#include <normitri/core/frame.hpp>
+#include <normitri/vision/onnx_inference_backend.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace nc = normitri::core;
+namespace nv = normitri::vision;
+
+namespace {
+
+constexpr std::uint32_t kModelSize = 640;
+
+nc::Frame make_tensor_frame(std::uint32_t seed) {
+  const std::size_t bytes = nc::Frame::min_bytes(kModelSize, kModelSize,
+                                                 nc::PixelFormat::Float32Planar);
+  std::vector<std::byte> buffer(bytes);
+  auto* values = reinterpret_cast<float*>(buffer.data());
+  for (std::size_t i = 0; i < bytes / sizeof(float); ++i) {
+    values[i] = static_cast<float>((i * 2654435761u + seed) & 0xff) / 255.f;
+  }
+  nc::Frame frame(kModelSize, kModelSize, nc::PixelFormat::Float32Planar, std::move(buffer));
+  frame.set_layout(nc::TensorLayout::CHW);
+  return frame;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string model = "models/onnx-community__yolov10n/onnx/model.onnx";
+  if (const char* env = std::getenv("NORMITRI_TEST_ONNX_MODEL"); env && env[0] != '\0') {
+    model = env;
+  }
+  if (argc > 1) model = argv[1];
+  const std::size_t iterations = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 20;
+
+  nv::OnnxInferenceBackend backend(model);
+  backend.warmup();
+  std::printf("%s, %ux%u, %zu iterations, batch dimension: %s\n", model.c_str(), kModelSize,
+              kModelSize, iterations, backend.supports_dynamic_batch() ? "dynamic" : "fixed 1");
+  std::printf("%-6s %12s %12s %10s\n", "batch", "median ms", "frames/s", "vs batch 1");
+
+  double single_fps = 0.0;
+  for (std::size_t batch : {1u, 4u, 8u, 16u}) {
+    std::vector<nc::Frame> frames;
+    for (std::size_t i = 0; i < batch; ++i) {
+      frames.push_back(make_tensor_frame(static_cast<std::uint32_t>(i)));
+    }
+    bool ok = true;
+    const auto r = normitri::bench::measure(iterations, [&] {
+      auto results = backend.infer_batch(frames);
+      ok = ok && results.has_value();
+      normitri::bench::do_not_optimize(results);
+    }, 2);
+    if (!ok) {
+      std::fprintf(stderr, "infer_batch failed at batch %zu\n", batch);
+      return 1;
+    }
+    const double fps =
+        r.median_ms > 0.0 ? 1000.0 * static_cast<double>(batch) / r.median_ms : 0.0;
+    if (batch == 1) single_fps = fps;
+    std::printf("%-6zu %12.2f %12.1f %9.2fx\n", batch, r.median_ms, fps,
+                single_fps > 0.0 ? fps / single_fps : 0.0);
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+// ONNX memory benchmark: resident memory added by each additional OnnxInferenceBackend on the
+// same model, with private weights (default) and with share_model_weights.
+//
+// Each mode runs in its own child process so allocator and page-cache state do not carry over.
+// Both modes use the optimized-model cache, so the only difference is weight sharing. The first
+// backend is the baseline: it loads ONNX Runtime and, on a cold cache, writes the cache entry.
+//
+// Run: ./build/benchmarks/normitri_onnx_memory_bench [model.onnx [lanes [private|shared]]]
+// Default model: $NORMITRI_TEST_ONNX_MODEL, else models/onnx-community__yolov10n/onnx/model.onnx
+
+#include "bench_util.hpp"
+
+#include <normitri/vision/onnx_inference_backend.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nv = normitri::vision;
+
+namespace {
+
+double mebibytes(std::size_t bytes) {
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+int run_mode(const std::string& model, std::size_t lanes, bool shared) {
+  nv::OnnxSessionOptions options;
+  options.share_model_weights = shared;
+  options.optimized_model_cache_dir =
+      (std::filesystem::temp_directory_path() / "normitri_memory_bench").string();
+
+  const std::size_t before = normitri::bench::resident_set_bytes();
+  std::vector<std::unique_ptr<nv::OnnxInferenceBackend>> backends;
+  std::vector<std::size_t> rss;
+  for (std::size_t i = 0; i < lanes; ++i) {
+    backends.push_back(std::make_unique<nv::OnnxInferenceBackend>(
+        model, std::string{}, std::array<std::string, 3>{}, options));
+    backends.back()->warmup();  // first run allocates the arena and activations
+    rss.push_back(normitri::bench::resident_set_bytes());
+  }
+  if (rss.front() == 0) {
+    std::fprintf(stderr, "resident set size not available on this platform\n");
+    return 1;
+  }
+
+  const double first = mebibytes(rss.front() - before);
+  const double per_extra =
+      lanes > 1 ? mebibytes(rss.back() - rss.front()) / static_cast<double>(lanes - 1) : 0.0;
+  std::printf("%-8s first backend %8.1f MiB  per additional pipeline %8.1f MiB  total %8.1f MiB\n",
+              shared ? "shared" : "private", first, per_extra, mebibytes(rss.back()));
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string model = "models/onnx-community__yolov10n/onnx/model.onnx";
+  if (const char* env = std::getenv("NORMITRI_TEST_ONNX_MODEL"); env && env[0] != '\0') {
+    model = env;
+  }
+  if (argc > 1) model = argv[1];
+  const std::size_t lanes = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 4;
+  if (lanes == 0) {
+    std::fprintf(stderr, "lanes must be at least 1\n");
+    return 1;
+  }
+  if (argc > 3) {
+    return run_mode(model, lanes, std::string(argv[3]) == "shared");
+  }
+
+  std::printf("%s, %zu backends per mode\n", model.c_str(), lanes);
+  std::fflush(stdout);
+  int status = 0;
+  for (const char* mode : {"private", "shared"}) {
+    const std::string command = "\"" + std::string(argv[0]) + "\" \"" + model + "\" " +
+                                std::to_string(lanes) + " " + mode;
+    if (std::system(command.c_str()) != 0) status = 1;
+  }
+  return status;
+}
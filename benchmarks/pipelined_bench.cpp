@@ -0,0 +1,135 @@
+// Pipelined TBB runner benchmark: frames/s per lane with a serial (stateful) inference stage.
+//
+// Each lane is one camera: its own pipeline of PreprocessStage (stateless) -> a stage that busies
+// its thread for a fixed time, standing in for inference on a backend with one context (not
+// reentrant) -> DefectDetectionStage with the mock backend. "one frame at a time" runs each lane
+// with run_pipeline_batch() (lanes concurrently in a tbb::task_group), so a lane preprocesses and
+// infers in turn; "pipelined" runs run_pipeline_multi_camera_pipelined_tbb(), so a lane
+// preprocesses later frames on other threads while inference runs, and lane throughput tends
+// towards 1 / inference time. Needs TBB.
+//
+// Run: ./build/benchmarks/normitri_pipelined_bench [lanes [frames_per_lane [inference_us]]]
+
+#include "bench_util.hpp"
+
+#include <normitri/app/pipeline_runner.hpp>
+#include <normitri/app/pipeline_runner_tbb.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_stage.hpp>
+#include <normitri/vision/defect_decoder.hpp>
+#include <normitri/vision/defect_detection_stage.hpp>
+#include <normitri/vision/mock_inference_backend.hpp>
+#include <normitri/vision/preprocess_stage.hpp>
+#include <tbb/task_group.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace na = normitri::app;
+namespace nc = normitri::core;
+namespace nv = normitri::vision;
+
+namespace {
+
+/// Passes the frame through after spinning for a fixed time; stateful, so one frame at a time.
+class InferenceDelayStage : public nc::IPipelineStage {
+ public:
+  explicit InferenceDelayStage(std::chrono::microseconds delay) : delay_(delay) {}
+
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    const auto until = std::chrono::steady_clock::now() + delay_;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+    return nc::StageOutput{input};
+  }
+
+ private:
+  std::chrono::microseconds delay_;
+};
+
+nc::Frame make_source(std::uint32_t w, std::uint32_t h) {
+  std::vector<std::byte> pixels(static_cast<std::size_t>(w) * h * 3);
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<std::byte>((i * 131u) >> 3);
+  }
+  return nc::Frame(w, h, nc::PixelFormat::BGR8, std::move(pixels));
+}
+
+nc::Pipeline make_pipeline(std::chrono::microseconds inference) {
+  nc::Pipeline pipeline;
+  pipeline.add_stage(std::make_unique<nv::PreprocessStage>(
+      nv::PreprocessOptions{.width = 224, .height = 224}));
+  pipeline.add_stage(std::make_unique<InferenceDelayStage>(inference));
+  pipeline.add_stage(std::make_unique<nv::DefectDetectionStage>(
+      std::make_unique<nv::MockInferenceBackend>(),
+      nv::DefectDecoder(0.5f, {nc::DefectKind::WrongItem})));
+  return pipeline;
+}
+
+void report(const char* name, const normitri::bench::BenchResult& r, std::size_t frames_per_lane) {
+  const double per_lane = r.median_ms > 0.0 ? 1000.0 * static_cast<double>(frames_per_lane) /
+                                                  r.median_ms
+                                            : 0.0;
+  std::printf("%-40s median %8.3f ms  %8.1f frames/s per lane\n", name, r.median_ms, per_lane);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t lanes = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 4;
+  const std::size_t frames_per_lane =
+      argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 32;
+  const std::chrono::microseconds inference{argc > 3 ? std::atoi(argv[3]) : 500};
+  const std::size_t iterations = 50;
+
+  std::vector<nc::Pipeline> pipelines;
+  std::unordered_map<std::string, nc::Pipeline*> by_unit;
+  std::vector<std::pair<std::string, nc::Frame>> work_items;
+  const nc::Frame source = make_source(640, 480);
+  pipelines.reserve(lanes);
+  for (std::size_t l = 0; l < lanes; ++l) pipelines.push_back(make_pipeline(inference));
+  for (std::size_t l = 0; l < lanes; ++l) by_unit["cam_" + std::to_string(l)] = &pipelines[l];
+  for (std::size_t f = 0; f < frames_per_lane; ++f) {
+    for (std::size_t l = 0; l < lanes; ++l) {
+      work_items.emplace_back("cam_" + std::to_string(l), source);
+    }
+  }
+  const std::vector<nc::Frame> lane_frames(frames_per_lane, source);
+
+  std::atomic<std::size_t> results{0};
+  std::printf("%zu lanes, %zu frames per lane, %lld us inference\n", lanes, frames_per_lane,
+              static_cast<long long>(inference.count()));
+
+  report("one frame at a time", normitri::bench::measure(iterations, [&] {
+           tbb::task_group group;
+           for (nc::Pipeline& pipeline : pipelines) {
+             group.run([&] {
+               na::run_pipeline_batch(pipeline, lane_frames,
+                                      [&](const nc::DefectResult&) { ++results; });
+             });
+           }
+           group.wait();
+         }), frames_per_lane);
+  for (std::size_t tokens : {std::size_t{2}, std::size_t{0}}) {
+    const std::string name =
+        "pipelined, " + (tokens == 0 ? std::string("default") : std::to_string(tokens)) +
+        " tokens";
+    report(name.c_str(), normitri::bench::measure(iterations, [&] {
+             na::run_pipeline_multi_camera_pipelined_tbb(
+                 by_unit, work_items,
+                 [&](const nc::DefectResult&, const std::string&) { ++results; },
+                 na::PipelinedTbbOptions{.max_tokens = tokens});
+           }), frames_per_lane);
+  }
+  std::printf("%zu results\n", results.load());
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Preprocessing benchmark: current stage chain vs fused PreprocessStage.
+//
+// Chain: ResizeStage (cv::resize) -> NormalizeStage (convertTo, HWC float) -> HWC->NCHW copy
+// (what OnnxInferenceBackend::infer does for HWC frames). Fused: PreprocessStage writes the NCHW
+// tensor in one pass. Both run through process_into with reused outputs, as Pipeline::run does.
+//
+// Run: ./build/benchmarks/normitri_preprocess_bench [src_width src_height [iterations]]
+
+#include "bench_util.hpp"
+
+#include <normitri/core/frame.hpp>
+#include <normitri/vision/normalize_stage.hpp>
+#include <normitri/vision/preprocess_stage.hpp>
+#include <normitri/vision/resize_stage.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace nc = normitri::core;
+namespace nv = normitri::vision;
+
+namespace {
+
+constexpr std::uint32_t kModelSize = 640;
+
+nc::Frame make_source(std::uint32_t w, std::uint32_t h) {
+  std::vector<std::byte> pixels(static_cast<std::size_t>(w) * h * 3);
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<std::byte>((i * 131u) >> 3);
+  }
+  return nc::Frame(w, h, nc::PixelFormat::BGR8, std::move(pixels));
+}
+
+/// Same loop as the backend's HWC -> NCHW copy.
+void hwc_to_nchw(const float* hwc, std::uint32_t h, std::uint32_t w, float* nchw) {
+  const std::size_t hw = static_cast<std::size_t>(h) * w;
+  for (std::uint32_t y = 0; y < h; ++y) {
+    for (std::uint32_t x = 0; x < w; ++x) {
+      const std::size_t src_idx = (static_cast<std::size_t>(y) * w + x) * 3;
+      nchw[0 * hw + y * w + x] = hwc[src_idx + 0];
+      nchw[1 * hw + y * w + x] = hwc[src_idx + 1];
+      nchw[2 * hw + y * w + x] = hwc[src_idx + 2];
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::uint32_t src_w = argc > 2 ? static_cast<std::uint32_t>(std::atoi(argv[1])) : 1920;
+  const std::uint32_t src_h = argc > 2 ? static_cast<std::uint32_t>(std::atoi(argv[2])) : 1080;
+  const std::size_t iterations = argc > 3 ? static_cast<std::size_t>(std::atoi(argv[3])) : 200;
+  const float scale = 1.f / 255.f;
+
+  std::printf("source %ux%u BGR8 -> %ux%u float NCHW, %zu iterations\n", src_w, src_h,
+              kModelSize, kModelSize, iterations);
+  const nc::Frame source = make_source(src_w, src_h);
+
+  nv::ResizeStage resize(kModelSize, kModelSize);
+  nv::NormalizeStage normalize(0.f, scale);
+  nc::Frame resized;
+  nc::Frame normalized;
+  std::vector<float> nchw(3u * kModelSize * kModelSize);
+  const auto chain = normitri::bench::run_bench("chain (resize+normalize+transpose)", iterations,
+                                                [&] {
+    (void)resize.process_into(source, resized);
+    (void)normalize.process_into(resized, normalized);
+    hwc_to_nchw(reinterpret_cast<const float*>(normalized.data().data()), kModelSize,
+                kModelSize, nchw.data());
+    normitri::bench::do_not_optimize(nchw.data());
+  });
+
+  nv::PreprocessStage fused_stage(
+      {.width = kModelSize, .height = kModelSize, .mean = 0.f, .scale = scale});
+  nc::Frame tensor;
+  const auto fused = normitri::bench::run_bench("fused (PreprocessStage)", iterations, [&] {
+    (void)fused_stage.process_into(source, tensor);
+    normitri::bench::do_not_optimize(tensor.data().data());
+  });
+
+  std::printf("speedup: %.2fx\n", chain.median_ms / fused.median_ms);
+  return 0;
+}
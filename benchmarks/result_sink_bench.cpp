@@ -0,0 +1,105 @@
+// Result sink benchmark: how results leave the parallel batch runner at 16+ threads.
+//
+// The pipeline is one trivial stage, so the cost measured is the delivery itself: "mutex
+// callback" is the usual user callback (lock, record, unlock) invoked per result from every
+// worker; "atomic callback" is the cheapest thread-safe callback; "result queue" pushes per-thread
+// batches through app::ResultQueue to one consumer thread that drains them as spans.
+//
+// Run: ./build/benchmarks/normitri_result_sink_bench [workers [frames_per_call [iterations]]]
+
+#include "bench_util.hpp"
+
+#include <normitri/app/pipeline_runner.hpp>
+#include <normitri/app/result_queue.hpp>
+#include <normitri/core/defect_result.hpp>
+#include <normitri/core/executor.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_stage.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace na = normitri::app;
+namespace nc = normitri::core;
+
+namespace {
+
+/// Emits an empty DefectResult per frame; stands in for a pipeline whose results are cheap.
+class EmitStage : public nc::IPipelineStage {
+ public:
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    nc::DefectResult r;
+    r.frame_id = input.width();
+    return nc::StageOutput{std::move(r)};
+  }
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t workers = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 16;
+  const std::size_t frames_per_call =
+      argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 4096;
+  const std::size_t iterations = argc > 3 ? static_cast<std::size_t>(std::atoi(argv[3])) : 200;
+
+  nc::Pipeline pipeline;
+  pipeline.add_stage(std::make_unique<EmitStage>());
+  const std::vector<nc::Frame> frames(
+      frames_per_call, nc::Frame(4, 4, nc::PixelFormat::Grayscale8, std::vector<std::byte>(16)));
+  nc::Executor executor({.num_workers = std::max<std::size_t>(workers, 2) - 1, .cpu_affinity = {}});
+
+  std::printf("%zu frames per call, %zu iterations, %zu threads (%u hardware)\n", frames_per_call,
+              iterations, workers, std::thread::hardware_concurrency());
+
+  std::mutex mutex;
+  std::uint64_t locked_sum = 0;
+  normitri::bench::run_bench("mutex callback", iterations, [&] {
+    na::run_pipeline_batch_parallel(
+        pipeline, frames,
+        [&](const nc::DefectResult& r) {
+          std::lock_guard lock(mutex);
+          locked_sum += r.frame_id;
+        },
+        executor);
+  });
+
+  std::atomic<std::uint64_t> atomic_sum{0};
+  normitri::bench::run_bench("atomic callback", iterations, [&] {
+    na::run_pipeline_batch_parallel(
+        pipeline, frames,
+        [&](const nc::DefectResult& r) {
+          atomic_sum.fetch_add(r.frame_id, std::memory_order_relaxed);
+        },
+        executor);
+  });
+
+  // One queue and consumer for the whole run, as a service would keep them.
+  na::ResultQueue queue(256);
+  std::uint64_t queued_sum = 0;
+  std::jthread consumer([&] {
+    while (queue.wait()) {
+      queue.drain([&](std::span<const nc::DefectResult> batch) {
+        for (const nc::DefectResult& r : batch) queued_sum += r.frame_id;
+      });
+    }
+  });
+  normitri::bench::run_bench("result queue (consumer thread)", iterations, [&] {
+    na::run_pipeline_batch_parallel(pipeline, frames, queue, 0, nullptr, nullptr, &executor);
+  });
+  queue.close();
+  consumer.join();
+
+  std::printf("sums: %llu %llu %llu\n", static_cast<unsigned long long>(locked_sum),
+              static_cast<unsigned long long>(atomic_sum.load()),
+              static_cast<unsigned long long>(queued_sum));
+  return 0;
+}
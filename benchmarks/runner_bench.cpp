@@ -0,0 +1,125 @@
+// Batch runner benchmark: run_pipeline_batch_parallel on small batches in a tight loop.
+//
+// Each call runs 8 frames (by default) through PreprocessStage -> DefectDetectionStage with the
+// mock backend, so per-frame work is small and per-call overhead shows. "spawn per call" starts
+// and joins fresh threads on every call (how the runner used to work); "shared executor" and
+// "pinned executor" reuse core::Executor workers. "in frame order" adds DeliveryOrder::Input on
+// the shared executor, once with uniform frames and once with every 16th frame slow, to show what
+// releasing results through the reorder ring costs against completion-order delivery.
+//
+// Run: ./build/benchmarks/normitri_runner_bench [frames_per_call [iterations]]
+
+#include "bench_util.hpp"
+
+#include <normitri/app/pipeline_runner.hpp>
+#include <normitri/core/executor.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/vision/defect_decoder.hpp>
+#include <normitri/vision/defect_detection_stage.hpp>
+#include <normitri/vision/mock_inference_backend.hpp>
+#include <normitri/vision/preprocess_stage.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace na = normitri::app;
+namespace nc = normitri::core;
+namespace nv = normitri::vision;
+
+namespace {
+
+nc::Frame make_source(std::uint32_t w, std::uint32_t h) {
+  std::vector<std::byte> pixels(static_cast<std::size_t>(w) * h * 3);
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<std::byte>((i * 131u) >> 3);
+  }
+  return nc::Frame(w, h, nc::PixelFormat::BGR8, std::move(pixels));
+}
+
+nc::Pipeline make_pipeline() {
+  nc::Pipeline pipeline;
+  pipeline.add_stage(std::make_unique<nv::PreprocessStage>(
+      nv::PreprocessOptions{.width = 160, .height = 160}));
+  pipeline.add_stage(std::make_unique<nv::DefectDetectionStage>(
+      std::make_unique<nv::MockInferenceBackend>(),
+      nv::DefectDecoder(0.5f, {nc::DefectKind::WrongItem})));
+  return pipeline;
+}
+
+/// The previous runner: num_workers threads started and joined per call, pulling frame indices.
+void run_spawning(nc::Pipeline& pipeline, const std::vector<nc::Frame>& frames,
+                  const na::DefectResultCallback& callback, std::size_t num_workers) {
+  std::atomic<std::size_t> next{0};
+  std::vector<std::jthread> threads;
+  threads.reserve(num_workers);
+  for (std::size_t w = 0; w < num_workers; ++w) {
+    threads.emplace_back([&] {
+      for (std::size_t i = next.fetch_add(1); i < frames.size(); i = next.fetch_add(1)) {
+        if (auto result = pipeline.run(frames[i])) callback(*result);
+      }
+    });
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t frames_per_call =
+      argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 8;
+  const std::size_t iterations = argc > 2 ? static_cast<std::size_t>(std::atoi(argv[2])) : 2000;
+  const std::size_t workers = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+  nc::Pipeline pipeline = make_pipeline();
+  const std::vector<nc::Frame> frames(frames_per_call, make_source(320, 240));
+  std::atomic<std::size_t> results{0};
+  const na::DefectResultCallback callback = [&](const nc::DefectResult&) { ++results; };
+
+  std::printf("%zu frames per call, %zu iterations, %zu threads\n", frames_per_call, iterations,
+              workers);
+  normitri::bench::run_bench("spawn per call", iterations, [&] {
+    run_spawning(pipeline, frames, callback, workers);
+  });
+  normitri::bench::run_bench("shared executor", iterations, [&] {
+    na::run_pipeline_batch_parallel(pipeline, frames, callback, workers);
+  });
+
+  normitri::bench::run_bench("shared executor, in frame order", iterations, [&] {
+    na::run_pipeline_batch_parallel(pipeline, frames, callback, workers, nullptr, nullptr, 1,
+                                    na::DeliveryOrder::Input);
+  });
+
+  // Every 16th frame is 4x larger, so later frames finish first and ordering has to hold them.
+  std::vector<nc::Frame> uneven;
+  for (std::size_t i = 0; i < frames_per_call; ++i) {
+    uneven.push_back(i % 16 == 0 ? make_source(640, 480) : make_source(320, 240));
+  }
+  normitri::bench::run_bench("uneven frames, completion order", iterations, [&] {
+    na::run_pipeline_batch_parallel(pipeline, uneven, callback, workers);
+  });
+  normitri::bench::run_bench("uneven frames, in frame order", iterations, [&] {
+    na::run_pipeline_batch_parallel(pipeline, uneven, callback, workers, nullptr, nullptr, 1,
+                                    na::DeliveryOrder::Input);
+  });
+
+  nc::ExecutorOptions pinned;
+  pinned.num_workers = std::max<std::size_t>(1, workers - 1);
+  for (std::size_t c = 0; c < pinned.num_workers; ++c) {
+    pinned.cpu_affinity.push_back(static_cast<int>((c + 1) % workers));  // leave cpu 0 to main
+  }
+  nc::Executor executor(pinned);
+  normitri::bench::run_bench("pinned executor", iterations, [&] {
+    na::run_pipeline_batch_parallel(pipeline, frames, callback, executor);
+  });
+  const nc::ExecutorStats stats = executor.stats();
+  std::printf("pinned executor: %llu tasks, %llu steals; %zu results\n",
+              static_cast<unsigned long long>(stats.tasks_run),
+              static_cast<unsigned long long>(stats.steals), results.load());
+  return 0;
+}
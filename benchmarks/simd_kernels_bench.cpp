@@ -0,0 +1,80 @@
+// SIMD kernel benchmark: GB/s per kernel and instruction set against the scalar reference.
+//
+// Sizes match one 640x640 model input. Bytes counted are source read + destination written.
+// Levels above what the CPU supports are skipped.
+//
+// Run: ./build/benchmarks/normitri_simd_kernels_bench [iterations]
+
+#include "bench_util.hpp"
+
+#include <normitri/vision/simd_kernels.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+namespace simd = normitri::vision::simd;
+
+namespace {
+
+constexpr std::size_t kPixels = 640 * 640;
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::size_t iterations = argc > 1 ? static_cast<std::size_t>(std::atoi(argv[1])) : 200;
+
+  std::vector<std::uint8_t> u8(kPixels * 3);
+  for (std::size_t i = 0; i < u8.size(); ++i) u8[i] = static_cast<std::uint8_t>(i * 31u);
+  std::vector<float> hwc(kPixels * 3);
+  for (std::size_t i = 0; i < hwc.size(); ++i) hwc[i] = static_cast<float>(i & 0xff);
+  std::vector<float> out(kPixels * 3);
+  float* p0 = out.data();
+  float* p1 = p0 + kPixels;
+  float* p2 = p1 + kPixels;
+
+  const std::size_t deinterleave_bytes = 2 * kPixels * 3 * sizeof(float);
+  const std::size_t convert_bytes = kPixels * 3 * (1 + sizeof(float));
+
+  std::printf("640x640x3, %zu iterations, detected: %s\n", iterations,
+              simd::simd_level_name(simd::detected_simd_level()));
+  std::printf("%-28s %-8s %10s %10s %8s\n", "kernel", "level", "median ms", "GB/s", "vs scalar");
+
+  for (const char* kernel : {"deinterleave3_f32", "u8_to_f32_planar (swap)", "u8_to_f32"}) {
+    double scalar_gbps = 0.0;
+    for (auto level : {simd::SimdLevel::Scalar, simd::SimdLevel::SSE41, simd::SimdLevel::AVX2,
+                       simd::SimdLevel::AVX512}) {
+      if (level > simd::detected_simd_level()) continue;
+      const simd::SimdKernels& k = simd::simd_kernels(level);
+      const std::string_view name(kernel);
+      normitri::bench::BenchResult r;
+      std::size_t bytes = 0;
+      if (name == "deinterleave3_f32") {
+        bytes = deinterleave_bytes;
+        r = normitri::bench::measure(iterations, [&] {
+          k.deinterleave3_f32(hwc.data(), kPixels, p0, p1, p2);
+          normitri::bench::do_not_optimize(p0);
+        });
+      } else if (name == "u8_to_f32") {
+        bytes = convert_bytes;
+        r = normitri::bench::measure(iterations, [&] {
+          k.u8_to_f32(u8.data(), u8.size(), 1.f / 255.f, 0.f, p0);
+          normitri::bench::do_not_optimize(p0);
+        });
+      } else {
+        bytes = convert_bytes;
+        r = normitri::bench::measure(iterations, [&] {
+          k.u8_to_f32_planar(u8.data(), kPixels, 3, {2, 1, 0}, 1.f / 255.f, 0.f, p0, p1, p2);
+          normitri::bench::do_not_optimize(p0);
+        });
+      }
+      const double gbps = normitri::bench::gigabytes_per_second(r, bytes);
+      if (level == simd::SimdLevel::Scalar) scalar_gbps = gbps;
+      std::printf("%-28s %-8s %10.3f %10.2f %7.2fx\n", kernel, simd::simd_level_name(level),
+                  r.median_ms, gbps, scalar_gbps > 0.0 ? gbps / scalar_gbps : 0.0);
+    }
+  }
+  return 0;
+}
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <normitri/core/defect.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/vision/defect_decoder.hpp>
+#include <normitri/vision/onnx_inference_backend.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -14,6 +19,13 @@ enum class InferenceBackendType {
   TensorRT,
 };
 
+/// Preprocessing path: separate OpenCV stages (Resize -> Normalize, HWC; the backend transposes)
+/// or the fused PreprocessStage (one pass straight to the CHW tensor).
+enum class PreprocessMode {
+  Chain,
+  Fused,
+};
+
 /// Pipeline configuration: model path, stages, thresholds.
 struct PipelineConfig {
   std::string model_path;
@@ -22,13 +34,30 @@ struct PipelineConfig {
   std::uint32_t resize_height{640};
   float normalize_mean{0.f};
   float normalize_scale{1.f};
+  /// Layout NormalizeStage writes in the chain path; CHW avoids the backend transpose (NCHW models).
+  normitri::core::TensorLayout normalize_layout{normitri::core::TensorLayout::HWC};
+  PreprocessMode preprocess{PreprocessMode::Chain};
+  /// Channel order the model expects (RGB8 or BGR8) for the fused path; Unknown keeps the source.
+  normitri::core::PixelFormat model_channel_order{normitri::core::PixelFormat::Unknown};
   float confidence_threshold{0.5f};
+  /// Non-maximum suppression and top-k after the threshold (nms_* keys); off by default.
+  normitri::vision::NmsOptions nms;
+  /// Byte cap for the per-pipeline frame buffer pool (MiB); 0 disables pooling. Caps the cached
+  /// blocks only; without a pool each pipeline thread keeps two heap scratch frames of its
+  /// largest process_into() output (see Pipeline::run).
+  std::size_t buffer_pool_mb{256};
+  /// ONNX Runtime session tuning (onnx_* keys).
+  normitri::vision::OnnxSessionOptions onnx_session;
   std::vector<std::string> high_value_categories;  // for alerting prioritisation
 };
 
 /// Load config from a simple key=value file (one per line) or use defaults.
 PipelineConfig load_config(const std::string& path);
 
+/// Applies one config-file key (e.g. from a CLI flag); returns false if the key is unknown or the
+/// value is not one of the accepted values. Unknown keys leave cfg unchanged.
+bool apply_config_value(PipelineConfig& cfg, const std::string& key, const std::string& value);
+
 /// Default config when no file is provided.
 PipelineConfig default_config();
 
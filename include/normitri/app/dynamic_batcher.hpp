@@ -0,0 +1,99 @@
+#pragma once
+
+#include <normitri/app/pipeline_runner.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace normitri::app {
+
+/// When a DynamicBatcher closes a batch.
+struct DynamicBatcherOptions {
+  /// Frames per inference call; a batch is closed as soon as this many wait. At least 1.
+  std::size_t max_batch_size{8};
+  /// Longest a prepared frame waits for its batch to fill; then whatever is waiting is batched.
+  /// Bounds the latency batching adds (plus the time the previous batch takes to run).
+  std::chrono::microseconds max_wait{2000};
+};
+
+/// Counters for a DynamicBatcher (monotonic since construction, except queued).
+struct DynamicBatcherStats {
+  std::size_t queued{0};            // prepared frames waiting for a batch now
+  std::uint64_t submitted{0};       // frames accepted by submit()
+  std::uint64_t rejected{0};        // frames of unknown units, or submitted after close()
+  std::uint64_t batches{0};         // batch-stage calls
+  std::uint64_t batched_frames{0};  // frames in those calls; / batches = mean batch size
+  std::uint64_t full_batches{0};    // batches closed at max_batch_size
+  std::uint64_t deadline_batches{0};  // batches closed by max_wait, flush() or close()
+  std::uint64_t failed{0};  // frames whose preprocessing or batch returned an error
+  /// Time from a frame being prepared to its batch starting, summed over batched frames.
+  std::uint64_t total_wait_ns{0};
+  std::uint64_t max_wait_ns{0};
+};
+
+/// Batches frames from many cameras (units) into one inference call, the way an inference server
+/// does: more frames per infer_batch() means more throughput per core or GPU, and the deadline
+/// keeps the latency that costs bounded.
+///
+/// The units share one pipeline whose batch stage (Pipeline::batch_stage(), e.g. a
+/// DefectDetectionStage) runs the model. submit() runs the stages before it (preprocessing) on
+/// the calling thread, so cameras preprocess in parallel on their own threads, and queues the
+/// prepared frame. A scheduler thread closes a batch when max_batch_size frames wait or the
+/// oldest has waited max_wait, runs it through Pipeline::run_from_batch_stage() (one
+/// process_batch(), so one infer_batch() across cameras) and scatters the results to each unit's
+/// callback, with camera_id set to the unit id, as run_pipeline_multi_camera_tbb() does. Frames
+/// that fail are counted in stats() and get no callback.
+///
+/// Callbacks run on the scheduler thread, one at a time, so they need no lock of their own; they
+/// delay the next batch, so keep them short, and they must not throw. The batch stage and those
+/// after it only run on the scheduler thread; the stages before it must be safe to run
+/// concurrently, as for Pipeline::run().
+///
+/// Thread-safety: submit(), flush(), close() and stats() may be called concurrently (not from a
+/// callback, except stats()). The batcher must not be destroyed while another thread is inside
+/// submit().
+class DynamicBatcher {
+ public:
+  /// \p pipeline must outlive the batcher. \p callbacks maps each unit_id to the callback for
+  /// its results; frames of other units are rejected.
+  DynamicBatcher(normitri::core::Pipeline& pipeline,
+                 std::unordered_map<std::string, DefectResultCallback> callbacks,
+                 DynamicBatcherOptions options = {});
+  /// close(), then batches and delivers every queued frame and joins the scheduler.
+  ~DynamicBatcher();
+
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+  /// Preprocesses \p frame and queues it for the next batch. Returns false if it will get no
+  /// callback: unknown unit, closed, or preprocessing failed.
+  bool submit(const std::string& unit_id, const normitri::core::Frame& frame);
+
+  /// Submits a batch of (unit_id, frame) work items, the run_pipeline_multi_camera_tbb() input,
+  /// preprocessing them on up to num_workers threads of the shared Executor (0 = all). Returns
+  /// the number accepted. Results arrive through the callbacks, not before this returns.
+  std::size_t submit(const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+                     std::size_t num_workers = 0);
+
+  /// Batches what is waiting now without waiting for max_wait, and returns once every frame
+  /// submitted before the call has been delivered.
+  void flush();
+
+  /// Stops accepting frames; frames already queued are batched right away.
+  void close();
+
+  [[nodiscard]] DynamicBatcherStats stats() const;
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace normitri::app
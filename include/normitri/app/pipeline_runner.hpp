@@ -1,9 +1,12 @@
 #pragma once
 
+#include <normitri/app/result_queue.hpp>
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/error.hpp>
+#include <normitri/core/executor.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_replicas.hpp>
 #include <cstddef>
 #include <expected>
 #include <functional>
@@ -21,6 +24,20 @@ using DefectResultCallback =
 /// Optional per-stage timing: (stage_index, duration_ms). Pass to run_pipeline to get timings.
 using StageTimingCallback = normitri::core::StageTimingCallback;
 
+/// When the parallel runners invoke the callback.
+enum class DeliveryOrder {
+  /// As each frame finishes, from whichever thread ran it (callback must be thread-safe).
+  Completion,
+  /// In frame order, one call at a time, through a core::ReorderRing: a finished frame waits
+  /// until every earlier frame has been delivered (or has failed). Threads run at most
+  /// kReorderWindow frames (or two groups of batch_size, if larger) ahead of the oldest
+  /// undelivered one, which bounds the results held back by a slow frame.
+  Input,
+};
+
+/// Frames a slow frame may hold back in DeliveryOrder::Input.
+inline constexpr std::size_t kReorderWindow = 64;
+
 /// Runs pipeline on a single frame. No threading; direct call.
 /// If timing_cb is non-null, it is invoked for each stage with (stage_index, duration_ms).
 /// If camera_id / customer_id are provided, they are set on the returned DefectResult for traceability.
@@ -34,22 +51,88 @@ run_pipeline(normitri::core::Pipeline& pipeline,
 
 /// Runs pipeline on multiple frames sequentially; calls callback for each result.
 /// If camera_ids / customer_ids are provided (same size as frames), each result is tagged with the corresponding id before callback; empty string = leave unset.
+/// batch_size > 1 runs groups of that many frames through Pipeline::run_batch (one batched
+/// inference call per group); results are still delivered in frame order.
 void run_pipeline_batch(normitri::core::Pipeline& pipeline,
                         const std::vector<normitri::core::Frame>& frames,
                         DefectResultCallback callback,
                         const std::vector<std::string>* camera_ids = nullptr,
-                        const std::vector<std::string>* customer_ids = nullptr);
+                        const std::vector<std::string>* customer_ids = nullptr,
+                        std::size_t batch_size = 1);
 
-/// Runs pipeline on multiple frames in parallel using a thread pool.
-/// Pipeline::run() is called from worker threads; callback may be invoked
-/// from any worker (must be thread-safe). num_workers 0 = use hardware concurrency.
+/// Runs pipeline on multiple frames in parallel on the shared core::Executor.
+/// Pipeline::run() is called from the calling thread and executor workers; callback may be
+/// invoked from any of them (must be thread-safe). num_workers caps the threads used
+/// (0 = all: hardware concurrency). No threads are created per call. All threads share the
+/// pipeline's stages; for stateful stages or non-thread-safe backends use the PipelineReplicas
+/// overload.
 /// If camera_ids / customer_ids are provided (same size as frames), each result is tagged with the corresponding id before callback; empty string = leave unset.
+/// batch_size > 1 instead runs groups of that many frames through Pipeline::run_batch: each
+/// group is preprocessed on num_workers threads, then inferred in one batched call; the callback
+/// is invoked on the calling thread, in frame order.
+/// order = DeliveryOrder::Input delivers results in frame order, one callback at a time.
 void run_pipeline_batch_parallel(
     normitri::core::Pipeline& pipeline,
     const std::vector<normitri::core::Frame>& frames,
     DefectResultCallback callback,
     std::size_t num_workers = 0,
     const std::vector<std::string>* camera_ids = nullptr,
-    const std::vector<std::string>* customer_ids = nullptr);
+    const std::vector<std::string>* customer_ids = nullptr,
+    std::size_t batch_size = 1,
+    DeliveryOrder order = DeliveryOrder::Completion);
+
+/// As above, on \p executor (e.g. one with pinned workers) using all of its workers.
+void run_pipeline_batch_parallel(
+    normitri::core::Pipeline& pipeline,
+    const std::vector<normitri::core::Frame>& frames,
+    DefectResultCallback callback,
+    normitri::core::Executor& executor,
+    const std::vector<std::string>* camera_ids = nullptr,
+    const std::vector<std::string>* customer_ids = nullptr,
+    std::size_t batch_size = 1,
+    DeliveryOrder order = DeliveryOrder::Completion);
+
+/// Runs frames in parallel like the overloads above, but every frame (or group of batch_size
+/// frames, run through Pipeline::run_batch) runs on a replica from \p replicas, so threads never
+/// share a stage: stateful stages and non-thread-safe backends (TensorRT) scale across cores.
+/// Uses \p executor (null = the shared Executor), at most num_workers threads (0 = all).
+/// With DeliveryOrder::Completion the callback is invoked from any of the threads, in no
+/// particular order, also when batch_size > 1 (groups run concurrently on different replicas);
+/// DeliveryOrder::Input delivers in frame order, one callback at a time.
+void run_pipeline_batch_parallel(
+    normitri::core::PipelineReplicas& replicas,
+    const std::vector<normitri::core::Frame>& frames,
+    DefectResultCallback callback,
+    std::size_t num_workers = 0,
+    const std::vector<std::string>* camera_ids = nullptr,
+    const std::vector<std::string>* customer_ids = nullptr,
+    std::size_t batch_size = 1,
+    normitri::core::Executor* executor = nullptr,
+    DeliveryOrder order = DeliveryOrder::Completion);
+
+/// Runs frames in parallel like the callback overloads, but hands results to \p sink instead of
+/// calling a function per result: each thread buffers its results in a ResultQueue::Writer and
+/// pushes them flush_size() at a time, so threads share nothing but the lock-free queue. A
+/// consumer thread drains \p sink while this runs or afterwards. Results of failed frames are
+/// skipped; results carry the camera / customer ids like the other overloads. Uses \p executor
+/// (null = the shared Executor), at most num_workers threads (0 = all).
+void run_pipeline_batch_parallel(
+    normitri::core::Pipeline& pipeline,
+    const std::vector<normitri::core::Frame>& frames,
+    ResultQueue& sink,
+    std::size_t num_workers = 0,
+    const std::vector<std::string>* camera_ids = nullptr,
+    const std::vector<std::string>* customer_ids = nullptr,
+    normitri::core::Executor* executor = nullptr);
+
+/// As above, each thread running its own replica from \p replicas.
+void run_pipeline_batch_parallel(
+    normitri::core::PipelineReplicas& replicas,
+    const std::vector<normitri::core::Frame>& frames,
+    ResultQueue& sink,
+    std::size_t num_workers = 0,
+    const std::vector<std::string>* camera_ids = nullptr,
+    const std::vector<std::string>* customer_ids = nullptr,
+    normitri::core::Executor* executor = nullptr);
 
 }  // namespace normitri::app
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <normitri/app/pipeline_runner.hpp>
+#include <normitri/app/result_queue.hpp>
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_replicas.hpp>
+#include <cstddef>
 #include <functional>
 #include <string>
 #include <unordered_map>
@@ -25,9 +29,14 @@ using DefectResultCallbackWithUnitId =
 /// \p pipelines must contain an entry for every unit_id that appears in \p work_items.
 ///
 /// **One pipeline per unit:** Use one Pipeline (and one inference backend) per camera or per customer.
-/// Each pipeline is invoked from TBB tasks; if the same unit_id appears in multiple work items, the same
-/// pipeline may be used from multiple threads concurrently. For non-thread-safe backends (e.g. ONNX,
-/// TensorRT), submit at most one work item per unit_id per call, or use a thread-safe backend.
+/// Any number of work items per unit is fine: a pipeline runs one frame at a time, in work-item
+/// order, so non-thread-safe backends (e.g. TensorRT) and stateful stages need nothing extra, and
+/// a unit's callbacks come one at a time, in that order. Units take turns one frame each, so a
+/// busy unit cannot starve the others; different units run in parallel. To run one unit's frames
+/// in parallel too, use the PipelineReplicas overload below, or overlap its stages with
+/// run_pipeline_multi_camera_pipelined_tbb().
+/// With many units, let their pipelines share K sessions through PooledInferenceBackend handles on
+/// one InferenceSessionPool instead of holding one backend each.
 ///
 /// \param pipelines Map from unit_id (e.g. camera_id or customer_id) to pipeline. Caller keeps ownership.
 /// \param work_items Flat list of (unit_id, frame) pairs. Frames are read only; not modified.
@@ -37,6 +46,63 @@ void run_pipeline_multi_camera_tbb(
     const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
     DefectResultCallbackWithUnitId callback);
 
+/// Same as above, but each unit is a PipelineReplicas: every TBB thread runs its own replica of a
+/// unit's pipeline (kept per thread in a tbb::enumerable_thread_specific for the whole call), so
+/// work items of one unit may run concurrently with any backend, TensorRT included. Replicas
+/// persist in \p replicas between calls. Units missing from the map are skipped.
+void run_pipeline_multi_camera_tbb(
+    const std::unordered_map<std::string, normitri::core::PipelineReplicas*>& replicas,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    DefectResultCallbackWithUnitId callback);
+
+/// The two runners above with results pushed to \p sink instead of a callback per result: each
+/// TBB thread buffers results (camera_id = unit_id) in its own ResultQueue::Writer, kept in a
+/// tbb::enumerable_thread_specific, and the writers are flushed before returning. Drain \p sink
+/// from one consumer thread.
+void run_pipeline_multi_camera_tbb(
+    const std::unordered_map<std::string, normitri::core::Pipeline*>& pipelines,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    ResultQueue& sink);
+
+void run_pipeline_multi_camera_tbb(
+    const std::unordered_map<std::string, normitri::core::PipelineReplicas*>& replicas,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    ResultQueue& sink);
+
+/// Settings for the pipelined TBB runners below.
+struct PipelinedTbbOptions {
+  /// Frames in flight per lane (tbb::parallel_pipeline tokens). Each holds at most one
+  /// intermediate frame, so this bounds a lane's memory. 0 = one per TBB thread, and at least
+  /// one per stage so every stage can be busy.
+  std::size_t max_tokens{0};
+};
+
+/// Runs \p frames through \p pipeline as a tbb::parallel_pipeline: one filter per stage, so
+/// frame i + 1 is preprocessed while frame i is inferred. Stages that are stateless() (resize,
+/// normalize, ...) are parallel filters and work on several frames at once; the others (the
+/// inference stage) are serial_in_order filters and see one frame at a time, in frame order, so a
+/// single non-thread-safe backend (TensorRT) is never entered concurrently. A frame that finishes
+/// early or fails skips the remaining stages.
+///
+/// This is the throughput runner for one camera with a stateful backend:
+/// run_pipeline_batch_parallel() would need a reentrant backend (or a replica per thread), and
+/// run_pipeline_batch() leaves the other cores idle. \p callback is called for each success, in frame order, one at a time.
+void run_pipeline_pipelined_tbb(normitri::core::Pipeline& pipeline,
+                                const std::vector<normitri::core::Frame>& frames,
+                                DefectResultCallback callback, PipelinedTbbOptions options = {});
+
+/// The pipelined runner per unit: each pipeline in \p pipelines is one lane, a parallel_pipeline
+/// over its units' frames (in work-item order), and the lanes run concurrently. Units that share
+/// a pipeline share its lane, so its serial stages still see one frame at a time.
+/// Each unit's serial stages see one frame at a time, so one pipeline per unit needs no thread-safe
+/// backend, while its stateless stages work on several frames at once. Results get
+/// camera_id = unit_id; callback is called in frame order within a unit, concurrently across
+/// units. Units missing from \p pipelines are skipped.
+void run_pipeline_multi_camera_pipelined_tbb(
+    const std::unordered_map<std::string, normitri::core::Pipeline*>& pipelines,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    DefectResultCallbackWithUnitId callback, PipelinedTbbOptions options = {});
+
 }  // namespace normitri::app
 
 #endif  // NORMITRI_HAS_TBB
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <normitri/core/defect_result.hpp>
+#include <normitri/core/mpsc_queue.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace normitri::app {
+
+/// Receives one batch of results drained from a ResultQueue.
+using DefectResultBatchCallback =
+    std::function<void(std::span<const normitri::core::DefectResult>)>;
+
+/// Result sink for the parallel runners that needs no lock on the worker side.
+///
+/// Each runner thread collects results in its own Writer and hands them over flush_size() at a
+/// time as one batch, through a lock-free MPSC queue (core::MpscQueue). A single consumer thread
+/// drains the batches as spans, so workers never serialize on a user mutex and the per-result
+/// cost is a vector push_back. Results of one writer stay in order; batches of different
+/// writers interleave.
+///
+/// Typical consumer:
+///   while (queue.wait()) queue.drain([&](std::span<const DefectResult> batch) { ... });
+/// and the producer side calls close() once the last runner call has returned.
+///
+/// Thread-safety: writer(), Writer and close() on any thread; wait() and drain() on one consumer
+/// thread at a time.
+class ResultQueue {
+ public:
+  /// Per-thread buffer; pushes its results to the queue every flush_size() results, on flush()
+  /// and on destruction. Not thread-safe: one per producing thread.
+  class Writer {
+   public:
+    explicit Writer(ResultQueue& queue) : queue_(&queue) {}
+    Writer(Writer&& other) noexcept = default;
+    ~Writer() { flush(); }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(Writer&&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void add(normitri::core::DefectResult result);
+    void flush();
+
+   private:
+    ResultQueue* queue_;
+    std::vector<normitri::core::DefectResult> buffer_;
+  };
+
+  /// \p flush_size results per batch (at least 1).
+  explicit ResultQueue(std::size_t flush_size = 64);
+
+  ResultQueue(const ResultQueue&) = delete;
+  ResultQueue& operator=(const ResultQueue&) = delete;
+
+  [[nodiscard]] Writer writer() { return Writer(*this); }
+
+  /// Queues \p batch as is (any thread); empty batches are ignored.
+  void push(std::vector<normitri::core::DefectResult> batch);
+
+  /// Consumer: calls \p fn for each queued batch, oldest first, and returns the number of
+  /// results passed. May return 0 while a producer is half-way through a push.
+  std::size_t drain(const DefectResultBatchCallback& fn);
+
+  /// Consumer: blocks until a batch is queued or close() is called. Returns false once the
+  /// queue is closed and drained.
+  bool wait();
+
+  /// No more batches will be pushed; wakes the consumer.
+  void close();
+
+  [[nodiscard]] std::size_t flush_size() const noexcept { return flush_size_; }
+
+ private:
+  const std::size_t flush_size_;
+  normitri::core::MpscQueue<std::vector<normitri::core::DefectResult>> batches_;
+  alignas(64) std::atomic<std::uint64_t> pushed_{0};  // batches linked into batches_
+  std::atomic<std::uint64_t> signal_{0};  // bumped by push() and close(); wait() sleeps on it
+  std::atomic<bool> closed_{false};
+  alignas(64) std::uint64_t popped_{0};  // consumer only
+};
+
+}  // namespace normitri::app
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <normitri/core/defect_result.hpp>
+#include <normitri/core/error.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_replicas.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace normitri::app {
+
+/// What StreamingRunner::submit() does when the queue is full.
+enum class OverflowPolicy : std::uint8_t {
+  Block,       // wait for space (backpressure on the producer)
+  DropOldest,  // discard the frame that has waited longest
+  DropNewest,  // discard the frame being submitted
+  /// Each camera keeps at most one queued frame: a new frame replaces the one its camera already
+  /// has waiting (in its place in the queue), whether or not the queue is full. A camera with
+  /// nothing queued that arrives at a full queue drops the oldest frame. Frames without a
+  /// camera id count as one camera.
+  LatestPerCamera,
+};
+
+/// Queue and worker settings for a StreamingRunner.
+struct StreamingRunnerOptions {
+  /// Frames that may wait for a worker; at least 1.
+  std::size_t queue_depth{8};
+  OverflowPolicy overflow{OverflowPolicy::Block};
+  /// Worker threads running the pipeline; at least 1. With a shared Pipeline, more than one
+  /// worker needs thread-safe stages (see run_pipeline_batch_parallel); with PipelineReplicas,
+  /// each worker holds its own replica.
+  std::size_t num_workers{1};
+};
+
+/// Counters for a StreamingRunner (monotonic since construction, except the current values).
+struct StreamingStats {
+  std::size_t queue_depth{0};      // frames waiting now
+  std::size_t max_queue_depth{0};  // most frames ever waiting at once
+  std::size_t in_flight{0};        // frames being processed now
+  std::uint64_t submitted{0};
+  std::uint64_t completed{0};  // frames the pipeline ran, whether or not it succeeded
+  std::uint64_t failed{0};     // completed frames whose pipeline run returned an error
+  std::uint64_t dropped{0};    // frames discarded by the overflow policy or after close()
+  std::uint64_t blocked{0};    // submits that waited for space (OverflowPolicy::Block)
+  /// Time from submit() to a worker taking the frame, summed over completed frames.
+  std::uint64_t total_queue_wait_ns{0};
+  std::uint64_t max_queue_wait_ns{0};
+};
+
+/// Outcome of one streamed frame: the DefectResult, the pipeline's error, or
+/// PipelineError::Dropped if the frame was never processed.
+using StreamingResult = std::expected<normitri::core::DefectResult, normitri::core::PipelineError>;
+
+/// Receives the outcome of a frame passed to StreamingRunner::submit() with a callback. Must not
+/// throw.
+using StreamingCallback = std::function<void(const StreamingResult&)>;
+
+/// Runs a pipeline on frames as they arrive (e.g. live cameras), through a bounded queue.
+///
+/// submit() queues one frame and returns at once (or, with OverflowPolicy::Block, once there is
+/// room); workers take frames in order and run the pipeline. When frames arrive faster than they
+/// are processed, the queue bounds the added latency and the overflow policy decides which frames
+/// are lost; stats() shows the queue depth, drops and time spent queued, so overload is visible
+/// rather than silent.
+///
+/// Results carry the camera_id / customer_id given to submit() (empty = unset), like the batch
+/// runners. Callbacks run on a worker thread, or for dropped frames on the submitting thread, and
+/// must be thread-safe.
+///
+/// Thread-safety: submit(), stats(), wait_idle() and close() may be called concurrently. The
+/// runner must not be destroyed while another thread is inside submit().
+class StreamingRunner {
+ public:
+  /// Workers share \p pipeline, which must outlive the runner.
+  explicit StreamingRunner(normitri::core::Pipeline& pipeline, StreamingRunnerOptions options = {});
+  /// Each worker leases one replica from \p replicas for its lifetime; \p replicas must outlive
+  /// the runner.
+  explicit StreamingRunner(normitri::core::PipelineReplicas& replicas,
+                           StreamingRunnerOptions options = {});
+  /// close(), then finishes the frames already queued and joins the workers.
+  ~StreamingRunner();
+
+  StreamingRunner(const StreamingRunner&) = delete;
+  StreamingRunner& operator=(const StreamingRunner&) = delete;
+
+  /// Queues \p frame; the future yields its result (PipelineError::Dropped if it is discarded).
+  [[nodiscard]] std::future<StreamingResult> submit(normitri::core::Frame frame,
+                                                    std::string camera_id = {},
+                                                    std::string customer_id = {});
+
+  /// Queues \p frame; \p callback receives its result (PipelineError::Dropped if it is
+  /// discarded). Returns false if the frame was dropped before being queued.
+  bool submit(normitri::core::Frame frame, StreamingCallback callback,
+              std::string camera_id = {}, std::string customer_id = {});
+
+  /// Stops accepting frames: later submits are dropped, and submits blocked on a full queue
+  /// return with their frame dropped. Queued frames are still processed.
+  void close();
+
+  /// Blocks until the queue is empty and no frame is being processed.
+  void wait_idle();
+
+  [[nodiscard]] StreamingStats stats() const;
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace normitri::app
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace normitri::core {
+
+/// Counters for a BufferPool (monotonic since construction, except cached_bytes).
+struct BufferPoolStats {
+  std::uint64_t hits{0};      // acquire() served from a cached block
+  std::uint64_t misses{0};    // acquire() had to allocate a new block
+  std::uint64_t returns{0};   // released blocks kept for reuse
+  std::uint64_t discards{0};  // released blocks freed (cache full or pool trimmed)
+  std::size_t cached_bytes{0};
+};
+
+/// Size-bucketed pool of large, 64-byte aligned byte buffers for Frame storage.
+///
+/// acquire() rounds the request up to a size class (powers of two split into four steps, so at
+/// most 25% slack) and returns a block from that class's free list, or allocates one. The block
+/// comes back to the pool automatically when the last std::shared_ptr to it is released (e.g. when
+/// the owning Frame is destroyed), so after warmup a steady-state pipeline allocates no large
+/// blocks. Blocks may outlive the pool object; they are then freed on release.
+///
+/// Thread-safety: all member functions may be called concurrently. Use one pool per pipeline, or
+/// one per thread to avoid sharing the (briefly held) free-list lock.
+class BufferPool {
+ public:
+  /// \param max_cached_bytes Upper bound on bytes kept in free lists; extra releases are freed.
+  explicit BufferPool(std::size_t max_cached_bytes = std::size_t{256} << 20);
+  ~BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  /// Returns a writable block of at least \p size bytes (uninitialized). Size 0 returns nullptr.
+  [[nodiscard]] std::shared_ptr<std::byte> acquire(std::size_t size);
+
+  [[nodiscard]] BufferPoolStats stats() const;
+
+  /// Frees all cached blocks. Blocks currently in use are unaffected.
+  void trim();
+
+  /// Size class that acquire(\p size) allocates (for tests and capacity planning).
+  [[nodiscard]] static std::size_t bucket_size(std::size_t size) noexcept;
+
+ private:
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace normitri::core
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <normitri/core/defect.hpp>
+#include <normitri/core/defect_result.hpp>
+#include <normitri/core/inline_vector.hpp>
+#include <normitri/core/interned_string.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace normitri::core {
+
+/// Defect without heap members: the category is an InternedString and the product id a plain
+/// integer with a flag. 40 bytes and trivially copyable, so defects pack densely and copy with
+/// memcpy. Convert from/to Defect at API boundaries.
+struct CompactDefect {
+  BBox bbox{};
+  float confidence{0.f};
+  InternedString category;  // empty = no category
+  std::uint64_t product_id{0};
+  DefectKind kind{DefectKind::ProcessError};
+  bool has_product_id{false};
+
+  [[nodiscard]] static CompactDefect from(const Defect& defect);
+  [[nodiscard]] Defect to_defect() const;
+};
+
+/// DefectResult with few per-result allocations: up to kInlineDefects defects are stored inline,
+/// and the ids are InternedStrings (empty = not set, as the pipeline runners already treat empty
+/// ids). metadata is per-frame data, so it stays a plain string: interning it would grow the
+/// process-wide intern table without bound.
+struct CompactDefectResult {
+  static constexpr std::size_t kInlineDefects = 4;
+
+  std::uint64_t frame_id{0};
+  InlineVector<CompactDefect, kInlineDefects> defects;
+  InternedString camera_id;
+  InternedString customer_id;
+  std::string metadata;
+
+  [[nodiscard]] static CompactDefectResult from(const DefectResult& result);
+  [[nodiscard]] DefectResult to_result() const;
+};
+
+/// Structure-of-arrays store of many results' defects for bulk consumers (aggregation, export,
+/// statistics): each field is one contiguous array over all defects, so a scan over e.g.
+/// confidence or kind reads only that column. Per-frame fields are kept once per result;
+/// defect i belongs to frame frame_index()[i], and frame f owns defects
+/// [frame_offsets()[f], frame_offsets()[f + 1]).
+class DefectBatch {
+ public:
+  /// Appends one result (frame fields plus its defects).
+  void append(const CompactDefectResult& result);
+  void append(const DefectResult& result);
+
+  /// Reserves room for \p frames results with \p defects defects in total.
+  void reserve(std::size_t frames, std::size_t defects);
+  /// Empties the batch but keeps its capacity.
+  void clear() noexcept;
+
+  [[nodiscard]] std::size_t size() const noexcept { return kinds_.size(); }
+  [[nodiscard]] bool empty() const noexcept { return kinds_.empty(); }
+  [[nodiscard]] std::size_t frames() const noexcept { return frame_ids_.size(); }
+
+  // Per defect.
+  [[nodiscard]] std::span<const DefectKind> kinds() const noexcept { return kinds_; }
+  [[nodiscard]] std::span<const float> x() const noexcept { return x_; }
+  [[nodiscard]] std::span<const float> y() const noexcept { return y_; }
+  [[nodiscard]] std::span<const float> w() const noexcept { return w_; }
+  [[nodiscard]] std::span<const float> h() const noexcept { return h_; }
+  [[nodiscard]] std::span<const float> confidences() const noexcept { return confidences_; }
+  /// 0 where has_product_id() is 0.
+  [[nodiscard]] std::span<const std::uint64_t> product_ids() const noexcept {
+    return product_ids_;
+  }
+  [[nodiscard]] std::span<const std::uint8_t> has_product_id() const noexcept {
+    return has_product_id_;
+  }
+  [[nodiscard]] std::span<const InternedString> categories() const noexcept {
+    return categories_;
+  }
+  [[nodiscard]] std::span<const std::uint32_t> frame_index() const noexcept {
+    return frame_index_;
+  }
+
+  // Per frame.
+  [[nodiscard]] std::span<const std::uint64_t> frame_ids() const noexcept { return frame_ids_; }
+  [[nodiscard]] std::span<const InternedString> camera_ids() const noexcept {
+    return camera_ids_;
+  }
+  [[nodiscard]] std::span<const InternedString> customer_ids() const noexcept {
+    return customer_ids_;
+  }
+  /// Metadata of frame \p f, a view into the batch valid until it is next modified.
+  [[nodiscard]] std::string_view metadata(std::size_t f) const noexcept {
+    return std::string_view(metadata_chars_)
+        .substr(metadata_offsets_[f], metadata_offsets_[f + 1] - metadata_offsets_[f]);
+  }
+  /// frames() + 1 entries; starts at 0.
+  [[nodiscard]] std::span<const std::uint32_t> frame_offsets() const noexcept {
+    return frame_offsets_;
+  }
+
+  /// Defect \p i gathered back into one struct.
+  [[nodiscard]] CompactDefect defect(std::size_t i) const;
+  /// Result of frame \p f gathered back into one struct.
+  [[nodiscard]] CompactDefectResult result(std::size_t f) const;
+
+ private:
+  void append_defect(const CompactDefect& d, std::uint32_t frame);
+  void begin_frame(std::uint64_t frame_id, InternedString camera_id, InternedString customer_id,
+                   std::string_view metadata);
+
+  std::vector<DefectKind> kinds_;
+  std::vector<float> x_, y_, w_, h_;
+  std::vector<float> confidences_;
+  std::vector<std::uint64_t> product_ids_;
+  std::vector<std::uint8_t> has_product_id_;
+  std::vector<InternedString> categories_;
+  std::vector<std::uint32_t> frame_index_;
+
+  std::vector<std::uint64_t> frame_ids_;
+  std::vector<InternedString> camera_ids_;
+  std::vector<InternedString> customer_ids_;
+  std::string metadata_chars_;  // all frames' metadata back to back
+  std::vector<std::size_t> metadata_offsets_{0};  // frames() + 1 entries into metadata_chars_
+  std::vector<std::uint32_t> frame_offsets_{0};
+};
+
+}  // namespace normitri::core
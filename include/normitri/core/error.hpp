@@ -10,6 +10,7 @@ enum class PipelineError {
   InferenceFailed,
   InvalidConfig,
   DecoderError,
+  Dropped,  // not processed: discarded by a streaming runner's overflow policy or after close
 };
 
 }  // namespace normitri::core
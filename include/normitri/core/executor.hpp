@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace normitri::core {
+
+/// Sizing and placement of an Executor's worker threads.
+struct ExecutorOptions {
+  /// Worker threads; 0 = hardware concurrency - 1 (the thread calling parallel_for() takes part).
+  std::size_t num_workers{0};
+  /// CPU ids to pin workers to: worker i runs on cpu_affinity[i % size]. Empty = no pinning.
+  /// Linux only; ignored elsewhere and for ids the process may not use.
+  std::vector<int> cpu_affinity;
+};
+
+/// Counters for an Executor (monotonic since construction).
+struct ExecutorStats {
+  std::uint64_t tasks_run{0};  // tasks executed by workers
+  std::uint64_t steals{0};     // tasks a worker took from another worker's queue
+};
+
+/// Long-lived work-stealing thread pool shared by the batch runners.
+///
+/// Each worker owns a deque: it pushes and pops its own tasks at the back (LIFO, cache-warm)
+/// and, when empty, steals from the front of the others' (oldest first). Tasks submitted from
+/// outside the pool are spread round-robin over the deques; tasks submitted by a worker go to
+/// its own deque. Idle workers sleep until work arrives. Threads are created once, so repeated
+/// small batches pay no thread start-up, and per-thread state (e.g. Pipeline's scratch frames)
+/// survives from one batch to the next.
+///
+/// Thread-safety: all member functions may be called concurrently, including from tasks.
+class Executor {
+ public:
+  explicit Executor(ExecutorOptions options = {});
+  /// Runs the tasks already queued, then joins the workers.
+  ~Executor();
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  /// Queues \p task to run on a worker. Tasks must not throw.
+  void submit(std::function<void()> task);
+
+  /// Calls fn(i) for every i in [0, n) on the calling thread and up to max_parallelism - 1
+  /// workers (0 = all of them), and returns once every call has finished. Indices are claimed
+  /// one at a time, so uneven work balances itself. Safe to call from inside a task: the caller
+  /// never waits for a helper that has not started. If fn throws, the remaining indices are
+  /// skipped and the first exception is rethrown here.
+  void parallel_for(std::size_t n, const std::function<void(std::size_t)>& fn,
+                    std::size_t max_parallelism = 0);
+
+  [[nodiscard]] std::size_t num_workers() const noexcept;
+  [[nodiscard]] ExecutorStats stats() const noexcept;
+
+  /// Process-wide executor with default options, created on first use; what the runners use
+  /// when no executor is passed.
+  [[nodiscard]] static Executor& shared();
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace normitri::core
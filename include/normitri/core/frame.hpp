@@ -1,16 +1,24 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <vector>
 
 namespace normitri::core {
 
-/// Memory: Frame owns a single contiguous buffer (std::vector<std::byte>);
-/// move semantics and RAII throughout. Use data() for std::span views (non-owning).
-/// Thread-safety: distinct Frame instances are independent; sharing one Frame
-/// across threads requires external synchronization.
+class BufferPool;
+
+/// Memory: Frame refers to a single contiguous buffer through a shared, refcounted handle.
+/// The buffer is either owned (built from std::vector<std::byte>), a shared immutable buffer
+/// (any owner kept alive via std::shared_ptr), or a borrowed view (no owner; caller keeps the
+/// memory alive). Copying a Frame shares the buffer (no pixel copy); the mutable data()
+/// accessor copies on write when the buffer is shared, borrowed or immutable, so Frame keeps
+/// value semantics.
+/// Thread-safety: distinct Frame instances are independent (refcounts are atomic); sharing one
+/// Frame across threads requires external synchronization.
 
 /// Pixel layout / format.
 enum class PixelFormat : std::uint8_t {
@@ -20,48 +28,186 @@ enum class PixelFormat : std::uint8_t {
   BGR8,
   RGBA8,
   BGRA8,
-  Float32Planar,  // e.g. CHW float for inference
+  /// 3-channel tensor for inference. Despite the name, memory order is Frame::layout() (HWC or
+  /// CHW) and the scalar type is Frame::element_type() (float32 unless set otherwise).
+  Float32Planar,
+};
+
+/// Memory order of multi-channel data: interleaved (HWC, e.g. OpenCV Mats) or one plane per
+/// channel (CHW, the NCHW tensor layout most inference runtimes consume).
+enum class TensorLayout : std::uint8_t {
+  HWC,
+  CHW,
+};
+
+/// Scalar type of each channel value.
+enum class ElementType : std::uint8_t {
+  UInt8,
+  Int8,
+  Float16,
+  Float32,
 };
 
-/// Single image or video frame: dimensions, format, and buffer (owned or view).
+/// Bytes per element of \p type.
+[[nodiscard]] constexpr std::size_t element_size(ElementType type) noexcept {
+  switch (type) {
+    case ElementType::UInt8:
+    case ElementType::Int8:
+      return 1;
+    case ElementType::Float16:
+      return 2;
+    case ElementType::Float32:
+      return 4;
+  }
+  return 0;
+}
+
+/// Channels per pixel of \p format (0 for Unknown).
+[[nodiscard]] constexpr std::uint32_t channel_count(PixelFormat format) noexcept {
+  switch (format) {
+    case PixelFormat::Grayscale8:
+      return 1;
+    case PixelFormat::RGB8:
+    case PixelFormat::BGR8:
+    case PixelFormat::Float32Planar:
+      return 3;
+    case PixelFormat::RGBA8:
+    case PixelFormat::BGRA8:
+      return 4;
+    case PixelFormat::Unknown:
+      return 0;
+  }
+  return 0;
+}
+
+/// Element type a frame of \p format has unless set otherwise: Float32 for Float32Planar,
+/// UInt8 for the 8-bit image formats.
+[[nodiscard]] constexpr ElementType default_element_type(PixelFormat format) noexcept {
+  return format == PixelFormat::Float32Planar ? ElementType::Float32 : ElementType::UInt8;
+}
+
+/// Single image or video frame: dimensions, format, and buffer (owned, shared or view).
 class Frame {
  public:
   Frame() = default;
 
+  /// Takes ownership of \p buffer; the frame is writable in place.
+  Frame(std::uint32_t width,
+        std::uint32_t height,
+        PixelFormat format,
+        std::vector<std::byte> buffer);
+
+  /// Shares an immutable buffer of \p size_bytes bytes. \p buffer may alias any owner
+  /// (e.g. a cv::Mat or another Frame) via the std::shared_ptr aliasing constructor.
   Frame(std::uint32_t width,
         std::uint32_t height,
         PixelFormat format,
-        std::vector<std::byte> buffer)
-      : width_(width),
-        height_(height),
-        format_(format),
-        buffer_(std::move(buffer)) {}
+        std::shared_ptr<const std::byte> buffer,
+        std::size_t size_bytes);
+
+  Frame(const Frame&) = default;
+  Frame& operator=(const Frame&) = default;
+  Frame(Frame&& other) noexcept;
+  Frame& operator=(Frame&& other) noexcept;
+  ~Frame() = default;
+
+  /// Borrowed, non-owning view of \p data. No copy is made; the caller must keep \p data
+  /// alive for as long as this frame (or any copy of it) is used.
+  [[nodiscard]] static Frame view(std::uint32_t width,
+                                  std::uint32_t height,
+                                  PixelFormat format,
+                                  std::span<const std::byte> data);
+
+  /// Writable frame with an uninitialized buffer of \p size_bytes, drawn from \p pool when given
+  /// (the block returns to the pool when the last frame sharing it is destroyed).
+  [[nodiscard]] static Frame allocate(std::uint32_t width,
+                                      std::uint32_t height,
+                                      PixelFormat format,
+                                      std::size_t size_bytes,
+                                      BufferPool* pool = nullptr);
+
+  /// Reshapes this frame (layout HWC) for writing \p size_bytes; contents are unspecified
+  /// afterwards. Keeps the current buffer when this frame exclusively owns a writable buffer with
+  /// enough capacity, otherwise allocates (from \p pool when given). Returns the writable bytes.
+  /// Used by stages that write into a caller-provided output (IPipelineStage::process_into).
+  std::span<std::byte> prepare(std::uint32_t width,
+                               std::uint32_t height,
+                               PixelFormat format,
+                               std::size_t size_bytes,
+                               BufferPool* pool = nullptr);
 
   [[nodiscard]] std::uint32_t width() const noexcept { return width_; }
   [[nodiscard]] std::uint32_t height() const noexcept { return height_; }
   [[nodiscard]] PixelFormat format() const noexcept { return format_; }
+  /// Channel layout of the buffer; HWC unless set otherwise. prepare() resets it to HWC.
+  [[nodiscard]] TensorLayout layout() const noexcept { return layout_; }
+  void set_layout(TensorLayout layout) noexcept { layout_ = layout; }
+  /// Scalar type of the buffer; default_element_type(format()) unless set otherwise (e.g. a
+  /// float16 or int8 tensor). prepare() resets it to the default.
+  [[nodiscard]] ElementType element_type() const noexcept { return element_type_; }
+  void set_element_type(ElementType type) noexcept { element_type_ = type; }
 
-  /// Mutable view of the buffer (owned).
-  [[nodiscard]] std::span<std::byte> data() noexcept {
-    return std::span<std::byte>(buffer_.data(), buffer_.size());
-  }
+  /// Dimensions in memory order: {height, width, channels} for HWC, {channels, height, width}
+  /// for CHW. Backends compare this against the model input shape.
+  [[nodiscard]] std::array<std::uint32_t, 3> shape() const noexcept;
+
+  /// Mutable view of the buffer. Copies the buffer first (copy-on-write) unless this frame
+  /// exclusively owns a writable buffer, so writes never affect other frames or borrowed memory.
+  [[nodiscard]] std::span<std::byte> data();
   [[nodiscard]] std::span<const std::byte> data() const noexcept {
-    return std::span<const std::byte>(buffer_.data(), buffer_.size());
+    return std::span<const std::byte>(buffer_.get(), size_);
+  }
+
+  /// Shared handle to the bytes (empty owner for views); pass to the sharing constructor to
+  /// relabel or forward a buffer without copying.
+  [[nodiscard]] const std::shared_ptr<const std::byte>& buffer() const noexcept { return buffer_; }
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  [[nodiscard]] std::size_t size_bytes() const noexcept { return size_; }
+
+  /// True if the frame borrows memory it does not keep alive (see view()).
+  [[nodiscard]] bool is_view() const noexcept {
+    return size_ != 0 && buffer_.use_count() == 0;
   }
 
-  [[nodiscard]] bool empty() const noexcept { return buffer_.empty(); }
-  [[nodiscard]] std::size_t size_bytes() const noexcept { return buffer_.size(); }
+  /// True if the buffer was drawn from a BufferPool (see allocate()); dropping the last frame
+  /// sharing it returns the block to that pool.
+  [[nodiscard]] bool is_pooled() const noexcept { return size_ != 0 && pooled_; }
 
-  /// Minimum bytes required for given dimensions and format (for validation).
+  /// True if this frame and \p other refer to the same bytes.
+  [[nodiscard]] bool shares_buffer_with(const Frame& other) const noexcept {
+    return size_ != 0 && buffer_.get() == other.buffer_.get();
+  }
+
+  /// Minimum bytes required for given dimensions and format (for validation), with the
+  /// format's default element type.
   [[nodiscard]] static std::size_t min_bytes(std::uint32_t width,
                                              std::uint32_t height,
                                              PixelFormat format);
 
+  /// Minimum bytes for a dense buffer of \p type elements. HWC and CHW need the same number of
+  /// bytes; layout only changes how they are indexed (see shape()).
+  [[nodiscard]] static std::size_t min_bytes(std::uint32_t width,
+                                             std::uint32_t height,
+                                             PixelFormat format,
+                                             ElementType type);
+
+  /// Minimum bytes for this frame's dimensions, format and element type.
+  [[nodiscard]] std::size_t min_bytes() const noexcept;
+
  private:
+  void adopt(std::vector<std::byte> buffer);
+
   std::uint32_t width_{0};
   std::uint32_t height_{0};
   PixelFormat format_{PixelFormat::Unknown};
-  std::vector<std::byte> buffer_;
+  TensorLayout layout_{TensorLayout::HWC};
+  ElementType element_type_{ElementType::UInt8};
+  std::shared_ptr<const std::byte> buffer_;
+  std::size_t size_{0};
+  std::size_t capacity_{0};  // usable bytes behind buffer_ (>= size_), for prepare()
+  bool writable_{false};  // buffer_ points to mutable storage allocated by this class
+  bool pooled_{false};    // buffer_ came from BufferPool::acquire()
 };
 
 }  // namespace normitri::core
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace normitri::core {
+
+/// Vector that stores up to N elements inline and moves to the heap only beyond that, so the
+/// common small case (a few defects per frame) costs no allocation and sits next to its owner.
+///
+/// Restricted to trivially copyable T: elements are relocated with memcpy and never destroyed.
+/// Iterators and pointers are invalidated by any growth past capacity() and by moves.
+template <typename T, std::size_t N>
+class InlineVector {
+  static_assert(std::is_trivially_copyable_v<T>, "InlineVector needs trivially copyable T");
+  static_assert(N > 0 && N <= UINT32_MAX);
+
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  InlineVector() noexcept = default;
+  InlineVector(std::initializer_list<T> init) { assign(init.begin(), init.size()); }
+
+  InlineVector(const InlineVector& other) { assign(other.data(), other.size()); }
+  InlineVector(InlineVector&& other) noexcept { steal(other); }
+
+  InlineVector& operator=(const InlineVector& other) {
+    if (this != &other) {
+      size_ = 0;
+      assign(other.data(), other.size());
+    }
+    return *this;
+  }
+  InlineVector& operator=(InlineVector&& other) noexcept {
+    if (this != &other) {
+      release();
+      steal(other);
+    }
+    return *this;
+  }
+
+  ~InlineVector() { release(); }
+
+  [[nodiscard]] T* data() noexcept { return heap_ ? heap_ : inline_data(); }
+  [[nodiscard]] const T* data() const noexcept { return heap_ ? heap_ : inline_data(); }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  /// True while the elements still live in the inline buffer.
+  [[nodiscard]] bool is_inline() const noexcept { return heap_ == nullptr; }
+  [[nodiscard]] static constexpr std::size_t inline_capacity() noexcept { return N; }
+
+  T& operator[](std::size_t i) noexcept { return data()[i]; }
+  const T& operator[](std::size_t i) const noexcept { return data()[i]; }
+  T& back() noexcept { return data()[size_ - 1]; }
+  const T& back() const noexcept { return data()[size_ - 1]; }
+
+  iterator begin() noexcept { return data(); }
+  iterator end() noexcept { return data() + size_; }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + size_; }
+
+  operator std::span<T>() noexcept { return {data(), size_}; }
+  operator std::span<const T>() const noexcept { return {data(), size_}; }
+
+  void reserve(std::size_t n) {
+    if (n > capacity_) grow_to(n);
+  }
+
+  void push_back(const T& value) {
+    const T copy = value;  // value may live in the buffer that growing frees
+    if (size_ == capacity_) grow_to(std::size_t{capacity_} * 2);
+    data()[size_++] = copy;
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    // Built before growing, as in push_back(): args may refer into the buffer that growing frees.
+    const T value = T(std::forward<Args>(args)...);
+    if (size_ == capacity_) grow_to(std::size_t{capacity_} * 2);
+    T* slot = std::construct_at(data() + size_, value);
+    ++size_;
+    return *slot;
+  }
+
+  void pop_back() noexcept { --size_; }
+  /// Keeps the capacity (inline or heap) for reuse.
+  void clear() noexcept { size_ = 0; }
+
+ private:
+  T* inline_data() noexcept { return std::launder(reinterpret_cast<T*>(inline_)); }
+  const T* inline_data() const noexcept {
+    return std::launder(reinterpret_cast<const T*>(inline_));
+  }
+
+  void assign(const T* src, std::size_t n) {
+    reserve(n);
+    if (n > 0) std::memcpy(static_cast<void*>(data()), src, n * sizeof(T));
+    size_ = static_cast<std::uint32_t>(n);
+  }
+
+  void grow_to(std::size_t n) {
+    if (n > UINT32_MAX) throw std::length_error("InlineVector: too many elements");
+    T* heap = std::allocator<T>{}.allocate(n);
+    if (size_ > 0) std::memcpy(static_cast<void*>(heap), data(), std::size_t{size_} * sizeof(T));
+    release();
+    heap_ = heap;
+    capacity_ = static_cast<std::uint32_t>(n);
+  }
+
+  void release() noexcept {
+    if (heap_) std::allocator<T>{}.deallocate(heap_, capacity_);
+    heap_ = nullptr;
+    capacity_ = static_cast<std::uint32_t>(N);
+  }
+
+  void steal(InlineVector& other) noexcept {
+    if (other.heap_) {
+      heap_ = other.heap_;
+      capacity_ = other.capacity_;
+      other.heap_ = nullptr;
+      other.capacity_ = static_cast<std::uint32_t>(N);
+    } else if (other.size_ > 0) {
+      std::memcpy(inline_, other.inline_, std::size_t{other.size_} * sizeof(T));
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+  }
+
+  alignas(T) std::byte inline_[N * sizeof(T)];
+  T* heap_{nullptr};
+  std::uint32_t size_{0};
+  std::uint32_t capacity_{static_cast<std::uint32_t>(N)};
+};
+
+}  // namespace normitri::core
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace normitri::core {
+
+/// 4-byte handle to a string stored once per process (categories, camera and customer ids).
+///
+/// Constructing from a string interns it in a global table: equal strings get equal handles, so
+/// comparing handles compares strings, and copying one never allocates. Interned strings live
+/// until the process exits, so intern labels and ids (a bounded set), not per-frame payloads.
+/// The empty string is the default handle (id 0) and is never stored.
+///
+/// Thread-safety: interning takes a lock (shared for strings already present); view() is
+/// lock-free and may run concurrently with interning on other threads.
+class InternedString {
+ public:
+  constexpr InternedString() noexcept = default;
+  explicit InternedString(std::string_view s);
+
+  [[nodiscard]] constexpr std::uint32_t id() const noexcept { return id_; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return id_ == 0; }
+
+  /// The interned characters; valid for the rest of the process.
+  [[nodiscard]] std::string_view view() const noexcept;
+  [[nodiscard]] std::string str() const { return std::string(view()); }
+
+  friend constexpr bool operator==(InternedString, InternedString) noexcept = default;
+
+ private:
+  std::uint32_t id_{0};
+};
+
+/// Number of distinct non-empty strings interned so far.
+[[nodiscard]] std::size_t interned_string_count() noexcept;
+
+}  // namespace normitri::core
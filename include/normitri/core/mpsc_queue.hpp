@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace normitri::core {
+
+/// Unbounded multi-producer, single-consumer FIFO without locks (Vyukov's intrusive list).
+///
+/// push() is one allocation and one atomic exchange, so producers never wait for each other or
+/// for the consumer. pop() must only be called from one thread at a time. A pop() that races a
+/// push() still in progress may return nullopt although a later value is already queued; the
+/// value shows up on a later pop() once the slower producer has linked its node.
+template <typename T>
+class MpscQueue {
+  static_assert(std::is_default_constructible_v<T>, "MpscQueue needs default constructible T");
+
+ public:
+  MpscQueue() : head_(new Node), tail_(head_.load(std::memory_order_relaxed)) {}
+
+  ~MpscQueue() {
+    for (Node* node = tail_; node != nullptr;) {
+      Node* next = node->next.load(std::memory_order_relaxed);
+      delete node;
+      node = next;
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /// Any thread.
+  void push(T value) {
+    Node* node = new Node;
+    node->value = std::move(value);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  /// Consumer thread only. Returns the oldest linked value, or nullopt if there is none.
+  [[nodiscard]] std::optional<T> pop() {
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) return std::nullopt;
+    std::optional<T> value(std::move(next->value));
+    delete tail_;
+    tail_ = next;  // becomes the new (empty) stub
+    return value;
+  }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    T value{};
+  };
+
+  alignas(64) std::atomic<Node*> head_;  // last pushed node; producers swap themselves in
+  alignas(64) Node* tail_;               // stub before the oldest value; consumer only
+};
+
+}  // namespace normitri::core
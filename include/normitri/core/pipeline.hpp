@@ -2,11 +2,14 @@
 
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/error.hpp>
+#include <normitri/core/executor.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline_stage.hpp>
 #include <expected>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 namespace normitri::core {
@@ -23,17 +26,86 @@ class Pipeline {
 
   /// Run pipeline on one frame; returns first DefectResult or error.
   /// If timing_cb is non-null, it is called after each stage with (stage_index, duration_ms).
+  /// Stages that support process_into() write into two per-thread scratch frames in turn, so
+  /// after warmup their outputs reuse the same buffers on every call. Heap-allocated scratch
+  /// stays with the thread (up to two of the largest process_into() outputs it has produced, see
+  /// release_thread_scratch()); scratch drawn from a BufferPool goes back to the pool when the
+  /// run ends.
   /// Thread-safe: safe to call run() from multiple threads concurrently
   /// (stages are not modified during process()).
   [[nodiscard]] std::expected<DefectResult, PipelineError> run(
       const Frame& input,
       StageTimingCallback* timing_cb = nullptr);
 
+  /// Run pipeline on a batch of frames; returns one result per input, in input order.
+  /// Stages run per frame, on the calling thread and workers of \p executor (null = the shared
+  /// Executor), up to \p num_workers threads in total (0 = all), until a stage with
+  /// supports_batch(): it receives every frame still in flight in one process_batch() call (e.g.
+  /// one IInferenceBackend::infer_batch). A frame that fails or finishes early does not affect
+  /// the others. Same thread-safety as run().
+  [[nodiscard]] std::vector<std::expected<DefectResult, PipelineError>> run_batch(
+      std::span<const Frame> inputs,
+      std::size_t num_workers = 0,
+      Executor* executor = nullptr);
+
+  /// Index of the first stage with supports_batch(), or stage_count() if there is none: where
+  /// run_batch() joins frames into one call.
+  [[nodiscard]] std::size_t batch_stage() const noexcept;
+
+  /// Runs stages [first, last) on \p input like run(): the frame after stage last - 1, or the
+  /// DefectResult of a stage that finished early. Same thread-safety as run().
+  [[nodiscard]] std::expected<StageOutput, PipelineError> run_stages(std::size_t first,
+                                                                     std::size_t last,
+                                                                     const Frame& input);
+
+  /// The per-frame half of run_batch(): run_stages(0, batch_stage(), input), i.e. the frame to
+  /// batch. Lets a scheduler prepare frames as they arrive and batch them later.
+  [[nodiscard]] std::expected<StageOutput, PipelineError> run_to_batch_stage(const Frame& input) {
+    return run_stages(0, batch_stage(), input);
+  }
+
+  /// The rest of run_batch() for frames from run_to_batch_stage(): batch_stage() gets all of
+  /// \p prepared in one process_batch() call, then later stages run as in run_batch(). One result
+  /// per input, in input order.
+  [[nodiscard]] std::vector<std::expected<DefectResult, PipelineError>> run_from_batch_stage(
+      std::span<const Frame> prepared,
+      std::size_t num_workers = 0,
+      Executor* executor = nullptr);
+
+  /// Replica for another thread: a pipeline of every stage's clone(), so replicas share model
+  /// weights and buffer pools but not scratch state. Safe while this pipeline runs. Fails with
+  /// InvalidConfig if a stage does not support clone().
+  [[nodiscard]] std::expected<Pipeline, PipelineError> clone() const;
+
+  /// Frees the calling thread's scratch frames (shared by every pipeline run on that thread), e.g.
+  /// when a worker goes idle or its pipelines are torn down. No-op while a run is in progress on
+  /// this thread; the next run allocates them again.
+  static void release_thread_scratch() noexcept;
+
   [[nodiscard]] std::size_t stage_count() const noexcept {
     return stages_.size();
   }
 
+  /// Stage \p index (< stage_count()), e.g. to ask whether it is stateless().
+  [[nodiscard]] const IPipelineStage& stage(std::size_t index) const { return *stages_[index]; }
+
  private:
+  /// Run stages [first, last) on \p input. Returns the DefectResult if a stage produced one;
+  /// otherwise nullopt, with the last frame moved into \p out when non-null.
+  std::expected<std::optional<DefectResult>, PipelineError> run_range(
+      std::size_t first,
+      std::size_t last,
+      const Frame& input,
+      Frame* out,
+      StageTimingCallback* timing_cb);
+
+  /// run_batch() on \p frames, which have already passed stages [0, first).
+  std::vector<std::expected<DefectResult, PipelineError>> run_batch_from(
+      std::size_t first,
+      std::vector<Frame> frames,
+      std::size_t num_workers,
+      Executor* executor);
+
   std::vector<std::unique_ptr<IPipelineStage>> stages_;
 };
 
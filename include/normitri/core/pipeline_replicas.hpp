@@ -0,0 +1,68 @@
+#pragma once
+
+#include <normitri/core/pipeline.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace normitri::core {
+
+/// Per-thread replicas of one pipeline, for runners that run frames on many threads.
+///
+/// acquire() hands out an idle replica as a Lease, which returns it on destruction; if every
+/// replica is in use, a new one is cloned from the prototype (Pipeline::clone), so there are never
+/// more replicas than threads running at once. Replicas share what their stages share (model
+/// weights, buffer pools) and keep their own scratch state (inference run state, frame ids), so
+/// stateful stages such as the TensorRT backend scale across threads without locking. The
+/// prototype itself is only cloned, never run.
+///
+/// Thread-safety: all member functions may be called concurrently. Leases must not outlive the
+/// replicas.
+class PipelineReplicas {
+ public:
+  /// Exclusive use of one replica until destroyed (or moved from).
+  class Lease {
+   public:
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+    ~Lease();
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    Pipeline& operator*() const noexcept { return *pipeline_; }
+    Pipeline* operator->() const noexcept { return pipeline_; }
+
+   private:
+    friend class PipelineReplicas;
+    Lease(PipelineReplicas* owner, Pipeline* pipeline) noexcept
+        : owner_(owner), pipeline_(pipeline) {}
+
+    PipelineReplicas* owner_{nullptr};
+    Pipeline* pipeline_{nullptr};
+  };
+
+  /// Clones \p prototype once up front; throws std::invalid_argument if a stage does not support
+  /// clone().
+  explicit PipelineReplicas(Pipeline prototype);
+  ~PipelineReplicas();
+
+  PipelineReplicas(const PipelineReplicas&) = delete;
+  PipelineReplicas& operator=(const PipelineReplicas&) = delete;
+
+  /// Returns an idle replica, cloning a new one if all are in use. Clone failures (e.g. a backend
+  /// out of device memory) propagate as exceptions.
+  [[nodiscard]] Lease acquire();
+
+  /// Replicas created so far.
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  struct State;
+
+  void give_back(Pipeline* pipeline) noexcept;
+
+  Pipeline prototype_;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace normitri::core
@@ -3,15 +3,24 @@
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
+#include <cstdint>
 #include <expected>
 #include <memory>
+#include <span>
 #include <variant>
+#include <vector>
 
 namespace normitri::core {
 
 /// Output of a pipeline stage: either pass-through Frame or final DefectResult.
 using StageOutput = std::variant<Frame, DefectResult>;
 
+/// Outcome of IPipelineStage::process_into.
+enum class StageIntoResult : std::uint8_t {
+  Written,      // output holds this stage's result
+  PassThrough,  // stage leaves this input unchanged; continue with the input frame
+};
+
 /// Abstract pipeline stage: process one Frame, return Frame (continue) or DefectResult (done).
 class IPipelineStage {
  public:
@@ -19,6 +28,44 @@ class IPipelineStage {
 
   [[nodiscard]] virtual std::expected<StageOutput, PipelineError> process(
       const Frame& input) = 0;
+
+  /// Optional: true if process_into() is implemented. Pipeline::run then prefers it.
+  [[nodiscard]] virtual bool supports_process_into() const noexcept { return false; }
+
+  /// Optional in-place path for Frame -> Frame stages: write the result into \p output, reusing
+  /// its buffer via Frame::prepare() so that a caller ping-ponging between preallocated frames
+  /// allocates nothing per frame. \p output never aliases \p input. Default: InvalidConfig.
+  [[nodiscard]] virtual std::expected<StageIntoResult, PipelineError> process_into(
+      const Frame& /*input*/, Frame& /*output*/) {
+    return std::unexpected(PipelineError::InvalidConfig);
+  }
+
+  /// Optional: true if process() / process_into() keep no state between calls, so several frames
+  /// may pass through this stage at once (a parallel node in a pipelined runner). Default: false,
+  /// which keeps frames in order, one at a time (e.g. an inference backend with one context).
+  [[nodiscard]] virtual bool stateless() const noexcept { return false; }
+
+  /// Optional: true if process_batch() beats one process() per frame (e.g. one batched inference
+  /// call). Pipeline::run_batch then hands this stage all frames of a batch at once.
+  [[nodiscard]] virtual bool supports_batch() const noexcept { return false; }
+
+  /// Batched process(): exactly one output per input, in input order, so that one bad frame does
+  /// not fail the others. Default: process() per frame.
+  [[nodiscard]] virtual std::vector<std::expected<StageOutput, PipelineError>> process_batch(
+      std::span<const Frame> inputs) {
+    std::vector<std::expected<StageOutput, PipelineError>> outputs;
+    outputs.reserve(inputs.size());
+    for (const Frame& input : inputs) {
+      outputs.push_back(process(input));
+    }
+    return outputs;
+  }
+
+  /// Optional: an independent copy of this stage for another thread (see Pipeline::clone). The
+  /// copy shares read-only state (model weights, buffer pools) with this stage and owns its
+  /// mutable state (inference run state, frame ids). Must only read configuration, so it is safe
+  /// while this stage runs elsewhere. Default: nullptr (the stage cannot be cloned).
+  [[nodiscard]] virtual std::unique_ptr<IPipelineStage> clone() const { return nullptr; }
 };
 
 }  // namespace normitri::core
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace normitri::core {
+
+/// Releases values produced out of order on many threads to a sink in index order (0, 1, 2, ...).
+///
+/// Each index has a slot in a ring of window() slots. push() stores the value and marks the slot
+/// ready; then whichever thread finds the next index ready drains every consecutive ready slot
+/// into the sink. There is no lock: one atomic flag elects the draining thread, so sink calls are
+/// serialized (the sink need not be thread-safe) and a producer never waits for the sink while
+/// another thread is in it. A producer more than window() indices ahead of the oldest unreleased
+/// index waits for it, so one slow index holds back at most window() finished values.
+///
+/// Every index in [0, n) must be pushed exactly once (nullopt to skip one), or later indices are
+/// never released. Producers must claim indices in increasing order (as Executor::parallel_for
+/// does), so that the thread holding the oldest unreleased index is never waiting itself. If the
+/// sink throws, the exception reaches that push() call and the ring stops: later pushes return
+/// without storing or waiting.
+template <typename T>
+class ReorderRing {
+ public:
+  using Sink = std::function<void(T&)>;
+
+  /// \p window is rounded up to a power of two (at least 1).
+  ReorderRing(std::size_t window, Sink sink)
+      : window_(std::bit_ceil(window > 0 ? window : 1)),
+        slots_(std::make_unique<Slot[]>(window_)),
+        sink_(std::move(sink)) {}
+
+  ReorderRing(const ReorderRing&) = delete;
+  ReorderRing& operator=(const ReorderRing&) = delete;
+
+  /// Stores \p value for \p index (nullopt: nothing to deliver) and releases what became ready.
+  void push(std::size_t index, std::optional<T> value) {
+    for (std::size_t h = head_.load(std::memory_order_acquire); index >= h + window_;
+         h = head_.load(std::memory_order_acquire)) {
+      head_.wait(h, std::memory_order_acquire);
+    }
+    if (stopped_.load()) return;
+    Slot& slot = slots_[index & (window_ - 1)];
+    slot.value = std::move(value);
+    slot.ready.store(index);
+    drain();
+  }
+
+  /// Oldest index not yet released; every index below it has reached the sink (or was skipped).
+  [[nodiscard]] std::size_t next() const noexcept {
+    return head_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] std::size_t window() const noexcept { return window_; }
+
+ private:
+  static constexpr std::size_t kEmpty = SIZE_MAX;
+  static constexpr std::size_t kStopped = SIZE_MAX / 2;  // head_ after a sink exception
+
+  struct alignas(64) Slot {
+    std::atomic<std::size_t> ready{kEmpty};  // index whose value is stored here
+    std::optional<T> value;
+  };
+
+  void drain() {
+    for (;;) {
+      if (draining_.exchange(true)) return;  // the drainer re-checks after letting go
+      std::size_t h = head_.load(std::memory_order_relaxed);
+      try {
+        for (Slot* slot = &slots_[h & (window_ - 1)]; slot->ready.load() == h;
+             slot = &slots_[h & (window_ - 1)]) {
+          if (slot->value) sink_(*slot->value);
+          slot->value.reset();
+          head_.store(++h, std::memory_order_release);
+          head_.notify_all();
+        }
+      } catch (...) {
+        stopped_.store(true);
+        head_.store(kStopped, std::memory_order_release);  // wakes and releases every waiter
+        head_.notify_all();
+        draining_.store(false);
+        throw;
+      }
+      draining_.store(false);
+      // A producer may have marked slot h ready after the check above but before the store, and
+      // then lost the exchange; pick its value up rather than leave it stranded.
+      if (slots_[h & (window_ - 1)].ready.load() != h) return;
+    }
+  }
+
+  const std::size_t window_;
+  std::unique_ptr<Slot[]> slots_;
+  Sink sink_;
+  alignas(64) std::atomic<std::size_t> head_{0};
+  std::atomic<bool> draining_{false};
+  std::atomic<bool> stopped_{false};
+};
+
+}  // namespace normitri::core
@@ -1,24 +1,42 @@
 #pragma once
 
+#include <normitri/core/buffer_pool.hpp>
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline_stage.hpp>
 #include <normitri/core/error.hpp>
 #include <expected>
+#include <memory>
 
 namespace normitri::vision {
 
 /// Converts between pixel formats (e.g. BGR -> RGB).
+/// Output buffers are drawn from \p pool when given (see core::BufferPool).
 class ColorConvertStage : public normitri::core::IPipelineStage {
  public:
-  explicit ColorConvertStage(normitri::core::PixelFormat output_format);
+  explicit ColorConvertStage(normitri::core::PixelFormat output_format,
+                             std::shared_ptr<normitri::core::BufferPool> pool = nullptr);
 
   [[nodiscard]] std::expected<normitri::core::StageOutput,
                               normitri::core::PipelineError>
   process(const normitri::core::Frame& input) override;
 
+  [[nodiscard]] bool supports_process_into() const noexcept override { return true; }
+  [[nodiscard]] bool stateless() const noexcept override { return true; }
+
+  [[nodiscard]] std::expected<normitri::core::StageIntoResult,
+                              normitri::core::PipelineError>
+  process_into(const normitri::core::Frame& input,
+               normitri::core::Frame& output) override;
+
+  /// Copy with the same settings, sharing the buffer pool.
+  [[nodiscard]] std::unique_ptr<normitri::core::IPipelineStage> clone() const override {
+    return std::make_unique<ColorConvertStage>(*this);
+  }
+
  private:
   normitri::core::PixelFormat output_format_;
+  std::shared_ptr<normitri::core::BufferPool> pool_;
 };
 
 }  // namespace normitri::vision
@@ -2,7 +2,9 @@
 
 #include <normitri/core/defect.hpp>
 #include <normitri/vision/inference_result.hpp>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace normitri::vision {
@@ -10,23 +12,71 @@ namespace normitri::vision {
 /// Maps model class id to DefectKind.
 using ClassToDefectKindMap = std::vector<normitri::core::DefectKind>;
 
+/// Non-maximum suppression and ranking applied after the confidence threshold. The defaults
+/// turn everything off, so decode() keeps every detection above the threshold in model order.
+struct NmsOptions {
+  /// A detection is dropped if its IoU with a higher-scoring kept one exceeds this; >= 1 keeps
+  /// overlapping detections.
+  float iou_threshold{1.f};
+  /// Only the top_k highest-scoring candidates go into NMS; 0 = all.
+  std::size_t top_k{0};
+  /// At most this many detections are returned, highest score first; 0 = no limit.
+  std::size_t max_detections{0};
+  /// Only detections of the same class suppress each other.
+  bool class_aware{true};
+
+  /// True if any setting is on, i.e. decode() ranks the detections.
+  [[nodiscard]] bool enabled() const noexcept {
+    return iou_threshold < 1.f || top_k > 0 || max_detections > 0;
+  }
+};
+
 /// Decodes InferenceResult -> vector<Defect> with confidence threshold and optional NMS.
+///
+/// With NMS enabled, the surviving candidates are sorted by (class, score), laid out as
+/// structure-of-arrays boxes, and suppressed greedily with the SIMD suppress_overlaps kernel;
+/// the result is ordered by descending score. Candidates with a NaN score are dropped then.
 class DefectDecoder {
  public:
   DefectDecoder(float confidence_threshold,
-                ClassToDefectKindMap class_to_kind);
+                ClassToDefectKindMap class_to_kind,
+                NmsOptions nms = {});
 
   [[nodiscard]] std::vector<normitri::core::Defect> decode(
       const InferenceResult& result) const;
 
+  /// Decodes straight from a (possibly strided) view of the raw model output: the scores are
+  /// filtered with one SIMD compare-and-compact pass, and only the survivors' boxes and class
+  /// ids are read.
+  [[nodiscard]] std::vector<normitri::core::Defect> decode(
+      const DetectionView& detections) const;
+
+  /// decode() for each result of a batch, in order.
+  [[nodiscard]] std::vector<std::vector<normitri::core::Defect>> decode_batch(
+      std::span<const InferenceResult> results) const;
+
   void set_confidence_threshold(float t) noexcept { confidence_threshold_ = t; }
   [[nodiscard]] float confidence_threshold() const noexcept {
     return confidence_threshold_;
   }
 
+  void set_nms(const NmsOptions& nms) noexcept { nms_ = nms; }
+  [[nodiscard]] const NmsOptions& nms() const noexcept { return nms_; }
+
  private:
+  /// Appends the defect for detection \p i of \p detections to \p out.
+  void emit(const DetectionView& detections, std::size_t i,
+            std::vector<normitri::core::Defect>& out) const;
+
+  /// Ranks and suppresses the \p count candidates in \p selected; returns the kept indices
+  /// in descending score order.
+  [[nodiscard]] std::span<const std::uint32_t> suppress(const DetectionView& detections,
+                                                         const std::uint32_t* selected,
+                                                         std::size_t count) const;
+
   float confidence_threshold_;
   ClassToDefectKindMap class_to_kind_;
+  NmsOptions nms_;
 };
 
 }  // namespace normitri::vision
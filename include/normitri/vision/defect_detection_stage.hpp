@@ -9,10 +9,13 @@
 #include <expected>
 #include <memory>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 namespace normitri::vision {
 
-/// Pipeline stage: run inference backend + decoder -> DefectResult.
+/// Pipeline stage: run inference backend + decoder -> DefectResult. Batches through
+/// Pipeline::run_batch use the backend's infer_batch().
 class DefectDetectionStage : public normitri::core::IPipelineStage {
  public:
   DefectDetectionStage(std::unique_ptr<IInferenceBackend> backend,
@@ -23,6 +26,18 @@ class DefectDetectionStage : public normitri::core::IPipelineStage {
                               normitri::core::PipelineError>
   process(const normitri::core::Frame& input) override;
 
+  [[nodiscard]] bool supports_batch() const noexcept override { return true; }
+
+  /// Validates each frame, then runs one IInferenceBackend::infer_batch() over the valid ones and
+  /// one batched decode. Invalid frames get their own error; a failed batch fails every frame.
+  [[nodiscard]] std::vector<std::expected<normitri::core::StageOutput,
+                                          normitri::core::PipelineError>>
+  process_batch(std::span<const normitri::core::Frame> inputs) override;
+
+  /// Stage over the backend's clone() with the same decoder and frame id; nullptr if the
+  /// backend cannot be cloned.
+  [[nodiscard]] std::unique_ptr<normitri::core::IPipelineStage> clone() const override;
+
   void set_frame_id(std::uint64_t id) noexcept { frame_id_ = id; }
 
  private:
@@ -3,7 +3,10 @@
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/vision/inference_result.hpp>
+#include <cstddef>
 #include <expected>
+#include <functional>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -11,6 +14,10 @@ namespace normitri::vision {
 
 /// Expected input format and lifecycle: see docs/inference-contract.md.
 
+/// Receives the detections of frame \p index of an infer_visit() call. The view points into the
+/// backend's output buffers and is valid only during the call.
+using DetectionVisitor = std::function<void(std::size_t index, const DetectionView& detections)>;
+
 /// Abstract inference backend: Frame -> InferenceResult.
 /// Implement infer(); optionally override validate_input, infer_batch, warmup.
 class IInferenceBackend {
@@ -31,8 +38,20 @@ class IInferenceBackend {
   [[nodiscard]] virtual std::expected<std::vector<InferenceResult>, normitri::core::PipelineError>
   infer_batch(std::span<const normitri::core::Frame> inputs);
 
+  /// Optional: inference without materializing InferenceResult. Calls \p visitor once per frame,
+  /// in order, with a view of that frame's raw detections (e.g. over the output tensor), so a
+  /// decoder can filter them in one pass. On error, frames visited so far must be discarded.
+  /// Default: runs infer_batch() and visits a view of each result.
+  [[nodiscard]] virtual std::expected<void, normitri::core::PipelineError>
+  infer_visit(std::span<const normitri::core::Frame> inputs, const DetectionVisitor& visitor);
+
   /// Optional: warmup run (e.g. dummy inference). Call once after construction. Default: no-op.
   virtual void warmup() {}
+
+  /// Optional: a replica for another thread that shares the loaded model (weights, engine) with
+  /// this backend and has its own run state (bindings, device and staging buffers). Must be safe
+  /// to call while this backend runs. Default: nullptr (no replicas; see Pipeline::clone).
+  [[nodiscard]] virtual std::unique_ptr<IInferenceBackend> clone() const { return nullptr; }
 };
 
 }  // namespace normitri::vision
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace normitri::vision {
@@ -13,4 +15,55 @@ struct InferenceResult {
   std::uint32_t num_detections{0};
 };
 
+/// Non-owning, strided view of one frame's raw detections, e.g. straight over a model's output
+/// tensor, so decoding needs no intermediate InferenceResult.
+///
+/// Detection i has corner k (x1, y1, x2, y2) at boxes[i * box_stride + k * coord_stride], its
+/// score at scores[i * score_stride] and its class id at class_ids_*[i * class_stride], stored
+/// as float (YOLO-style outputs) or int64, whichever pointer is set. Without boxes or class ids
+/// those pointers are null; if only the first box_count / class_id_count detections have them
+/// (a partially filled InferenceResult), has_box() / has_class_id() tell which. Valid only while
+/// the backend call that provides it is running.
+struct DetectionView {
+  std::size_t count{0};
+  const float* boxes{nullptr};
+  std::size_t box_stride{4};
+  std::size_t coord_stride{1};
+  const float* scores{nullptr};
+  std::size_t score_stride{1};
+  const float* class_ids_f32{nullptr};
+  const std::int64_t* class_ids_i64{nullptr};
+  std::size_t class_stride{1};
+  std::size_t box_count{std::numeric_limits<std::size_t>::max()};       // default: every one
+  std::size_t class_id_count{std::numeric_limits<std::size_t>::max()};  // default: every one
+
+  [[nodiscard]] float score(std::size_t i) const noexcept { return scores[i * score_stride]; }
+  [[nodiscard]] float box(std::size_t i, std::size_t k) const noexcept {
+    return boxes[i * box_stride + k * coord_stride];
+  }
+  [[nodiscard]] bool has_class_ids() const noexcept {
+    return class_ids_f32 != nullptr || class_ids_i64 != nullptr;
+  }
+  /// True if detection i has a box; box(i, k) requires it.
+  [[nodiscard]] bool has_box(std::size_t i) const noexcept {
+    return boxes != nullptr && i < box_count;
+  }
+  /// True if detection i has a class id; class_id(i) requires it.
+  [[nodiscard]] bool has_class_id(std::size_t i) const noexcept {
+    return has_class_ids() && i < class_id_count;
+  }
+  /// Class id of detection i (float ids are truncated); requires has_class_id(i).
+  [[nodiscard]] std::int64_t class_id(std::size_t i) const noexcept {
+    return class_ids_i64 != nullptr ? class_ids_i64[i * class_stride]
+                                    : static_cast<std::int64_t>(class_ids_f32[i * class_stride]);
+  }
+
+  /// View over \p result. Detections without a score are left out; detections past the end of
+  /// boxes or class_ids keep their score, without a box or class id (as decode() always had).
+  [[nodiscard]] static DetectionView of(const InferenceResult& result) noexcept;
+
+  /// Copies the detections into an InferenceResult (contiguous boxes, scores, class ids).
+  [[nodiscard]] InferenceResult materialize() const;
+};
+
 }  // namespace normitri::vision
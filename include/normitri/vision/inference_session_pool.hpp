@@ -0,0 +1,155 @@
+#pragma once
+
+#include <normitri/core/error.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/vision/inference_backend.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace normitri::vision {
+
+/// Sizing for an InferenceSessionPool.
+struct SessionPoolOptions {
+  /// Upper bound on sessions; size it to cores (or GPU streams), not to cameras.
+  std::size_t max_sessions{1};
+  /// Memory the pool's sessions may use together, in bytes; 0 = no budget. Requires
+  /// session_memory_bytes (the constructor throws std::invalid_argument without it).
+  std::size_t memory_budget_bytes{0};
+  /// Resident memory one session adds (e.g. from normitri_onnx_memory_bench); with a budget,
+  /// the pool holds at most memory_budget_bytes / session_memory_bytes sessions. 0 = unknown.
+  std::size_t session_memory_bytes{0};
+};
+
+/// Counters for an InferenceSessionPool (monotonic since construction, except sessions/in_use).
+struct SessionPoolStats {
+  std::size_t sessions{0};        // sessions created so far (<= capacity())
+  std::size_t in_use{0};          // sessions currently checked out
+  std::uint64_t checkouts{0};     // completed checkouts
+  std::uint64_t waits{0};         // checkouts that blocked because every session was in use
+  std::uint64_t total_wait_ns{0};  // time callers spent blocked, summed over checkouts
+  std::uint64_t max_wait_ns{0};    // longest single blocked checkout
+};
+
+/// Pool of K inference sessions of one model, shared by many pipelines (e.g. M cameras).
+///
+/// checkout() hands out an idle session as a Lease, which returns it on destruction. Sessions are
+/// created on demand by the factory, up to capacity(); beyond that, callers block until a lease is
+/// returned, and the time they wait is recorded in stats(). Sizing the pool to the cores rather
+/// than to the cameras bounds memory (one set of weights, activations and arena per session) and
+/// keeps every session busy.
+///
+/// Thread-safety: all member functions may be called concurrently. Leases must not outlive the
+/// pool.
+class InferenceSessionPool {
+ public:
+  using Factory = std::function<std::unique_ptr<IInferenceBackend>()>;
+
+  /// Exclusive use of one session until destroyed (or moved from).
+  class Lease {
+   public:
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+    ~Lease();
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    IInferenceBackend& operator*() const noexcept { return *session_; }
+    IInferenceBackend* operator->() const noexcept { return session_; }
+
+   private:
+    friend class InferenceSessionPool;
+    Lease(InferenceSessionPool* pool, IInferenceBackend* session) noexcept
+        : pool_(pool), session_(session) {}
+
+    InferenceSessionPool* pool_{nullptr};
+    IInferenceBackend* session_{nullptr};
+  };
+
+  /// \param factory Creates one session (e.g. an OnnxInferenceBackend on the shared model).
+  ///        Called lazily, outside the pool lock, and each new session is warmed up before it is
+  ///        handed out; exceptions from either propagate to the caller of checkout().
+  /// \throws std::invalid_argument if \p factory is empty, or options set memory_budget_bytes
+  ///         without session_memory_bytes.
+  InferenceSessionPool(Factory factory, SessionPoolOptions options = {});
+  ~InferenceSessionPool();
+
+  InferenceSessionPool(const InferenceSessionPool&) = delete;
+  InferenceSessionPool& operator=(const InferenceSessionPool&) = delete;
+
+  /// Returns an idle session, creating one if below capacity; otherwise blocks until one is
+  /// returned.
+  [[nodiscard]] Lease checkout();
+
+  /// Like checkout(), but returns nullopt instead of blocking.
+  [[nodiscard]] std::optional<Lease> try_checkout();
+
+  /// Most sessions the pool will hold: max_sessions, reduced by the memory budget (at least 1).
+  [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+
+  /// Creates (and so warms up) the remaining sessions up to capacity() ahead of the first frames.
+  void warmup();
+
+  /// Checks a frame against the model without a checkout: uses the first session's
+  /// validate_input(), which is const and must be safe to call while the session is in use.
+  [[nodiscard]] std::expected<void, normitri::core::PipelineError>
+  validate_input(const normitri::core::Frame& input);
+
+  [[nodiscard]] SessionPoolStats stats() const;
+
+ private:
+  struct State;
+
+  void give_back(IInferenceBackend* session) noexcept;
+  /// Creates and warms up a session for a slot already reserved under the lock; releases the
+  /// slot on failure.
+  IInferenceBackend* create_session();
+
+  Factory factory_;
+  std::size_t capacity_{1};
+  std::unique_ptr<State> state_;
+};
+
+/// IInferenceBackend view of a shared InferenceSessionPool: each call checks out a session for
+/// its duration. Give each camera's DefectDetectionStage its own PooledInferenceBackend on the
+/// same pool, so M pipelines share K sessions.
+class PooledInferenceBackend : public IInferenceBackend {
+ public:
+  explicit PooledInferenceBackend(std::shared_ptr<InferenceSessionPool> pool);
+
+  [[nodiscard]] std::expected<InferenceResult, normitri::core::PipelineError>
+  infer(const normitri::core::Frame& input) override;
+
+  [[nodiscard]] std::expected<void, normitri::core::PipelineError>
+  validate_input(const normitri::core::Frame& input) const override;
+
+  /// Runs the whole batch on one session.
+  [[nodiscard]] std::expected<std::vector<InferenceResult>, normitri::core::PipelineError>
+  infer_batch(std::span<const normitri::core::Frame> inputs) override;
+
+  /// Runs the whole batch on one session, which stays checked out while \p visitor runs.
+  [[nodiscard]] std::expected<void, normitri::core::PipelineError>
+  infer_visit(std::span<const normitri::core::Frame> inputs,
+              const DetectionVisitor& visitor) override;
+
+  /// Warms the pool (its sessions are created once, whichever handle asks first).
+  void warmup() override;
+
+  /// Another handle on the same pool.
+  [[nodiscard]] std::unique_ptr<IInferenceBackend> clone() const override;
+
+  [[nodiscard]] const std::shared_ptr<InferenceSessionPool>& pool() const noexcept {
+    return pool_;
+  }
+
+ private:
+  std::shared_ptr<InferenceSessionPool> pool_;
+};
+
+}  // namespace normitri::vision
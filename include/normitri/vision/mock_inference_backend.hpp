@@ -2,6 +2,7 @@
 
 #include <normitri/vision/inference_backend.hpp>
 #include <normitri/core/defect.hpp>
+#include <memory>
 #include <vector>
 
 namespace normitri::vision {
@@ -21,6 +22,9 @@ class MockInferenceBackend : public IInferenceBackend {
   [[nodiscard]] std::expected<std::vector<InferenceResult>, normitri::core::PipelineError>
   infer_batch(std::span<const normitri::core::Frame> inputs) override;
 
+  /// Copy returning the same defects.
+  [[nodiscard]] std::unique_ptr<IInferenceBackend> clone() const override;
+
  private:
   std::vector<normitri::core::Defect> defects_to_return_;
 };
@@ -1,24 +1,47 @@
 #pragma once
 
+#include <normitri/core/buffer_pool.hpp>
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline_stage.hpp>
 #include <expected>
+#include <memory>
 
 namespace normitri::vision {
 
-/// Normalizes pixel values (e.g. mean/scale for neural network input).
+/// Normalizes pixel values (e.g. mean/scale for neural network input) into a float32 frame.
+/// Output is interleaved (TensorLayout::HWC) by default; with \p layout CHW it writes one plane
+/// per channel, which NCHW backends consume without transposing.
+/// Output buffers are drawn from \p pool when given (see core::BufferPool).
 class NormalizeStage : public normitri::core::IPipelineStage {
  public:
-  NormalizeStage(float mean, float scale);
+  NormalizeStage(float mean,
+                 float scale,
+                 std::shared_ptr<normitri::core::BufferPool> pool = nullptr,
+                 normitri::core::TensorLayout layout = normitri::core::TensorLayout::HWC);
 
   [[nodiscard]] std::expected<normitri::core::StageOutput,
                               normitri::core::PipelineError>
   process(const normitri::core::Frame& input) override;
 
+  [[nodiscard]] bool supports_process_into() const noexcept override { return true; }
+  [[nodiscard]] bool stateless() const noexcept override { return true; }
+
+  [[nodiscard]] std::expected<normitri::core::StageIntoResult,
+                              normitri::core::PipelineError>
+  process_into(const normitri::core::Frame& input,
+               normitri::core::Frame& output) override;
+
+  /// Copy with the same settings, sharing the buffer pool.
+  [[nodiscard]] std::unique_ptr<normitri::core::IPipelineStage> clone() const override {
+    return std::make_unique<NormalizeStage>(*this);
+  }
+
  private:
   float mean_;
   float scale_;
+  std::shared_ptr<normitri::core::BufferPool> pool_;
+  normitri::core::TensorLayout layout_;
 };
 
 }  // namespace normitri::vision
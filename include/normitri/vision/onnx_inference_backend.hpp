@@ -5,11 +5,68 @@
 #include <normitri/vision/inference_backend.hpp>
 #include <normitri/vision/inference_result.hpp>
 #include <array>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace normitri::vision {
 
+/// ONNX Runtime execution mode: run graph nodes one at a time (using intra-op threads inside each
+/// node) or let independent branches run concurrently on the inter-op pool.
+enum class OnnxExecutionMode : std::uint8_t {
+  Sequential,
+  Parallel,
+};
+
+/// ONNX Runtime graph optimization level (ORT_DISABLE_ALL ... ORT_ENABLE_ALL).
+enum class OnnxGraphOptimization : std::uint8_t {
+  Disabled,
+  Basic,
+  Extended,
+  All,
+};
+
+/// Session tuning for OnnxInferenceBackend. Defaults keep one intra-op thread per session, which
+/// favours aggregate throughput when many pipelines run side by side; raise intra_op_threads for
+/// lower single-frame latency.
+struct OnnxSessionOptions {
+  /// Threads used inside one operator; 0 = ONNX Runtime default (one per physical core).
+  int intra_op_threads{1};
+  /// Threads running independent nodes in Parallel mode; 0 = ONNX Runtime default.
+  int inter_op_threads{0};
+  OnnxExecutionMode execution_mode{OnnxExecutionMode::Sequential};
+  OnnxGraphOptimization graph_optimization{OnnxGraphOptimization::Extended};
+  /// Pre-plan allocations from the first run's shapes; turn off when input shapes vary.
+  bool enable_mem_pattern{true};
+  /// Arena allocator for CPU tensors; turn off to return memory to the system between runs.
+  bool enable_cpu_mem_arena{true};
+  /// Let idle pool threads spin before sleeping: lower latency, but burns CPU between frames.
+  bool allow_spinning{true};
+  /// Run on the process-wide Env's global thread pools (sized by the thread counts above)
+  /// instead of per-session pools, so N backends share one set of threads. The pools are
+  /// created by the first backend that asks for them; later backends reuse them as they are.
+  bool use_global_thread_pool{false};
+  /// Directory for cached optimized models ("" = off). A cold start saves the optimized graph
+  /// in ORT format, keyed by model hash, ONNX Runtime version and optimization settings; later
+  /// backends and processes load it and skip parsing and graph optimization.
+  std::string optimized_model_cache_dir;
+  /// Load each model file once per process and share it between backends: the file is
+  /// memory-mapped and its prepacked weights live in one container. The initializers are shared
+  /// only when the session loads an ORT-format entry of optimized_model_cache_dir (cache hit),
+  /// which uses them in place; from the plain .onnx file, ONNX Runtime still copies every
+  /// initializer into each session, and only the prepacked weights are shared.
+  bool share_model_weights{false};
+};
+
+/// How the session was created, see OnnxSessionOptions::optimized_model_cache_dir.
+enum class OnnxCacheStatus : std::uint8_t {
+  Disabled,  // no cache directory configured (or the model could not be hashed)
+  Hit,       // loaded from a valid cache entry
+  Miss,      // optimized from the .onnx file; entry written for next time
+};
+
 /// ONNX Runtime inference backend: loads an ONNX model and implements IInferenceBackend.
 ///
 /// Expected model: detection model with one input (float image) and either:
@@ -18,19 +75,36 @@ namespace normitri::vision {
 /// - **One output (YOLO-style)**: single tensor [1, N, 6] or [1, 6, N] with (xmin, ymin, xmax, ymax, score, class_id)
 ///   per detection (e.g. onnx-community YOLOv10).
 /// Output names are configurable via constructor; if empty, the first output(s) are used.
+/// All backends in a process share one Ort::Env; see OnnxSessionOptions for threading and
+/// OnnxSessionOptions::share_model_weights for sharing one model's weights between backends.
+///
+/// Input contract: Frame must be Float32Planar, dimensions matching model input
+/// (e.g. 640x640). See docs/inference-contract.md. If the model expects NCHW, HWC frames are
+/// transposed when copying to the input tensor, while CHW frames (PreprocessStage) are bound
+/// directly without a copy. NHWC models accept HWC frames only.
+///
+/// Batching: if the model's batch dimension is symbolic, infer_batch() stacks the frames into one
+/// [N, ...] tensor and calls Session::Run once; outputs [N, ...] are split per frame. Models with
+/// a fixed batch of 1 run infer_batch() as one infer() per frame.
 ///
-/// Input contract: Frame must be Float32Planar, HWC, dimensions matching model input
-/// (e.g. 640x640). See docs/inference-contract.md. If the model expects NCHW, the
-/// backend transposes from HWC when copying to the input tensor.
+/// Runs go through Ort::IoBinding: inputs and (for static output shapes) preallocated outputs stay
+/// bound between runs, and results are decoded straight out of the bound output buffers.
+/// infer_visit() hands out strided views over those buffers, so a decoder reads the raw output
+/// tensor without an intermediate InferenceResult.
+///
+/// Thread safety: infer(), infer_batch() and infer_visit() are reentrant. Session::Run is thread-safe and each
+/// call binds its own run context, so one backend (and one session) may serve many workers.
 class OnnxInferenceBackend : public IInferenceBackend {
  public:
   /// \param model_path Path to the .onnx model file.
   /// \param input_name Optional input tensor name; if empty, the first input is used.
   /// \param output_names Optional {boxes, scores, class_ids}; if any empty, names are
   ///        inferred from the model (first three outputs in order).
+  /// \param options Session threading, execution and memory tuning.
   OnnxInferenceBackend(std::string model_path,
                        std::string input_name = {},
-                       std::array<std::string, 3> output_names = {});
+                       std::array<std::string, 3> output_names = {},
+                       OnnxSessionOptions options = {});
 
   ~OnnxInferenceBackend() override;
 
@@ -43,11 +117,36 @@ class OnnxInferenceBackend : public IInferenceBackend {
   [[nodiscard]] std::expected<void, normitri::core::PipelineError>
   validate_input(const normitri::core::Frame& input) const override;
 
+  /// One session run for the whole batch when supports_dynamic_batch(); otherwise per frame.
+  /// Fails as a whole if any frame is invalid (validate first to isolate bad frames).
+  [[nodiscard]] std::expected<std::vector<InferenceResult>, normitri::core::PipelineError>
+  infer_batch(std::span<const normitri::core::Frame> inputs) override;
+
+  /// Batched like infer_batch(); views point into the run's output tensors.
+  [[nodiscard]] std::expected<void, normitri::core::PipelineError>
+  infer_visit(std::span<const normitri::core::Frame> inputs,
+              const DetectionVisitor& visitor) override;
+
+  /// True if the model input has a symbolic batch dimension.
+  [[nodiscard]] bool supports_dynamic_batch() const noexcept;
+
+  /// Whether the session came from the optimized-model cache.
+  [[nodiscard]] OnnxCacheStatus cache_status() const noexcept;
+
   void warmup() override;
 
+  /// Replica on the same session (one copy of the weights) with its own run contexts, so
+  /// replicas on different threads share nothing mutable.
+  [[nodiscard]] std::unique_ptr<IInferenceBackend> clone() const override;
+
  private:
   struct Impl;
-  std::unique_ptr<Impl> impl_;
+  struct Contexts;
+
+  explicit OnnxInferenceBackend(std::shared_ptr<Impl> impl);
+
+  std::shared_ptr<Impl> impl_;          // session and model description; shared with clones
+  std::unique_ptr<Contexts> contexts_;  // this backend's idle run contexts
 };
 
 }  // namespace normitri::vision
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <normitri/core/buffer_pool.hpp>
+#include <normitri/core/error.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline_stage.hpp>
+#include <cstdint>
+#include <expected>
+#include <memory>
+
+namespace normitri::vision {
+
+/// Parameters of the fused preprocessing stage (same meaning as ResizeStage / NormalizeStage).
+struct PreprocessOptions {
+  std::uint32_t width{640};
+  std::uint32_t height{640};
+  /// Output value = (pixel - mean) * scale, as in NormalizeStage.
+  float mean{0.f};
+  float scale{1.f / 255.f};
+  /// Channel order of the output planes: RGB8 or BGR8. Unknown keeps the source order.
+  normitri::core::PixelFormat channel_order{normitri::core::PixelFormat::Unknown};
+};
+
+/// Fused Resize + ColorConvert + Normalize + HWC->CHW stage.
+///
+/// Reads a uint8 frame (BGR8, RGB8, BGRA8, RGBA8 or Grayscale8) once and writes the model's
+/// planar float tensor directly: bilinear resize (pixel-center aligned, like cv::INTER_LINEAR),
+/// channel swap, and (pixel - mean) * scale in one pass. The output is Float32Planar with
+/// TensorLayout::CHW, which backends feed to NCHW models without transposing. Replaces the
+/// Resize -> Normalize chain plus the backend transpose (three passes, three buffers).
+/// Output buffers are drawn from \p pool when given (see core::BufferPool).
+class PreprocessStage : public normitri::core::IPipelineStage {
+ public:
+  explicit PreprocessStage(PreprocessOptions options,
+                           std::shared_ptr<normitri::core::BufferPool> pool = nullptr);
+
+  [[nodiscard]] std::expected<normitri::core::StageOutput,
+                              normitri::core::PipelineError>
+  process(const normitri::core::Frame& input) override;
+
+  [[nodiscard]] bool supports_process_into() const noexcept override { return true; }
+  [[nodiscard]] bool stateless() const noexcept override { return true; }
+
+  [[nodiscard]] std::expected<normitri::core::StageIntoResult,
+                              normitri::core::PipelineError>
+  process_into(const normitri::core::Frame& input,
+               normitri::core::Frame& output) override;
+
+  /// Copy with the same settings, sharing the buffer pool.
+  [[nodiscard]] std::unique_ptr<normitri::core::IPipelineStage> clone() const override {
+    return std::make_unique<PreprocessStage>(*this);
+  }
+
+  [[nodiscard]] const PreprocessOptions& options() const noexcept { return options_; }
+
+ private:
+  PreprocessOptions options_;
+  std::shared_ptr<normitri::core::BufferPool> pool_;
+};
+
+}  // namespace normitri::vision
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <normitri/core/buffer_pool.hpp>
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline_stage.hpp>
@@ -10,17 +11,34 @@
 namespace normitri::vision {
 
 /// Resizes input frame to a fixed size (e.g. inference input size).
+/// Output buffers are drawn from \p pool when given (see core::BufferPool).
 class ResizeStage : public normitri::core::IPipelineStage {
  public:
-  ResizeStage(std::uint32_t target_width, std::uint32_t target_height);
+  ResizeStage(std::uint32_t target_width,
+              std::uint32_t target_height,
+              std::shared_ptr<normitri::core::BufferPool> pool = nullptr);
 
   [[nodiscard]] std::expected<normitri::core::StageOutput,
                               normitri::core::PipelineError>
   process(const normitri::core::Frame& input) override;
 
+  [[nodiscard]] bool supports_process_into() const noexcept override { return true; }
+  [[nodiscard]] bool stateless() const noexcept override { return true; }
+
+  [[nodiscard]] std::expected<normitri::core::StageIntoResult,
+                              normitri::core::PipelineError>
+  process_into(const normitri::core::Frame& input,
+               normitri::core::Frame& output) override;
+
+  /// Copy with the same settings, sharing the buffer pool.
+  [[nodiscard]] std::unique_ptr<normitri::core::IPipelineStage> clone() const override {
+    return std::make_unique<ResizeStage>(*this);
+  }
+
  private:
   std::uint32_t target_width_;
   std::uint32_t target_height_;
+  std::shared_ptr<normitri::core::BufferPool> pool_;
 };
 
 }  // namespace normitri::vision
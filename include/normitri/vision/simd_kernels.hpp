@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace normitri::vision::simd {
+
+/// Instruction set a kernel table is built for, in increasing order of capability.
+enum class SimdLevel : std::uint8_t {
+  Scalar,
+  SSE41,   // SSE4.1 + SSSE3
+  AVX2,    // AVX2 + FMA
+  AVX512,  // AVX-512F
+};
+
+/// Axis-aligned boxes as structure-of-arrays (corners x1 <= x2, y1 <= y2, and their areas), so
+/// one box can be compared against many with contiguous vector loads.
+struct BoxesSoA {
+  const float* x1{nullptr};
+  const float* y1{nullptr};
+  const float* x2{nullptr};
+  const float* y2{nullptr};
+  const float* area{nullptr};
+};
+
+/// Tensor preprocessing and decode kernels for one instruction set. All pointers may be
+/// unaligned; source and destination ranges must not overlap. Results match the scalar reference
+/// up to float rounding (vector levels use fused multiply-add).
+struct SimdKernels {
+  SimdLevel level{SimdLevel::Scalar};
+
+  /// De-interleaves \p pixels 3-channel float pixels (HWC) into three planes.
+  /// Swap channels by swapping the destination pointers.
+  void (*deinterleave3_f32)(const float* src,
+                            std::size_t pixels,
+                            float* dst0,
+                            float* dst1,
+                            float* dst2){nullptr};
+
+  /// Converts \p pixels interleaved uint8 pixels of \p src_channels (3 or 4; 1 uses the scalar
+  /// path) into three float planes: dst_c[i] = src[i * src_channels + channel_map[c]] * scale +
+  /// bias. channel_map selects (and swaps) source channels, e.g. {2, 1, 0} for BGR -> RGB.
+  void (*u8_to_f32_planar)(const std::uint8_t* src,
+                           std::size_t pixels,
+                           std::uint32_t src_channels,
+                           const std::array<std::uint32_t, 3>& channel_map,
+                           float scale,
+                           float bias,
+                           float* dst0,
+                           float* dst1,
+                           float* dst2){nullptr};
+
+  /// dst[i] = src[i] * scale + bias for \p count elements (interleaved normalize).
+  void (*u8_to_f32)(const std::uint8_t* src,
+                    std::size_t count,
+                    float scale,
+                    float bias,
+                    float* dst){nullptr};
+
+  /// Compare-and-compact: writes the indices i < \p count with !(src[i * stride] < threshold)
+  /// to \p indices in increasing order and returns how many were written. NaN scores are kept,
+  /// like a scalar `if (score < threshold) continue;`. \p indices must have room for \p count.
+  std::size_t (*select_at_least)(const float* src,
+                                 std::size_t count,
+                                 std::size_t stride,
+                                 float threshold,
+                                 std::uint32_t* indices){nullptr};
+
+  /// Greedy-NMS inner loop: sets suppressed[j] to nonzero for each j in [begin, end) whose IoU
+  /// with box \p ref exceeds \p iou_threshold (tested as intersection > threshold * union, no
+  /// division). Entries already nonzero stay so.
+  void (*suppress_overlaps)(const BoxesSoA& boxes,
+                            std::size_t ref,
+                            std::size_t begin,
+                            std::size_t end,
+                            float iou_threshold,
+                            std::uint32_t* suppressed){nullptr};
+};
+
+/// Highest level supported by this CPU and build (always Scalar off x86 or without GCC/Clang).
+[[nodiscard]] SimdLevel detected_simd_level() noexcept;
+
+/// Kernels for the best supported level, chosen once per process. The NORMITRI_SIMD environment
+/// variable (scalar | sse4.1 | avx2 | avx512) caps the level, e.g. to compare or debug paths.
+[[nodiscard]] const SimdKernels& simd_kernels() noexcept;
+
+/// Kernels for \p level, or for the highest supported level below it.
+[[nodiscard]] const SimdKernels& simd_kernels(SimdLevel level) noexcept;
+
+[[nodiscard]] const char* simd_level_name(SimdLevel level) noexcept;
+
+}  // namespace normitri::vision::simd
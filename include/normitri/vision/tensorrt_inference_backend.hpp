@@ -14,8 +14,9 @@ namespace normitri::vision {
 /// Expected engine: built from a detection model with one input (float image, NCHW) and either:
 /// - **One output (YOLO-style)**: [1, N, 6] or [1, 6, N] (xmin, ymin, xmax, ymax, score, class_id).
 /// - **Three outputs**: boxes [1,N,4], scores [1,N], class_ids [1,N] (or equivalent layouts).
-/// Input contract: Frame must be Float32Planar, HWC, dimensions matching the engine input
-/// (e.g. 640×640). See docs/inference-contract.md. The backend copies HWC to NCHW and to GPU.
+/// Input contract: Frame must be Float32Planar, dimensions matching the engine input
+/// (e.g. 640×640). See docs/inference-contract.md. HWC frames are transposed to NCHW before the
+/// GPU upload; CHW frames (PreprocessStage) are uploaded as-is.
 ///
 /// Requires CUDA and TensorRT at build time; build with -DNORMITRI_USE_TENSORRT=ON and
 /// TensorRT/CUDA installed. At runtime, a GPU is required.
@@ -37,8 +38,15 @@ class TensorRTInferenceBackend : public IInferenceBackend {
 
   void warmup() override;
 
+  /// Replica on the same engine (weights stay on the device once) with its own execution
+  /// context and buffers; give each thread its own clone() instead of sharing one backend.
+  [[nodiscard]] std::unique_ptr<IInferenceBackend> clone() const override;
+
  private:
   struct Impl;
+
+  explicit TensorRTInferenceBackend(std::unique_ptr<Impl> impl);
+
   std::unique_ptr<Impl> impl_;
 };
 
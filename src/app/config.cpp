@@ -27,6 +27,19 @@ bool parse_line(std::string_view line, std::string& key, std::string& value) {
   return !key.empty();
 }
 
+/// Accepts true/false, 1/0, on/off; leaves \p out unchanged otherwise.
+bool parse_bool(std::string_view value, bool& out) {
+  if (value == "true" || value == "1" || value == "on") {
+    out = true;
+    return true;
+  }
+  if (value == "false" || value == "0" || value == "off") {
+    out = false;
+    return true;
+  }
+  return false;
+}
+
 }  // namespace
 
 PipelineConfig default_config() {
@@ -37,7 +50,13 @@ PipelineConfig default_config() {
   c.resize_height = 640;
   c.normalize_mean = 0.f;
   c.normalize_scale = 1.f / 255.f;
+  c.normalize_layout = normitri::core::TensorLayout::HWC;
+  c.preprocess = PreprocessMode::Chain;
+  c.model_channel_order = normitri::core::PixelFormat::Unknown;
   c.confidence_threshold = 0.5f;
+  c.nms = {};
+  c.buffer_pool_mb = 256;
+  c.onnx_session = {};
   return c;
 }
 
@@ -53,20 +72,73 @@ PipelineConfig load_config(const std::string& path) {
     trim(line);
     if (line.empty() || line[0] == '#') continue;
     if (!parse_line(line, key, value)) continue;
-
-    if (key == "model_path") c.model_path = value;
-    else if (key == "backend_type") {
-      if (value == "onnx") c.backend_type = InferenceBackendType::Onnx;
-      else if (value == "tensorrt") c.backend_type = InferenceBackendType::TensorRT;
-      else if (value == "mock") c.backend_type = InferenceBackendType::Mock;
-    }
-    else if (key == "resize_width") c.resize_width = static_cast<std::uint32_t>(std::stoul(value));
-    else if (key == "resize_height") c.resize_height = static_cast<std::uint32_t>(std::stoul(value));
-    else if (key == "normalize_mean") c.normalize_mean = std::stof(value);
-    else if (key == "normalize_scale") c.normalize_scale = std::stof(value);
-    else if (key == "confidence_threshold") c.confidence_threshold = std::stof(value);
+    apply_config_value(c, key, value);
   }
   return c;
 }
 
+bool apply_config_value(PipelineConfig& c, const std::string& key, const std::string& value) {
+  using normitri::vision::OnnxExecutionMode;
+  using normitri::vision::OnnxGraphOptimization;
+  auto& onnx = c.onnx_session;
+
+  if (key == "model_path") c.model_path = value;
+  else if (key == "backend_type") {
+    if (value == "onnx") c.backend_type = InferenceBackendType::Onnx;
+    else if (value == "tensorrt") c.backend_type = InferenceBackendType::TensorRT;
+    else if (value == "mock") c.backend_type = InferenceBackendType::Mock;
+    else return false;
+  }
+  else if (key == "resize_width") c.resize_width = static_cast<std::uint32_t>(std::stoul(value));
+  else if (key == "resize_height") c.resize_height = static_cast<std::uint32_t>(std::stoul(value));
+  else if (key == "normalize_mean") c.normalize_mean = std::stof(value);
+  else if (key == "normalize_scale") c.normalize_scale = std::stof(value);
+  else if (key == "normalize_layout") {
+    if (value == "chw") c.normalize_layout = normitri::core::TensorLayout::CHW;
+    else if (value == "hwc") c.normalize_layout = normitri::core::TensorLayout::HWC;
+    else return false;
+  }
+  else if (key == "preprocess") {
+    if (value == "fused") c.preprocess = PreprocessMode::Fused;
+    else if (value == "chain") c.preprocess = PreprocessMode::Chain;
+    else return false;
+  }
+  else if (key == "model_channel_order") {
+    if (value == "rgb") c.model_channel_order = normitri::core::PixelFormat::RGB8;
+    else if (value == "bgr") c.model_channel_order = normitri::core::PixelFormat::BGR8;
+    else if (value == "source") c.model_channel_order = normitri::core::PixelFormat::Unknown;
+    else return false;
+  }
+  else if (key == "confidence_threshold") c.confidence_threshold = std::stof(value);
+  else if (key == "nms_iou_threshold") c.nms.iou_threshold = std::stof(value);
+  else if (key == "nms_top_k") c.nms.top_k = static_cast<std::size_t>(std::stoul(value));
+  else if (key == "nms_max_detections") {
+    c.nms.max_detections = static_cast<std::size_t>(std::stoul(value));
+  }
+  else if (key == "nms_class_aware") return parse_bool(value, c.nms.class_aware);
+  else if (key == "buffer_pool_mb") c.buffer_pool_mb = static_cast<std::size_t>(std::stoul(value));
+  else if (key == "onnx_intra_op_threads") onnx.intra_op_threads = std::stoi(value);
+  else if (key == "onnx_inter_op_threads") onnx.inter_op_threads = std::stoi(value);
+  else if (key == "onnx_execution_mode") {
+    if (value == "sequential") onnx.execution_mode = OnnxExecutionMode::Sequential;
+    else if (value == "parallel") onnx.execution_mode = OnnxExecutionMode::Parallel;
+    else return false;
+  }
+  else if (key == "onnx_graph_optimization") {
+    if (value == "disabled") onnx.graph_optimization = OnnxGraphOptimization::Disabled;
+    else if (value == "basic") onnx.graph_optimization = OnnxGraphOptimization::Basic;
+    else if (value == "extended") onnx.graph_optimization = OnnxGraphOptimization::Extended;
+    else if (value == "all") onnx.graph_optimization = OnnxGraphOptimization::All;
+    else return false;
+  }
+  else if (key == "onnx_mem_pattern") return parse_bool(value, onnx.enable_mem_pattern);
+  else if (key == "onnx_cpu_mem_arena") return parse_bool(value, onnx.enable_cpu_mem_arena);
+  else if (key == "onnx_allow_spinning") return parse_bool(value, onnx.allow_spinning);
+  else if (key == "onnx_global_thread_pool") return parse_bool(value, onnx.use_global_thread_pool);
+  else if (key == "onnx_cache_dir") onnx.optimized_model_cache_dir = value;
+  else if (key == "onnx_share_weights") return parse_bool(value, onnx.share_model_weights);
+  else return false;
+  return true;
+}
+
 }  // namespace normitri::app
@@ -0,0 +1,239 @@
+#include <normitri/app/dynamic_batcher.hpp>
+#include <normitri/core/executor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <variant>
+
+namespace normitri::app {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// A unit's id and callback; points into DynamicBatcher::State::units, which never changes.
+using Unit = std::pair<const std::string, DefectResultCallback>;
+
+/// A prepared frame waiting for a batch; seq numbers accepted frames from 1, in order.
+struct Pending {
+  std::uint64_t seq;
+  const Unit* unit;
+  normitri::core::Frame frame;
+  Clock::time_point queued_at;
+};
+
+/// A frame that finished before the batch stage; delivered by the scheduler like the others.
+struct Early {
+  std::uint64_t seq;
+  const Unit* unit;
+  normitri::core::DefectResult result;
+};
+
+}  // namespace
+
+struct DynamicBatcher::State {
+  static constexpr std::uint64_t kNone = UINT64_MAX;
+
+  normitri::core::Pipeline* pipeline;
+  const std::unordered_map<std::string, DefectResultCallback> units;
+  DynamicBatcherOptions options;
+
+  mutable std::mutex mutex;
+  std::condition_variable wake;  // scheduler: frames queued, flush() or close()
+  std::condition_variable done;  // flush(): frames delivered
+  std::deque<Pending> pending;
+  std::vector<Early> early;
+  bool closed{false};
+  std::uint64_t last_seq{0};      // seq of the last frame placed in pending or early
+  std::uint64_t flush_target{0};  // batch pending frames up to this seq without waiting
+  std::uint64_t oldest_running{kNone};  // lowest seq the scheduler is delivering now
+  std::size_t preparing{0};       // submits between their two locks; the scheduler outlives them
+  DynamicBatcherStats stats;      // queued is filled in by stats()
+
+  std::jthread scheduler;
+
+  State(normitri::core::Pipeline& p, std::unordered_map<std::string, DefectResultCallback> u,
+        DynamicBatcherOptions o)
+      : pipeline(&p), units(std::move(u)), options(o) {
+    options.max_batch_size = std::max<std::size_t>(options.max_batch_size, 1);
+  }
+
+  static void deliver(const Unit& unit, normitri::core::DefectResult& result) {
+    result.camera_id = unit.first;
+    if (unit.second) unit.second(result);
+  }
+
+  /// Lowest seq not yet delivered (or failed in the batch stage); kNone if there is none.
+  /// pending and early are in seq order, as frames enter them under the lock.
+  std::uint64_t oldest_undelivered() const {
+    std::uint64_t oldest = oldest_running;
+    if (!pending.empty()) oldest = std::min(oldest, pending.front().seq);
+    if (!early.empty()) oldest = std::min(oldest, early.front().seq);
+    return oldest;
+  }
+
+  /// True once the scheduler should take a batch (or deliver early results) without waiting.
+  bool ready(Clock::time_point now) const {
+    if (!early.empty() || pending.size() >= options.max_batch_size) return true;
+    if (pending.empty()) return false;
+    return closed || pending.front().seq <= flush_target ||
+           now >= pending.front().queued_at + options.max_wait;
+  }
+
+  void run() {
+    std::vector<Pending> batch;
+    std::vector<Early> finished;
+    std::vector<normitri::core::Frame> frames;
+    for (;;) {
+      {
+        std::unique_lock lock(mutex);
+        for (;;) {
+          if (ready(Clock::now())) break;
+          if (closed && pending.empty() && preparing == 0) return;
+          if (pending.empty()) {
+            wake.wait(lock);
+          } else {
+            wake.wait_until(lock, pending.front().queued_at + options.max_wait);
+          }
+        }
+        finished.swap(early);
+        const std::size_t take = std::min(options.max_batch_size, pending.size());
+        oldest_running = std::min(finished.empty() ? kNone : finished.front().seq,
+                                  take > 0 ? pending.front().seq : kNone);
+        const auto started = Clock::now();
+        for (std::size_t k = 0; k < take; ++k) {
+          const auto wait_ns = static_cast<std::uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(started -
+                                                                   pending.front().queued_at)
+                  .count());
+          stats.total_wait_ns += wait_ns;
+          stats.max_wait_ns = std::max(stats.max_wait_ns, wait_ns);
+          batch.push_back(std::move(pending.front()));
+          pending.pop_front();
+        }
+        if (take > 0) {
+          ++stats.batches;
+          stats.batched_frames += take;
+          if (take == options.max_batch_size) {
+            ++stats.full_batches;
+          } else {
+            ++stats.deadline_batches;
+          }
+        }
+      }
+
+      for (Early& e : finished) deliver(*e.unit, e.result);
+      std::uint64_t failed = 0;
+      if (!batch.empty()) {
+        frames.clear();
+        for (Pending& p : batch) frames.push_back(std::move(p.frame));
+        auto results = pipeline->run_from_batch_stage(frames, 1);
+        for (std::size_t k = 0; k < batch.size(); ++k) {
+          if (k < results.size() && results[k]) {
+            deliver(*batch[k].unit, *results[k]);
+          } else {
+            ++failed;
+          }
+        }
+      }
+
+      {
+        std::lock_guard lock(mutex);
+        stats.failed += failed;
+        oldest_running = kNone;
+      }
+      done.notify_all();
+      finished.clear();
+      batch.clear();
+    }
+  }
+};
+
+DynamicBatcher::DynamicBatcher(normitri::core::Pipeline& pipeline,
+                               std::unordered_map<std::string, DefectResultCallback> callbacks,
+                               DynamicBatcherOptions options)
+    : state_(std::make_unique<State>(pipeline, std::move(callbacks), options)) {
+  state_->scheduler = std::jthread([state = state_.get()] { state->run(); });
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  close();
+  state_->scheduler.join();
+}
+
+bool DynamicBatcher::submit(const std::string& unit_id, const normitri::core::Frame& frame) {
+  State& s = *state_;
+  const auto unit = s.units.find(unit_id);
+  {
+    std::lock_guard lock(s.mutex);
+    if (s.closed || unit == s.units.end()) {
+      ++s.stats.rejected;
+      return false;
+    }
+    ++s.stats.submitted;
+    ++s.preparing;
+  }
+
+  auto prepared = s.pipeline->run_to_batch_stage(frame);
+  bool notify = true;
+  {
+    std::lock_guard lock(s.mutex);
+    --s.preparing;
+    if (!prepared) {
+      ++s.stats.failed;
+    } else if (auto* result = std::get_if<normitri::core::DefectResult>(&*prepared)) {
+      s.early.push_back(Early{++s.last_seq, &*unit, std::move(*result)});
+    } else {
+      s.pending.push_back(Pending{++s.last_seq, &*unit,
+                                 std::get<normitri::core::Frame>(std::move(*prepared)),
+                                 Clock::now()});
+      // The scheduler only needs waking when this frame can change its decision.
+      notify = s.closed || s.pending.size() == 1 || s.pending.size() >= s.options.max_batch_size;
+    }
+    notify = notify && (prepared.has_value() || s.closed);
+  }
+  if (notify) s.wake.notify_one();
+  return prepared.has_value();
+}
+
+std::size_t DynamicBatcher::submit(
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    std::size_t num_workers) {
+  std::atomic<std::size_t> accepted{0};
+  normitri::core::Executor::shared().parallel_for(work_items.size(), [&](std::size_t i) {
+    if (submit(work_items[i].first, work_items[i].second)) {
+      accepted.fetch_add(1, std::memory_order_relaxed);
+    }
+  }, num_workers);
+  return accepted.load();
+}
+
+void DynamicBatcher::flush() {
+  State& s = *state_;
+  std::unique_lock lock(s.mutex);
+  const std::uint64_t target = s.last_seq;
+  s.flush_target = std::max(s.flush_target, target);
+  s.wake.notify_one();
+  // Frames accepted later may be delivered first; wait for these ones by seq, not by count.
+  s.done.wait(lock, [&] { return s.oldest_undelivered() > target; });
+}
+
+void DynamicBatcher::close() {
+  {
+    std::lock_guard lock(state_->mutex);
+    state_->closed = true;
+  }
+  state_->wake.notify_one();
+}
+
+DynamicBatcherStats DynamicBatcher::stats() const {
+  std::lock_guard lock(state_->mutex);
+  DynamicBatcherStats s = state_->stats;
+  s.queued = state_->pending.size();
+  return s;
+}
+
+}  // namespace normitri::app
@@ -1,9 +1,10 @@
 #include <normitri/app/pipeline_runner.hpp>
+#include <normitri/core/reorder_ring.hpp>
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
-#include <mutex>
-#include <queue>
-#include <thread>
+#include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace normitri::app {
@@ -22,11 +23,47 @@ run_pipeline(normitri::core::Pipeline& pipeline,
   return result;
 }
 
+namespace {
+
+/// Runs frames in groups of batch_size through Pipeline::run_batch; callback in frame order.
+void run_in_batches(normitri::core::Pipeline& pipeline,
+                    const std::vector<normitri::core::Frame>& frames,
+                    const DefectResultCallback& callback,
+                    const std::vector<std::string>* camera_ids,
+                    const std::vector<std::string>* customer_ids,
+                    std::size_t batch_size,
+                    std::size_t num_workers,
+                    normitri::core::Executor* executor) {
+  const std::size_t n = frames.size();
+  const bool tag_camera = camera_ids && camera_ids->size() == n;
+  const bool tag_customer = customer_ids && customer_ids->size() == n;
+  const std::span<const normitri::core::Frame> all(frames);
+  for (std::size_t start = 0; start < n; start += batch_size) {
+    const std::size_t count = std::min(batch_size, n - start);
+    auto results = pipeline.run_batch(all.subspan(start, count), num_workers, executor);
+    for (std::size_t k = 0; k < count; ++k) {
+      auto& result = results[k];
+      if (!result || !callback) continue;
+      const std::size_t i = start + k;
+      if (tag_camera && !(*camera_ids)[i].empty()) result->camera_id = (*camera_ids)[i];
+      if (tag_customer && !(*customer_ids)[i].empty()) result->customer_id = (*customer_ids)[i];
+      callback(*result);
+    }
+  }
+}
+
+}  // namespace
+
 void run_pipeline_batch(normitri::core::Pipeline& pipeline,
                         const std::vector<normitri::core::Frame>& frames,
                         DefectResultCallback callback,
                         const std::vector<std::string>* camera_ids,
-                        const std::vector<std::string>* customer_ids) {
+                        const std::vector<std::string>* customer_ids,
+                        std::size_t batch_size) {
+  if (batch_size > 1) {
+    run_in_batches(pipeline, frames, callback, camera_ids, customer_ids, batch_size, 1, nullptr);
+    return;
+  }
   const std::size_t n = frames.size();
   const bool tag_camera = camera_ids && camera_ids->size() == n;
   const bool tag_customer = customer_ids && customer_ids->size() == n;
@@ -42,10 +79,94 @@ void run_pipeline_batch(normitri::core::Pipeline& pipeline,
 
 namespace {
 
-std::size_t effective_workers(std::size_t num_workers) {
-  if (num_workers > 0) return num_workers;
-  const unsigned hw = std::thread::hardware_concurrency();
-  return hw > 0 ? static_cast<std::size_t>(hw) : 1;
+using Result = std::expected<normitri::core::DefectResult, normitri::core::PipelineError>;
+
+/// The camera / customer ids for frame i's result; id vectors of the wrong size are ignored.
+class IdTags {
+ public:
+  IdTags(std::size_t n, const std::vector<std::string>* camera_ids,
+         const std::vector<std::string>* customer_ids)
+      : camera_ids_(camera_ids && camera_ids->size() == n ? camera_ids : nullptr),
+        customer_ids_(customer_ids && customer_ids->size() == n ? customer_ids : nullptr) {}
+
+  void apply(normitri::core::DefectResult& result, std::size_t i) const {
+    if (camera_ids_ && !(*camera_ids_)[i].empty()) result.camera_id = (*camera_ids_)[i];
+    if (customer_ids_ && !(*customer_ids_)[i].empty()) result.customer_id = (*customer_ids_)[i];
+  }
+
+ private:
+  const std::vector<std::string>* camera_ids_;
+  const std::vector<std::string>* customer_ids_;
+};
+
+/// Tags results with their frame's ids and hands them to the callback, either directly or, for
+/// DeliveryOrder::Input, through a reorder ring. deliver() may be called from any thread.
+class Delivery {
+ public:
+  Delivery(const DefectResultCallback& callback, std::size_t n,
+           const std::vector<std::string>* camera_ids,
+           const std::vector<std::string>* customer_ids, DeliveryOrder order,
+           std::size_t group)
+      : callback_(callback), tags_(n, camera_ids, customer_ids) {
+    if (order == DeliveryOrder::Input) {
+      ring_.emplace(std::max(kReorderWindow, 2 * group),
+                    [this](normitri::core::DefectResult& r) { callback_(r); });
+    }
+  }
+
+  void deliver(Result& result, std::size_t i) {
+    if (result) tags_.apply(*result, i);
+    if (ring_) {
+      ring_->push(i, result ? std::optional(std::move(*result)) : std::nullopt);
+    } else if (result) {
+      callback_(*result);
+    }
+  }
+
+ private:
+  const DefectResultCallback& callback_;
+  IdTags tags_;
+  std::optional<normitri::core::ReorderRing<normitri::core::DefectResult>> ring_;
+};
+
+/// Runs lane(next) on up to max_parallelism threads of \p executor (null = shared; 0 = all).
+/// Each lane claims frame indices from the shared counter until n is reached, so per-lane state
+/// (a ResultQueue::Writer, a replica lease) lives for many frames instead of one.
+template <typename Lane>
+void run_lanes(std::size_t n, normitri::core::Executor* executor, std::size_t max_parallelism,
+               const Lane& lane) {
+  if (n == 0) return;
+  normitri::core::Executor& pool = executor ? *executor : normitri::core::Executor::shared();
+  std::size_t lanes = pool.num_workers() + 1;
+  if (max_parallelism > 0) lanes = std::min(lanes, max_parallelism);
+  std::atomic<std::size_t> next{0};
+  pool.parallel_for(std::min(lanes, n), [&](std::size_t) { lane(next); }, max_parallelism);
+}
+
+/// run_pipeline_batch_parallel on \p executor, with at most \p max_parallelism threads (0 = all).
+void run_parallel(normitri::core::Pipeline& pipeline,
+                  const std::vector<normitri::core::Frame>& frames,
+                  const DefectResultCallback& callback,
+                  normitri::core::Executor& executor,
+                  std::size_t max_parallelism,
+                  const std::vector<std::string>* camera_ids,
+                  const std::vector<std::string>* customer_ids,
+                  std::size_t batch_size,
+                  DeliveryOrder order) {
+  const std::size_t n = frames.size();
+  if (n == 0 || !callback) return;
+
+  if (batch_size > 1) {  // already in frame order, on the calling thread
+    run_in_batches(pipeline, frames, callback, camera_ids, customer_ids, batch_size,
+                   max_parallelism, &executor);
+    return;
+  }
+
+  Delivery delivery(callback, n, camera_ids, customer_ids, order, 1);
+  executor.parallel_for(n, [&](std::size_t idx) {
+    auto result = pipeline.run(frames[idx]);
+    delivery.deliver(result, idx);
+  }, max_parallelism);
 }
 
 }  // namespace
@@ -56,62 +177,102 @@ void run_pipeline_batch_parallel(
     DefectResultCallback callback,
     std::size_t num_workers,
     const std::vector<std::string>* camera_ids,
-    const std::vector<std::string>* customer_ids) {
-  const std::size_t n = frames.size();
-  if (n == 0 || !callback) return;
+    const std::vector<std::string>* customer_ids,
+    std::size_t batch_size,
+    DeliveryOrder order) {
+  run_parallel(pipeline, frames, callback, normitri::core::Executor::shared(), num_workers,
+               camera_ids, customer_ids, batch_size, order);
+}
 
-  const std::size_t workers = std::min(effective_workers(num_workers), n);
-  if (workers <= 1) {
-    run_pipeline_batch(pipeline, frames, std::move(callback), camera_ids, customer_ids);
-    return;
-  }
+void run_pipeline_batch_parallel(
+    normitri::core::Pipeline& pipeline,
+    const std::vector<normitri::core::Frame>& frames,
+    DefectResultCallback callback,
+    normitri::core::Executor& executor,
+    const std::vector<std::string>* camera_ids,
+    const std::vector<std::string>* customer_ids,
+    std::size_t batch_size,
+    DeliveryOrder order) {
+  run_parallel(pipeline, frames, callback, executor, 0, camera_ids, customer_ids, batch_size,
+               order);
+}
 
-  const bool tag_camera = camera_ids && camera_ids->size() == n;
-  const bool tag_customer = customer_ids && customer_ids->size() == n;
+void run_pipeline_batch_parallel(
+    normitri::core::PipelineReplicas& replicas,
+    const std::vector<normitri::core::Frame>& frames,
+    DefectResultCallback callback,
+    std::size_t num_workers,
+    const std::vector<std::string>* camera_ids,
+    const std::vector<std::string>* customer_ids,
+    std::size_t batch_size,
+    normitri::core::Executor* executor,
+    DeliveryOrder order) {
+  const std::size_t n = frames.size();
+  if (n == 0 || !callback) return;
 
-  std::queue<std::size_t> index_queue;
-  for (std::size_t i = 0; i < n; ++i) {
-    index_queue.push(i);
-  }
+  // One task per group of batch_size frames (per frame when 1), each on its own replica.
+  const std::size_t group = std::max<std::size_t>(batch_size, 1);
+  const std::size_t groups = (n + group - 1) / group;
+  Delivery delivery(callback, n, camera_ids, customer_ids, order, group);
+  const std::span<const normitri::core::Frame> all(frames);
+  normitri::core::Executor& pool = executor ? *executor : normitri::core::Executor::shared();
+  pool.parallel_for(groups, [&](std::size_t g) {
+    const std::size_t start = g * group;
+    const std::size_t count = std::min(group, n - start);
+    auto replica = replicas.acquire();
+    if (count == 1) {
+      auto result = replica->run(frames[start]);
+      delivery.deliver(result, start);
+      return;
+    }
+    auto results = replica->run_batch(all.subspan(start, count), 1);
+    for (std::size_t k = 0; k < count; ++k) delivery.deliver(results[k], start + k);
+  }, num_workers);
+}
 
-  std::mutex queue_mutex;
-  std::condition_variable queue_cv;
-  std::atomic<bool> producer_done{false};
-
-  auto worker = [&]() {
-    while (true) {
-      std::size_t idx;
-      {
-        std::unique_lock lock(queue_mutex);
-        queue_cv.wait(lock, [&]() {
-          return producer_done.load() || !index_queue.empty();
-        });
-        if (producer_done.load() && index_queue.empty()) break;
-        if (index_queue.empty()) continue;
-        idx = index_queue.front();
-        index_queue.pop();
+void run_pipeline_batch_parallel(
+    normitri::core::Pipeline& pipeline,
+    const std::vector<normitri::core::Frame>& frames,
+    ResultQueue& sink,
+    std::size_t num_workers,
+    const std::vector<std::string>* camera_ids,
+    const std::vector<std::string>* customer_ids,
+    normitri::core::Executor* executor) {
+  const std::size_t n = frames.size();
+  const IdTags tags(n, camera_ids, customer_ids);
+  run_lanes(n, executor, num_workers, [&](std::atomic<std::size_t>& next) {
+    ResultQueue::Writer writer = sink.writer();
+    for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+      if (auto result = pipeline.run(frames[i])) {
+        tags.apply(*result, i);
+        writer.add(std::move(*result));
       }
+    }
+  });
+}
 
-      auto result = pipeline.run(frames[idx]);
-      if (result) {
-        if (tag_camera && !(*camera_ids)[idx].empty()) result->camera_id = (*camera_ids)[idx];
-        if (tag_customer && !(*customer_ids)[idx].empty()) result->customer_id = (*customer_ids)[idx];
-        callback(*result);
+void run_pipeline_batch_parallel(
+    normitri::core::PipelineReplicas& replicas,
+    const std::vector<normitri::core::Frame>& frames,
+    ResultQueue& sink,
+    std::size_t num_workers,
+    const std::vector<std::string>* camera_ids,
+    const std::vector<std::string>* customer_ids,
+    normitri::core::Executor* executor) {
+  const std::size_t n = frames.size();
+  const IdTags tags(n, camera_ids, customer_ids);
+  run_lanes(n, executor, num_workers, [&](std::atomic<std::size_t>& next) {
+    std::size_t i = next.fetch_add(1);
+    if (i >= n) return;  // nothing left: do not lease (or clone) a replica
+    auto replica = replicas.acquire();
+    ResultQueue::Writer writer = sink.writer();
+    for (; i < n; i = next.fetch_add(1)) {
+      if (auto result = replica->run(frames[i])) {
+        tags.apply(*result, i);
+        writer.add(std::move(*result));
       }
     }
-  };
-
-  producer_done = true;
-  std::vector<std::thread> threads;
-  threads.reserve(workers);
-  for (std::size_t i = 0; i < workers; ++i) {
-    threads.emplace_back(worker);
-  }
-  queue_cv.notify_all();
-
-  for (auto& t : threads) {
-    t.join();
-  }
+  });
 }
 
 }  // namespace normitri::app
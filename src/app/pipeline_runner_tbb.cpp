@@ -2,43 +2,285 @@
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/pipeline.hpp>
 #include <tbb/blocked_range.h>
+#include <tbb/concurrent_queue.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/info.h>
 #include <tbb/parallel_for.h>
+#include <tbb/parallel_pipeline.h>
+#include <tbb/task_group.h>
+#include <algorithm>
 #include <cstddef>
+#include <expected>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #ifdef NORMITRI_HAS_TBB
 
 namespace normitri::app {
 
-void run_pipeline_multi_camera_tbb(
-    const std::unordered_map<std::string, normitri::core::Pipeline*>& pipelines,
-    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
-    DefectResultCallbackWithUnitId callback) {
-  if (work_items.empty() || !callback) return;
+namespace {
+
+/// The work items that run on one pipeline, in work-item order, and the next one to run.
+struct Strand {
+  normitri::core::Pipeline* pipeline;
+  std::vector<std::size_t> items;
+  std::size_t next{0};
+};
+
+/// Runs each work item on its unit's pipeline and calls emit(result, unit_id) for each success,
+/// with result.camera_id set to unit_id.
+///
+/// Work items are grouped into one strand per pipeline (units sharing a pipeline share it). A
+/// strand is in the ready queue or held by one worker, never both, so a pipeline runs one frame
+/// at a time, in work-item order, without a lock around it. Workers take strands from the front
+/// of the queue, run one frame and put the strand back at the end, so units take turns: a unit
+/// with many frames delays another by at most one frame per turn.
+template <typename Emit>
+void run_units(const std::unordered_map<std::string, normitri::core::Pipeline*>& pipelines,
+               const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+               const Emit& emit) {
+  std::vector<Strand> strands;
+  std::unordered_map<normitri::core::Pipeline*, std::size_t> strand_of;
+  for (std::size_t i = 0; i < work_items.size(); ++i) {
+    auto it = pipelines.find(work_items[i].first);
+    if (it == pipelines.end() || it->second == nullptr) continue;
+    auto [slot, added] = strand_of.try_emplace(it->second, strands.size());
+    if (added) strands.push_back(Strand{it->second, {}});
+    strands[slot->second].items.push_back(i);
+  }
+  if (strands.empty()) return;
 
+  tbb::concurrent_queue<Strand*> ready;
+  for (Strand& strand : strands) ready.push(&strand);
+  // A worker leaves once the queue is empty: every strand left is then held by another worker,
+  // which keeps taking strands until none are left.
+  const auto worker = [&ready, &work_items, &emit] {
+    Strand* strand = nullptr;
+    while (ready.try_pop(strand)) {
+      const std::size_t i = strand->items[strand->next++];
+      const std::string& unit_id = work_items[i].first;
+      auto result = strand->pipeline->run(work_items[i].second);
+      if (result) {
+        result->camera_id = unit_id;
+        emit(*result, unit_id);
+      }
+      // Requeued only after emit, so a unit's results are also emitted one at a time, in order.
+      if (strand->next < strand->items.size()) ready.push(strand);
+    }
+  };
+  const std::size_t workers =
+      std::min(strands.size(), static_cast<std::size_t>(tbb::info::default_concurrency()));
+  tbb::task_group group;
+  for (std::size_t w = 0; w < workers; ++w) group.run(worker);
+  group.wait();
+}
+
+/// As run_units, on per-thread replicas.
+template <typename Emit>
+void run_unit_replicas(
+    const std::unordered_map<std::string, normitri::core::PipelineReplicas*>& replicas,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    const Emit& emit) {
+  // Each thread keeps the replica it leased for a unit until the call ends, so a replica is
+  // acquired once per thread and unit, not once per frame, and is never shared between threads.
+  using Leases = std::unordered_map<normitri::core::PipelineReplicas*,
+                                    normitri::core::PipelineReplicas::Lease>;
+  tbb::enumerable_thread_specific<Leases> leases;
   const std::size_t n = work_items.size();
   tbb::parallel_for(
       tbb::blocked_range<std::size_t>(0, n),
-      [&pipelines, &work_items, &callback](const tbb::blocked_range<std::size_t>& range) {
+      [&replicas, &work_items, &emit, &leases](const tbb::blocked_range<std::size_t>& range) {
+        Leases& local = leases.local();
         for (std::size_t i = range.begin(); i != range.end(); ++i) {
           const std::string& unit_id = work_items[i].first;
-          const normitri::core::Frame& frame = work_items[i].second;
-          auto it = pipelines.find(unit_id);
-          if (it == pipelines.end()) continue;
-          normitri::core::Pipeline* pipeline = it->second;
-          auto result = pipeline->run(frame);
+          auto it = replicas.find(unit_id);
+          if (it == replicas.end() || it->second == nullptr) continue;
+          auto lease = local.find(it->second);
+          if (lease == local.end()) {
+            lease = local.emplace(it->second, it->second->acquire()).first;
+          }
+          auto result = lease->second->run(work_items[i].second);
           if (result) {
             result->camera_id = unit_id;
-            callback(*result, unit_id);
+            emit(*result, unit_id);
           }
         }
       });
 }
 
+/// One ResultQueue::Writer per TBB thread; flush_all() hands the rest to the queue.
+class ThreadWriters {
+ public:
+  explicit ThreadWriters(ResultQueue& sink) : writers_([&sink] { return sink.writer(); }) {}
+
+  void add(normitri::core::DefectResult& result) { writers_.local().add(std::move(result)); }
+
+  void flush_all() {
+    for (ResultQueue::Writer& writer : writers_) writer.flush();
+  }
+
+ private:
+  tbb::enumerable_thread_specific<ResultQueue::Writer> writers_;
+};
+
+/// A frame in flight through run_lane(): its position in the lane, the latest intermediate
+/// frame, and the outcome once a stage has finished it early or failed (later stages pass it on
+/// untouched).
+struct Token {
+  std::size_t index;
+  normitri::core::Frame frame;
+  std::optional<std::expected<normitri::core::DefectResult, normitri::core::PipelineError>> done;
+};
+
+/// Runs \p frames through \p pipeline as a parallel_pipeline, one filter per stage, and calls
+/// emit(result, k) for the success of frames[k], in frame order.
+template <typename Emit>
+void run_lane(normitri::core::Pipeline& pipeline,
+              const std::vector<const normitri::core::Frame*>& frames,
+              PipelinedTbbOptions options, const Emit& emit) {
+  using normitri::core::DefectResult;
+  using normitri::core::Frame;
+  const std::size_t stages = pipeline.stage_count();
+  std::size_t tokens = options.max_tokens;
+  if (tokens == 0) {
+    tokens = std::max(static_cast<std::size_t>(tbb::info::default_concurrency()), stages);
+  }
+
+  // Token k lives in in_flight[k] from the input filter to the sink, so tokens still in flight
+  // when a stage or emit throws (and TBB cancels the pipeline) are freed on the way out. The
+  // input and sink filters are serial and touch different slots; the vector never reallocates.
+  std::vector<std::unique_ptr<Token>> in_flight(frames.size());
+  std::size_t next = 0;
+  auto chain = tbb::make_filter<void, Token*>(
+      tbb::filter_mode::serial_in_order,
+      [&frames, &next, &in_flight](tbb::flow_control& fc) -> Token* {
+        if (next == frames.size()) {
+          fc.stop();
+          return nullptr;
+        }
+        in_flight[next] = std::make_unique<Token>(Token{next, *frames[next], std::nullopt});
+        return in_flight[next++].get();
+      });
+  for (std::size_t i = 0; i < stages; ++i) {
+    const auto mode = pipeline.stage(i).stateless() ? tbb::filter_mode::parallel
+                                                    : tbb::filter_mode::serial_in_order;
+    chain = chain & tbb::make_filter<Token*, Token*>(mode, [&pipeline, i](Token* token) {
+      if (token->done) return token;
+      auto out = pipeline.run_stages(i, i + 1, token->frame);
+      if (!out) {
+        token->done = std::unexpected(out.error());
+      } else if (auto* result = std::get_if<DefectResult>(&*out)) {
+        token->done = std::move(*result);
+      } else {
+        token->frame = std::get<Frame>(std::move(*out));
+      }
+      return token;
+    });
+  }
+  // A frame that passes every stage without a DefectResult is an error, as in Pipeline::run().
+  auto sink = tbb::make_filter<Token*, void>(
+      tbb::filter_mode::serial_in_order, [&emit, &in_flight](Token* raw) {
+        const std::unique_ptr<Token> token = std::move(in_flight[raw->index]);
+        if (token->done && *token->done) emit(**token->done, token->index);
+      });
+  tbb::parallel_pipeline(tokens, chain & sink);
+}
+
+}  // namespace
+
+void run_pipeline_pipelined_tbb(normitri::core::Pipeline& pipeline,
+                                const std::vector<normitri::core::Frame>& frames,
+                                DefectResultCallback callback, PipelinedTbbOptions options) {
+  if (frames.empty() || !callback) return;
+  std::vector<const normitri::core::Frame*> lane;
+  lane.reserve(frames.size());
+  for (const normitri::core::Frame& frame : frames) lane.push_back(&frame);
+  run_lane(pipeline, lane, options,
+           [&callback](const normitri::core::DefectResult& r, std::size_t) { callback(r); });
+}
+
+void run_pipeline_multi_camera_pipelined_tbb(
+    const std::unordered_map<std::string, normitri::core::Pipeline*>& pipelines,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    DefectResultCallbackWithUnitId callback, PipelinedTbbOptions options) {
+  if (work_items.empty() || !callback) return;
+  // One lane per pipeline, as run_units() keeps one strand per pipeline: units sharing a
+  // pipeline share its lane, so its serial stages are never entered by two lanes at once.
+  struct Lane {
+    normitri::core::Pipeline* pipeline;
+    std::vector<const normitri::core::Frame*> frames;
+    std::vector<const std::string*> unit_ids;
+  };
+  std::vector<Lane> lanes;
+  std::unordered_map<normitri::core::Pipeline*, std::size_t> lane_of;
+  for (const auto& [unit_id, frame] : work_items) {
+    auto it = pipelines.find(unit_id);
+    if (it == pipelines.end() || it->second == nullptr) continue;
+    auto [slot, added] = lane_of.try_emplace(it->second, lanes.size());
+    if (added) lanes.push_back(Lane{it->second, {}, {}});
+    lanes[slot->second].frames.push_back(&frame);
+    lanes[slot->second].unit_ids.push_back(&unit_id);
+  }
+  tbb::task_group group;
+  for (const Lane& lane : lanes) {
+    group.run([&lane, &options, &callback] {
+      run_lane(*lane.pipeline, lane.frames, options,
+               [&lane, &callback](normitri::core::DefectResult& r, std::size_t k) {
+                 const std::string& unit_id = *lane.unit_ids[k];
+                 r.camera_id = unit_id;
+                 callback(r, unit_id);
+               });
+    });
+  }
+  group.wait();
+}
+
+void run_pipeline_multi_camera_tbb(
+    const std::unordered_map<std::string, normitri::core::Pipeline*>& pipelines,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    DefectResultCallbackWithUnitId callback) {
+  if (work_items.empty() || !callback) return;
+  run_units(pipelines, work_items, callback);
+}
+
+void run_pipeline_multi_camera_tbb(
+    const std::unordered_map<std::string, normitri::core::PipelineReplicas*>& replicas,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    DefectResultCallbackWithUnitId callback) {
+  if (work_items.empty() || !callback) return;
+  run_unit_replicas(replicas, work_items, callback);
+}
+
+void run_pipeline_multi_camera_tbb(
+    const std::unordered_map<std::string, normitri::core::Pipeline*>& pipelines,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    ResultQueue& sink) {
+  if (work_items.empty()) return;
+  ThreadWriters writers(sink);
+  run_units(pipelines, work_items,
+            [&writers](normitri::core::DefectResult& r, const std::string&) { writers.add(r); });
+  writers.flush_all();
+}
+
+void run_pipeline_multi_camera_tbb(
+    const std::unordered_map<std::string, normitri::core::PipelineReplicas*>& replicas,
+    const std::vector<std::pair<std::string, normitri::core::Frame>>& work_items,
+    ResultQueue& sink) {
+  if (work_items.empty()) return;
+  ThreadWriters writers(sink);
+  run_unit_replicas(replicas, work_items,
+                    [&writers](normitri::core::DefectResult& r, const std::string&) {
+                      writers.add(r);
+                    });
+  writers.flush_all();
+}
+
 }  // namespace normitri::app
 
 #endif  // NORMITRI_HAS_TBB
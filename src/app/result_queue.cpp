@@ -0,0 +1,55 @@
+#include <normitri/app/result_queue.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace normitri::app {
+
+void ResultQueue::Writer::add(normitri::core::DefectResult result) {
+  if (buffer_.empty()) buffer_.reserve(queue_->flush_size());
+  buffer_.push_back(std::move(result));
+  if (buffer_.size() >= queue_->flush_size()) flush();
+}
+
+void ResultQueue::Writer::flush() {
+  if (buffer_.empty()) return;
+  queue_->push(std::move(buffer_));
+  buffer_ = {};
+}
+
+ResultQueue::ResultQueue(std::size_t flush_size)
+    : flush_size_(std::max<std::size_t>(flush_size, 1)) {}
+
+void ResultQueue::push(std::vector<normitri::core::DefectResult> batch) {
+  if (batch.empty()) return;
+  batches_.push(std::move(batch));
+  pushed_.fetch_add(1);
+  signal_.fetch_add(1);
+  signal_.notify_one();
+}
+
+std::size_t ResultQueue::drain(const DefectResultBatchCallback& fn) {
+  std::size_t results = 0;
+  while (auto batch = batches_.pop()) {
+    ++popped_;
+    results += batch->size();
+    if (fn) fn(std::span<const normitri::core::DefectResult>(*batch));
+  }
+  return results;
+}
+
+bool ResultQueue::wait() {
+  for (;;) {
+    const std::uint64_t seen = signal_.load();
+    if (pushed_.load() > popped_) return true;
+    if (closed_.load()) return false;
+    signal_.wait(seen);
+  }
+}
+
+void ResultQueue::close() {
+  closed_.store(true);
+  signal_.fetch_add(1);
+  signal_.notify_all();
+}
+
+}  // namespace normitri::app
@@ -0,0 +1,203 @@
+#include <normitri/app/streaming_runner.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace normitri::app {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// One submitted frame and where its result goes (a promise or a callback).
+struct Job {
+  normitri::core::Frame frame;
+  std::string camera_id;
+  std::string customer_id;
+  std::optional<std::promise<StreamingResult>> promise;
+  StreamingCallback callback;
+  Clock::time_point queued_at;
+
+  void complete(const StreamingResult& result) {
+    if (promise) {
+      promise->set_value(result);
+    } else if (callback) {
+      callback(result);
+    }
+  }
+};
+
+}  // namespace
+
+struct StreamingRunner::State {
+  normitri::core::Pipeline* pipeline{nullptr};  // shared by the workers, or
+  std::vector<normitri::core::PipelineReplicas::Lease> leases;  // one replica per worker
+  StreamingRunnerOptions options;
+
+  mutable std::mutex mutex;
+  std::condition_variable not_empty;  // workers wait for frames
+  std::condition_variable not_full;   // Block producers wait for room
+  std::condition_variable idle;       // wait_idle()
+  std::deque<Job> queue;
+  bool closed{false};
+  StreamingStats stats;  // queue_depth is filled in by stats()
+
+  std::vector<std::jthread> workers;
+
+  void start() {
+    workers.reserve(options.num_workers);
+    for (std::size_t w = 0; w < options.num_workers; ++w) {
+      normitri::core::Pipeline& p = leases.empty() ? *pipeline : *leases[w];
+      workers.emplace_back([this, &p] { work(p); });
+    }
+  }
+
+  /// Queues \p job or drops a frame per the overflow policy; returns false if \p job was dropped.
+  bool enqueue(Job job) {
+    job.queued_at = Clock::now();
+    std::optional<Job> dropped;
+    bool queued = false;
+    {
+      std::unique_lock lock(mutex);
+      ++stats.submitted;
+      const std::size_t depth = options.queue_depth;
+      auto same_camera = queue.end();
+      if (options.overflow == OverflowPolicy::LatestPerCamera) {
+        same_camera = std::find_if(queue.begin(), queue.end(), [&](const Job& queued_job) {
+          return queued_job.camera_id == job.camera_id;
+        });
+      }
+      if (options.overflow == OverflowPolicy::Block && !closed && queue.size() >= depth) {
+        ++stats.blocked;
+        not_full.wait(lock, [&] { return closed || queue.size() < depth; });
+      }
+      if (closed) {
+        dropped = std::move(job);
+      } else if (same_camera != queue.end()) {
+        dropped = std::exchange(*same_camera, std::move(job));
+        queued = true;
+      } else if (queue.size() < depth) {
+        queue.push_back(std::move(job));
+        queued = true;
+      } else if (options.overflow == OverflowPolicy::DropNewest) {
+        dropped = std::move(job);
+      } else {  // DropOldest, LatestPerCamera
+        dropped = std::move(queue.front());
+        queue.pop_front();
+        queue.push_back(std::move(job));
+        queued = true;
+      }
+      if (dropped) ++stats.dropped;
+      stats.max_queue_depth = std::max(stats.max_queue_depth, queue.size());
+    }
+    if (queued) not_empty.notify_one();
+    if (dropped) dropped->complete(std::unexpected(normitri::core::PipelineError::Dropped));
+    return !dropped || queued;
+  }
+
+  void work(normitri::core::Pipeline& pipeline_to_run) {
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock lock(mutex);
+        not_empty.wait(lock, [&] { return closed || !queue.empty(); });
+        if (queue.empty()) return;  // closed and drained
+        job = std::move(queue.front());
+        queue.pop_front();
+        ++stats.in_flight;
+        const auto waited = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - job.queued_at)
+                .count());
+        stats.total_queue_wait_ns += waited;
+        stats.max_queue_wait_ns = std::max(stats.max_queue_wait_ns, waited);
+      }
+      not_full.notify_one();
+
+      StreamingResult result = pipeline_to_run.run(job.frame);
+      if (result) {
+        if (!job.camera_id.empty()) result->camera_id = job.camera_id;
+        if (!job.customer_id.empty()) result->customer_id = job.customer_id;
+      }
+      job.complete(result);
+
+      std::lock_guard lock(mutex);
+      --stats.in_flight;
+      ++stats.completed;
+      if (!result) ++stats.failed;
+      if (queue.empty() && stats.in_flight == 0) idle.notify_all();
+    }
+  }
+};
+
+StreamingRunner::StreamingRunner(normitri::core::Pipeline& pipeline,
+                                 StreamingRunnerOptions options)
+    : state_(std::make_unique<State>()) {
+  state_->pipeline = &pipeline;
+  state_->options = options;
+  state_->options.queue_depth = std::max<std::size_t>(options.queue_depth, 1);
+  state_->options.num_workers = std::max<std::size_t>(options.num_workers, 1);
+  state_->start();
+}
+
+StreamingRunner::StreamingRunner(normitri::core::PipelineReplicas& replicas,
+                                 StreamingRunnerOptions options)
+    : state_(std::make_unique<State>()) {
+  state_->options = options;
+  state_->options.queue_depth = std::max<std::size_t>(options.queue_depth, 1);
+  state_->options.num_workers = std::max<std::size_t>(options.num_workers, 1);
+  // Leased before any worker starts, so a failing clone throws from here.
+  state_->leases.reserve(state_->options.num_workers);
+  for (std::size_t w = 0; w < state_->options.num_workers; ++w) {
+    state_->leases.push_back(replicas.acquire());
+  }
+  state_->start();
+}
+
+StreamingRunner::~StreamingRunner() {
+  close();
+  state_->workers.clear();  // joins once the queue is drained
+}
+
+std::future<StreamingResult> StreamingRunner::submit(normitri::core::Frame frame,
+                                                     std::string camera_id,
+                                                     std::string customer_id) {
+  Job job{std::move(frame), std::move(camera_id), std::move(customer_id), {}, {}, {}};
+  std::future<StreamingResult> future = job.promise.emplace().get_future();
+  (void)state_->enqueue(std::move(job));
+  return future;
+}
+
+bool StreamingRunner::submit(normitri::core::Frame frame, StreamingCallback callback,
+                             std::string camera_id, std::string customer_id) {
+  return state_->enqueue(Job{std::move(frame), std::move(camera_id), std::move(customer_id), {},
+                             std::move(callback), {}});
+}
+
+void StreamingRunner::close() {
+  {
+    std::lock_guard lock(state_->mutex);
+    state_->closed = true;
+  }
+  state_->not_empty.notify_all();
+  state_->not_full.notify_all();
+}
+
+void StreamingRunner::wait_idle() {
+  std::unique_lock lock(state_->mutex);
+  state_->idle.wait(lock, [&] { return state_->queue.empty() && state_->stats.in_flight == 0; });
+}
+
+StreamingStats StreamingRunner::stats() const {
+  std::lock_guard lock(state_->mutex);
+  StreamingStats s = state_->stats;
+  s.queue_depth = state_->queue.size();
+  return s;
+}
+
+}  // namespace normitri::app
@@ -0,0 +1,137 @@
+#include <normitri/core/buffer_pool.hpp>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace normitri::core {
+
+namespace {
+
+constexpr std::size_t kMinBucket = 256;
+constexpr std::align_val_t kAlignment{64};
+
+std::byte* allocate_block(std::size_t bytes) {
+  return static_cast<std::byte*>(::operator new(bytes, kAlignment));
+}
+
+void free_block(std::byte* block) noexcept { ::operator delete(block, kAlignment); }
+
+}  // namespace
+
+struct BufferPool::State {
+  explicit State(std::size_t max_cached) : max_cached_bytes(max_cached) {}
+
+  ~State() {
+    for (auto& [bucket, blocks] : free_lists) {
+      for (std::byte* block : blocks) free_block(block);
+    }
+  }
+
+  State(const State&) = delete;
+  State& operator=(const State&) = delete;
+
+  void release(std::byte* block, std::size_t bucket) noexcept {
+    {
+      std::lock_guard lock(mutex);
+      if (!closed && cached_bytes + bucket <= max_cached_bytes) {
+        try {
+          free_lists[bucket].push_back(block);
+          cached_bytes += bucket;
+          returns.fetch_add(1, std::memory_order_relaxed);
+          return;
+        } catch (...) {
+          // Could not grow the free list; fall through and free the block.
+        }
+      }
+    }
+    discards.fetch_add(1, std::memory_order_relaxed);
+    free_block(block);
+  }
+
+  mutable std::mutex mutex;
+  std::unordered_map<std::size_t, std::vector<std::byte*>> free_lists;
+  std::size_t cached_bytes{0};
+  std::size_t max_cached_bytes;
+  bool closed{false};
+
+  std::atomic<std::uint64_t> hits{0};
+  std::atomic<std::uint64_t> misses{0};
+  std::atomic<std::uint64_t> returns{0};
+  std::atomic<std::uint64_t> discards{0};
+};
+
+BufferPool::BufferPool(std::size_t max_cached_bytes)
+    : state_(std::make_shared<State>(max_cached_bytes)) {}
+
+BufferPool::~BufferPool() {
+  trim();
+  // Blocks still in use keep the state alive through their deleters and are freed on release.
+  std::lock_guard lock(state_->mutex);
+  state_->closed = true;
+}
+
+std::size_t BufferPool::bucket_size(std::size_t size) noexcept {
+  if (size <= kMinBucket) return kMinBucket;
+  // Four size classes per power of two: (1.25, 1.5, 1.75, 2) x 2^(k-1).
+  const std::size_t base = std::size_t{1} << (std::bit_width(size - 1) - 1);
+  const std::size_t step = base / 4;
+  return (size + step - 1) / step * step;
+}
+
+std::shared_ptr<std::byte> BufferPool::acquire(std::size_t size) {
+  if (size == 0) return nullptr;
+  const std::size_t bucket = bucket_size(size);
+
+  std::byte* block = nullptr;
+  {
+    std::lock_guard lock(state_->mutex);
+    auto it = state_->free_lists.find(bucket);
+    if (it != state_->free_lists.end() && !it->second.empty()) {
+      block = it->second.back();
+      it->second.pop_back();
+      state_->cached_bytes -= bucket;
+    }
+  }
+  if (block) {
+    state_->hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    state_->misses.fetch_add(1, std::memory_order_relaxed);
+    block = allocate_block(bucket);
+  }
+
+  // The deleter holds the state, so a block released after the pool is gone is simply freed.
+  return std::shared_ptr<std::byte>(
+      block, [state = state_, bucket](std::byte* p) noexcept { state->release(p, bucket); });
+}
+
+BufferPoolStats BufferPool::stats() const {
+  BufferPoolStats s;
+  s.hits = state_->hits.load(std::memory_order_relaxed);
+  s.misses = state_->misses.load(std::memory_order_relaxed);
+  s.returns = state_->returns.load(std::memory_order_relaxed);
+  s.discards = state_->discards.load(std::memory_order_relaxed);
+  std::lock_guard lock(state_->mutex);
+  s.cached_bytes = state_->cached_bytes;
+  return s;
+}
+
+void BufferPool::trim() {
+  std::vector<std::byte*> to_free;
+  {
+    std::lock_guard lock(state_->mutex);
+    for (auto& [bucket, blocks] : state_->free_lists) {
+      to_free.insert(to_free.end(), blocks.begin(), blocks.end());
+      state_->discards.fetch_add(blocks.size(), std::memory_order_relaxed);
+      blocks.clear();
+    }
+    state_->cached_bytes = 0;
+  }
+  for (std::byte* block : to_free) free_block(block);
+}
+
+}  // namespace normitri::core
@@ -0,0 +1,169 @@
+#include <normitri/core/compact_defect.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace normitri::core {
+
+namespace {
+
+InternedString intern_optional(const std::optional<std::string>& s) {
+  return s ? InternedString(*s) : InternedString{};
+}
+
+std::optional<std::string> optional_of(InternedString s) {
+  return s.empty() ? std::nullopt : std::optional<std::string>(s.str());
+}
+
+}  // namespace
+
+CompactDefect CompactDefect::from(const Defect& defect) {
+  CompactDefect d;
+  d.bbox = defect.bbox;
+  d.confidence = defect.confidence;
+  d.category = intern_optional(defect.category);
+  d.kind = defect.kind;
+  d.has_product_id = defect.product_id.has_value();
+  d.product_id = defect.product_id.value_or(0);
+  return d;
+}
+
+Defect CompactDefect::to_defect() const {
+  Defect d;
+  d.kind = kind;
+  d.bbox = bbox;
+  d.confidence = confidence;
+  if (has_product_id) d.product_id = product_id;
+  d.category = optional_of(category);
+  return d;
+}
+
+CompactDefectResult CompactDefectResult::from(const DefectResult& result) {
+  CompactDefectResult r;
+  r.frame_id = result.frame_id;
+  r.defects.reserve(result.defects.size());
+  for (const Defect& d : result.defects) r.defects.push_back(CompactDefect::from(d));
+  r.camera_id = intern_optional(result.camera_id);
+  r.customer_id = intern_optional(result.customer_id);
+  r.metadata = result.metadata;
+  return r;
+}
+
+DefectResult CompactDefectResult::to_result() const {
+  DefectResult r;
+  r.frame_id = frame_id;
+  r.defects.reserve(defects.size());
+  for (const CompactDefect& d : defects) r.defects.push_back(d.to_defect());
+  r.metadata = metadata;
+  r.camera_id = optional_of(camera_id);
+  r.customer_id = optional_of(customer_id);
+  return r;
+}
+
+void DefectBatch::begin_frame(std::uint64_t frame_id, InternedString camera_id,
+                              InternedString customer_id, std::string_view metadata) {
+  if (frame_ids_.size() >= UINT32_MAX) {
+    throw std::length_error("DefectBatch: too many frames");
+  }
+  frame_ids_.push_back(frame_id);
+  camera_ids_.push_back(camera_id);
+  customer_ids_.push_back(customer_id);
+  metadata_chars_.append(metadata);
+  metadata_offsets_.push_back(metadata_chars_.size());
+}
+
+void DefectBatch::append_defect(const CompactDefect& d, std::uint32_t frame) {
+  kinds_.push_back(d.kind);
+  x_.push_back(d.bbox.x);
+  y_.push_back(d.bbox.y);
+  w_.push_back(d.bbox.w);
+  h_.push_back(d.bbox.h);
+  confidences_.push_back(d.confidence);
+  product_ids_.push_back(d.has_product_id ? d.product_id : 0);
+  has_product_id_.push_back(d.has_product_id ? 1 : 0);
+  categories_.push_back(d.category);
+  frame_index_.push_back(frame);
+}
+
+void DefectBatch::append(const CompactDefectResult& result) {
+  if (size() + result.defects.size() > UINT32_MAX) {
+    throw std::length_error("DefectBatch: too many defects");
+  }
+  const auto frame = static_cast<std::uint32_t>(frames());
+  begin_frame(result.frame_id, result.camera_id, result.customer_id, result.metadata);
+  for (const CompactDefect& d : result.defects) append_defect(d, frame);
+  frame_offsets_.push_back(static_cast<std::uint32_t>(size()));
+}
+
+void DefectBatch::append(const DefectResult& result) {
+  if (size() + result.defects.size() > UINT32_MAX) {
+    throw std::length_error("DefectBatch: too many defects");
+  }
+  const auto frame = static_cast<std::uint32_t>(frames());
+  begin_frame(result.frame_id, intern_optional(result.camera_id),
+              intern_optional(result.customer_id), result.metadata);
+  for (const Defect& d : result.defects) append_defect(CompactDefect::from(d), frame);
+  frame_offsets_.push_back(static_cast<std::uint32_t>(size()));
+}
+
+void DefectBatch::reserve(std::size_t frames, std::size_t defects) {
+  kinds_.reserve(defects);
+  x_.reserve(defects);
+  y_.reserve(defects);
+  w_.reserve(defects);
+  h_.reserve(defects);
+  confidences_.reserve(defects);
+  product_ids_.reserve(defects);
+  has_product_id_.reserve(defects);
+  categories_.reserve(defects);
+  frame_index_.reserve(defects);
+  frame_ids_.reserve(frames);
+  camera_ids_.reserve(frames);
+  customer_ids_.reserve(frames);
+  metadata_offsets_.reserve(frames + 1);
+  frame_offsets_.reserve(frames + 1);
+}
+
+void DefectBatch::clear() noexcept {
+  kinds_.clear();
+  x_.clear();
+  y_.clear();
+  w_.clear();
+  h_.clear();
+  confidences_.clear();
+  product_ids_.clear();
+  has_product_id_.clear();
+  categories_.clear();
+  frame_index_.clear();
+  frame_ids_.clear();
+  camera_ids_.clear();
+  customer_ids_.clear();
+  metadata_chars_.clear();
+  metadata_offsets_.assign(1, 0);
+  frame_offsets_.assign(1, 0);
+}
+
+CompactDefect DefectBatch::defect(std::size_t i) const {
+  CompactDefect d;
+  d.kind = kinds_[i];
+  d.bbox = {x_[i], y_[i], w_[i], h_[i]};
+  d.confidence = confidences_[i];
+  d.product_id = product_ids_[i];
+  d.has_product_id = has_product_id_[i] != 0;
+  d.category = categories_[i];
+  return d;
+}
+
+CompactDefectResult DefectBatch::result(std::size_t f) const {
+  CompactDefectResult r;
+  r.frame_id = frame_ids_[f];
+  r.camera_id = camera_ids_[f];
+  r.customer_id = customer_ids_[f];
+  r.metadata = metadata(f);
+  r.defects.reserve(frame_offsets_[f + 1] - frame_offsets_[f]);
+  for (std::size_t i = frame_offsets_[f]; i < frame_offsets_[f + 1]; ++i) {
+    r.defects.push_back(defect(i));
+  }
+  return r;
+}
+
+}  // namespace normitri::core
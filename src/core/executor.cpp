@@ -0,0 +1,234 @@
+#include <normitri/core/executor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace normitri::core {
+
+namespace {
+
+using Task = std::function<void()>;
+
+/// One worker's deque. The lock is held only to push or pop one task, so contention stays
+/// between the owner and an occasional thief.
+struct alignas(64) WorkerQueue {
+  std::mutex mutex;
+  std::deque<Task> tasks;
+};
+
+void pin_current_thread(int cpu) {
+#if defined(__linux__)
+  if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(static_cast<std::size_t>(cpu), &set);
+  (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
+
+}  // namespace
+
+struct Executor::State {
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+  std::vector<std::jthread> threads;
+
+  std::atomic<std::size_t> queued{0};      // tasks sitting in any deque
+  std::atomic<std::size_t> next_queue{0};  // round-robin target for outside submissions
+  std::atomic<std::uint64_t> tasks_run{0};
+  std::atomic<std::uint64_t> steals{0};
+
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  std::atomic<std::size_t> sleeping{0};
+  bool stop{false};  // guarded by sleep_mutex
+
+  /// Executor the calling thread works for (null outside any pool) and its worker index.
+  static thread_local const State* t_owner;
+  static thread_local std::size_t t_index;
+
+  void push(Task task) {
+    std::size_t q = 0;
+    if (t_owner == this) {
+      q = t_index;
+    } else {
+      q = next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    }
+    queued.fetch_add(1);  // before the push, so a thief never sees the count go negative
+    {
+      std::lock_guard lock(queues[q]->mutex);
+      queues[q]->tasks.push_back(std::move(task));
+    }
+    if (sleeping.load() > 0) {
+      std::lock_guard lock(sleep_mutex);  // orders the notify after a sleeper's predicate check
+      wake.notify_one();
+    }
+  }
+
+  bool pop_own(std::size_t w, Task& task) {
+    WorkerQueue& q = *queues[w];
+    std::lock_guard lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    task = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    return true;
+  }
+
+  bool steal(std::size_t w, Task& task) {
+    for (std::size_t k = 1; k < queues.size(); ++k) {
+      WorkerQueue& q = *queues[(w + k) % queues.size()];
+      std::lock_guard lock(q.mutex);
+      if (q.tasks.empty()) continue;
+      task = std::move(q.tasks.front());
+      q.tasks.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  void worker_loop(std::size_t w) {
+    t_owner = this;
+    t_index = w;
+    for (;;) {
+      Task task;
+      bool found = pop_own(w, task);
+      if (!found && steal(w, task)) {
+        found = true;
+        steals.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (found) {
+        queued.fetch_sub(1);
+        task();
+        tasks_run.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      std::unique_lock lock(sleep_mutex);
+      sleeping.fetch_add(1);
+      wake.wait(lock, [&] { return stop || queued.load() > 0; });
+      sleeping.fetch_sub(1);
+      if (stop && queued.load() == 0) return;
+    }
+  }
+};
+
+thread_local const Executor::State* Executor::State::t_owner = nullptr;
+thread_local std::size_t Executor::State::t_index = 0;
+
+Executor::Executor(ExecutorOptions options) : state_(std::make_unique<State>()) {
+  std::size_t workers = options.num_workers;
+  if (workers == 0) {
+    const unsigned hw = std::thread::hardware_concurrency();
+    workers = hw > 1 ? static_cast<std::size_t>(hw) - 1 : 1;
+  }
+  state_->queues.reserve(workers);
+  for (std::size_t w = 0; w < workers; ++w) {
+    state_->queues.push_back(std::make_unique<WorkerQueue>());
+  }
+  state_->threads.reserve(workers);
+  for (std::size_t w = 0; w < workers; ++w) {
+    const int cpu = options.cpu_affinity.empty()
+                        ? -1
+                        : options.cpu_affinity[w % options.cpu_affinity.size()];
+    state_->threads.emplace_back([state = state_.get(), w, cpu] {
+      if (cpu >= 0) pin_current_thread(cpu);
+      state->worker_loop(w);
+    });
+  }
+}
+
+Executor::~Executor() {
+  {
+    std::lock_guard lock(state_->sleep_mutex);
+    state_->stop = true;
+  }
+  state_->wake.notify_all();
+  state_->threads.clear();  // joins
+}
+
+void Executor::submit(std::function<void()> task) { state_->push(std::move(task)); }
+
+void Executor::parallel_for(std::size_t n, const std::function<void(std::size_t)>& fn,
+                            std::size_t max_parallelism) {
+  std::size_t helpers = num_workers();
+  if (max_parallelism > 0) helpers = std::min(helpers, max_parallelism - 1);
+  helpers = std::min(helpers, n > 0 ? n - 1 : 0);
+  if (helpers == 0) {
+    for (std::size_t i = 0; i < n; ++i) fn(i);
+    return;
+  }
+
+  // Shared with the helper tasks, which may start after this call has returned (they then find
+  // the loop closed and exit), so it is reference-counted.
+  struct Loop {
+    const std::function<void(std::size_t)>* fn;
+    std::size_t n;
+    std::atomic<std::size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t active{0};  // helpers inside run(); guarded by mutex
+    bool closed{false};     // guarded by mutex; set once the caller stops waiting for newcomers
+    std::exception_ptr error;
+
+    void run() {
+      for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+        try {
+          (*fn)(i);
+        } catch (...) {
+          next.store(n);  // skip the rest
+          std::lock_guard lock(mutex);
+          if (!error) error = std::current_exception();
+        }
+      }
+    }
+  };
+  auto loop = std::make_shared<Loop>();
+  loop->fn = &fn;
+  loop->n = n;
+  for (std::size_t h = 0; h < helpers; ++h) {
+    submit([loop] {
+      {
+        std::lock_guard lock(loop->mutex);
+        if (loop->closed) return;
+        ++loop->active;
+      }
+      loop->run();
+      {
+        std::lock_guard lock(loop->mutex);
+        --loop->active;
+      }
+      loop->done.notify_all();
+    });
+  }
+  loop->run();
+  std::unique_lock lock(loop->mutex);
+  loop->closed = true;
+  loop->done.wait(lock, [&] { return loop->active == 0; });
+  if (loop->error) std::rethrow_exception(loop->error);
+}
+
+std::size_t Executor::num_workers() const noexcept { return state_->queues.size(); }
+
+ExecutorStats Executor::stats() const noexcept {
+  ExecutorStats s;
+  s.tasks_run = state_->tasks_run.load(std::memory_order_relaxed);
+  s.steals = state_->steals.load(std::memory_order_relaxed);
+  return s;
+}
+
+Executor& Executor::shared() {
+  static Executor executor;
+  return executor;
+}
+
+}  // namespace normitri::core
@@ -1,27 +1,160 @@
 #include <normitri/core/frame.hpp>
+#include <normitri/core/buffer_pool.hpp>
 #include <cstddef>
+#include <utility>
 
 namespace normitri::core {
 
+Frame::Frame(std::uint32_t width,
+             std::uint32_t height,
+             PixelFormat format,
+             std::vector<std::byte> buffer)
+    : width_(width), height_(height), format_(format),
+      element_type_(default_element_type(format)) {
+  adopt(std::move(buffer));
+}
+
+Frame::Frame(std::uint32_t width,
+             std::uint32_t height,
+             PixelFormat format,
+             std::shared_ptr<const std::byte> buffer,
+             std::size_t size_bytes)
+    : width_(width),
+      height_(height),
+      format_(format),
+      element_type_(default_element_type(format)),
+      buffer_(std::move(buffer)),
+      size_(buffer_ ? size_bytes : 0),
+      capacity_(size_) {}
+
+Frame::Frame(Frame&& other) noexcept
+    : width_(std::exchange(other.width_, 0)),
+      height_(std::exchange(other.height_, 0)),
+      format_(std::exchange(other.format_, PixelFormat::Unknown)),
+      layout_(std::exchange(other.layout_, TensorLayout::HWC)),
+      element_type_(std::exchange(other.element_type_, ElementType::UInt8)),
+      buffer_(std::move(other.buffer_)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      writable_(std::exchange(other.writable_, false)),
+      pooled_(std::exchange(other.pooled_, false)) {}
+
+Frame& Frame::operator=(Frame&& other) noexcept {
+  if (this != &other) {
+    width_ = std::exchange(other.width_, 0);
+    height_ = std::exchange(other.height_, 0);
+    format_ = std::exchange(other.format_, PixelFormat::Unknown);
+    layout_ = std::exchange(other.layout_, TensorLayout::HWC);
+    element_type_ = std::exchange(other.element_type_, ElementType::UInt8);
+    buffer_ = std::move(other.buffer_);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+    writable_ = std::exchange(other.writable_, false);
+    pooled_ = std::exchange(other.pooled_, false);
+  }
+  return *this;
+}
+
+Frame Frame::view(std::uint32_t width,
+                  std::uint32_t height,
+                  PixelFormat format,
+                  std::span<const std::byte> data) {
+  // Aliasing constructor with an empty owner: non-null pointer, no control block.
+  std::shared_ptr<const std::byte> borrowed(std::shared_ptr<const std::byte>{}, data.data());
+  return Frame(width, height, format, std::move(borrowed), data.size());
+}
+
+Frame Frame::allocate(std::uint32_t width,
+                      std::uint32_t height,
+                      PixelFormat format,
+                      std::size_t size_bytes,
+                      BufferPool* pool) {
+  Frame frame;
+  frame.width_ = width;
+  frame.height_ = height;
+  frame.format_ = format;
+  frame.element_type_ = default_element_type(format);
+  if (size_bytes == 0) return frame;
+  if (pool) {
+    frame.buffer_ = pool->acquire(size_bytes);
+    frame.capacity_ = BufferPool::bucket_size(size_bytes);
+    frame.pooled_ = true;
+  } else {
+    std::shared_ptr<std::byte[]> storage = std::make_unique_for_overwrite<std::byte[]>(size_bytes);
+    frame.buffer_ = std::shared_ptr<const std::byte>(storage, storage.get());
+    frame.capacity_ = size_bytes;
+  }
+  frame.size_ = size_bytes;
+  frame.writable_ = true;
+  return frame;
+}
+
+std::span<std::byte> Frame::prepare(std::uint32_t width,
+                                    std::uint32_t height,
+                                    PixelFormat format,
+                                    std::size_t size_bytes,
+                                    BufferPool* pool) {
+  const bool reusable = writable_ && buffer_.use_count() == 1 && capacity_ >= size_bytes;
+  if (reusable && size_bytes != 0) {
+    width_ = width;
+    height_ = height;
+    format_ = format;
+    layout_ = TensorLayout::HWC;
+    element_type_ = default_element_type(format);
+    size_ = size_bytes;
+  } else {
+    *this = allocate(width, height, format, size_bytes, pool);
+  }
+  return data();
+}
+
+std::span<std::byte> Frame::data() {
+  if (size_ == 0) return {};
+  if (!writable_ || buffer_.use_count() != 1) {
+    adopt(std::vector<std::byte>(buffer_.get(), buffer_.get() + size_));
+  }
+  // Safe: writable_ means buffer_ points to non-const storage that this frame alone refers to.
+  return std::span<std::byte>(const_cast<std::byte*>(buffer_.get()), size_);
+}
+
+void Frame::adopt(std::vector<std::byte> buffer) {
+  if (buffer.empty()) {
+    buffer_.reset();
+    size_ = 0;
+    capacity_ = 0;
+    writable_ = false;
+    pooled_ = false;
+    return;
+  }
+  auto storage = std::make_shared<std::vector<std::byte>>(std::move(buffer));
+  size_ = storage->size();
+  capacity_ = size_;
+  buffer_ = std::shared_ptr<const std::byte>(storage, storage->data());
+  writable_ = true;
+  pooled_ = false;
+}
+
+std::array<std::uint32_t, 3> Frame::shape() const noexcept {
+  const std::uint32_t channels = channel_count(format_);
+  if (layout_ == TensorLayout::CHW) return {channels, height_, width_};
+  return {height_, width_, channels};
+}
+
 std::size_t Frame::min_bytes(std::uint32_t width,
                               std::uint32_t height,
                               PixelFormat format) {
-  const std::size_t pixels = static_cast<std::size_t>(width) * height;
-  switch (format) {
-    case PixelFormat::Grayscale8:
-      return pixels;
-    case PixelFormat::RGB8:
-    case PixelFormat::BGR8:
-      return pixels * 3;
-    case PixelFormat::RGBA8:
-    case PixelFormat::BGRA8:
-      return pixels * 4;
-    case PixelFormat::Float32Planar:
-      return pixels * 3 * sizeof(float);  // CHW, 3 channels
-    case PixelFormat::Unknown:
-    default:
-      return 0;
-  }
+  return min_bytes(width, height, format, default_element_type(format));
+}
+
+std::size_t Frame::min_bytes(std::uint32_t width,
+                              std::uint32_t height,
+                              PixelFormat format,
+                              ElementType type) {
+  return static_cast<std::size_t>(width) * height * channel_count(format) * element_size(type);
+}
+
+std::size_t Frame::min_bytes() const noexcept {
+  return min_bytes(width_, height_, format_, element_type_);
 }
 
 }  // namespace normitri::core
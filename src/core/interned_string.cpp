@@ -0,0 +1,74 @@
+#include <normitri/core/interned_string.hpp>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace normitri::core {
+
+namespace {
+
+// Strings are stored in fixed chunks that never move, so view() can index them without the
+// lock: a handle only reaches another thread after interning finished (through whatever hands
+// the handle over), and a chunk pointer is written once, before the first handle into it.
+constexpr std::size_t kChunkSize = 1024;
+constexpr std::size_t kMaxChunks = 4096;  // 4M distinct strings
+
+struct InternTable {
+  std::shared_mutex mutex;
+  std::unordered_map<std::string_view, std::uint32_t> ids;  // keys view the stored strings
+  std::array<std::unique_ptr<std::string[]>, kMaxChunks> chunks;
+  std::atomic<std::size_t> count{0};  // stored strings; id n is string n - 1
+};
+
+InternTable& table() {
+  static InternTable t;
+  return t;
+}
+
+}  // namespace
+
+InternedString::InternedString(std::string_view s) {
+  if (s.empty()) return;
+  InternTable& t = table();
+  {
+    std::shared_lock lock(t.mutex);
+    if (auto it = t.ids.find(s); it != t.ids.end()) {
+      id_ = it->second;
+      return;
+    }
+  }
+  std::unique_lock lock(t.mutex);
+  if (auto it = t.ids.find(s); it != t.ids.end()) {
+    id_ = it->second;
+    return;
+  }
+  const std::size_t index = t.count.load(std::memory_order_relaxed);
+  const std::size_t chunk = index / kChunkSize;
+  if (chunk >= kMaxChunks) {
+    throw std::length_error("InternedString: intern table is full");
+  }
+  if (!t.chunks[chunk]) {
+    t.chunks[chunk] = std::make_unique<std::string[]>(kChunkSize);
+  }
+  std::string& stored = t.chunks[chunk][index % kChunkSize];
+  stored.assign(s);
+  id_ = static_cast<std::uint32_t>(index + 1);
+  t.ids.emplace(stored, id_);
+  t.count.store(index + 1, std::memory_order_release);
+}
+
+std::string_view InternedString::view() const noexcept {
+  if (id_ == 0) return {};
+  const std::size_t index = id_ - 1;
+  return table().chunks[index / kChunkSize][index % kChunkSize];
+}
+
+std::size_t interned_string_count() noexcept {
+  return table().count.load(std::memory_order_acquire);
+}
+
+}  // namespace normitri::core
@@ -1,45 +1,245 @@
 #include <normitri/core/pipeline.hpp>
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
 
 namespace normitri::core {
 
+namespace {
+
+/// Per-thread ping-pong frames for stages that implement process_into(). Thread-local rather than
+/// per-pipeline so that concurrent run() calls stay safe; heap buffers are kept across calls and
+/// only grow, so steady-state runs reuse them. Pooled buffers go back to their BufferPool when
+/// the run ends (see PooledScratchRelease). depth guards against a stage running a nested pipeline.
+thread_local std::array<Frame, 2> t_scratch;
+thread_local int t_run_depth = 0;
+
+struct RunDepthGuard {
+  RunDepthGuard() { ++t_run_depth; }
+  ~RunDepthGuard() { --t_run_depth; }
+  RunDepthGuard(const RunDepthGuard&) = delete;
+  RunDepthGuard& operator=(const RunDepthGuard&) = delete;
+};
+
+/// Drops pool-backed scratch frames when the outermost run on this thread ends, so their blocks
+/// return to the pool instead of staying pinned by an idle thread for the rest of the process.
+/// The next run gets them back from the pool's free list.
+struct PooledScratchRelease {
+  PooledScratchRelease() = default;
+  ~PooledScratchRelease() {
+    if (t_run_depth != 1) return;
+    for (Frame& frame : t_scratch) {
+      if (frame.is_pooled()) frame = Frame{};
+    }
+  }
+  PooledScratchRelease(const PooledScratchRelease&) = delete;
+  PooledScratchRelease& operator=(const PooledScratchRelease&) = delete;
+};
+
+}  // namespace
+
 void Pipeline::add_stage(std::unique_ptr<IPipelineStage> stage) {
   if (stage) {
     stages_.push_back(std::move(stage));
   }
 }
 
+void Pipeline::release_thread_scratch() noexcept {
+  if (t_run_depth != 0) return;  // a run on this thread is using them
+  t_scratch = {};
+}
+
+std::expected<Pipeline, PipelineError> Pipeline::clone() const {
+  Pipeline replica;
+  replica.stages_.reserve(stages_.size());
+  for (const auto& stage : stages_) {
+    auto copy = stage->clone();
+    if (!copy) {
+      return std::unexpected(PipelineError::InvalidConfig);
+    }
+    replica.stages_.push_back(std::move(copy));
+  }
+  return replica;
+}
+
 std::expected<DefectResult, PipelineError> Pipeline::run(
     const Frame& input,
     StageTimingCallback* timing_cb) {
-  std::variant<Frame, DefectResult> current = input;
+  auto result = run_range(0, stages_.size(), input, nullptr, timing_cb);
+  if (!result) {
+    return std::unexpected(result.error());
+  }
+  if (!*result) {
+    return std::unexpected(PipelineError::InvalidConfig);
+  }
+  return std::move(**result);
+}
+
+std::expected<std::optional<DefectResult>, PipelineError> Pipeline::run_range(
+    std::size_t first,
+    std::size_t last,
+    const Frame& input,
+    Frame* out,
+    StageTimingCallback* timing_cb) {
+  RunDepthGuard depth_guard;
+  std::array<Frame, 2> nested_scratch;
+  std::array<Frame, 2>& scratch = t_run_depth == 1 ? t_scratch : nested_scratch;
+  std::size_t next_scratch = 0;
+  const PooledScratchRelease release_pooled_scratch;
 
-  for (std::size_t i = 0; i < stages_.size(); ++i) {
-    const Frame* frame_ptr = std::get_if<Frame>(&current);
-    if (!frame_ptr) {
-      return std::get<DefectResult>(current);
-    }
+  // current never aliases scratch[next_scratch], so process_into() never writes its own input.
+  const Frame* current = &input;
+  Frame owned;  // result of the last process() stage that returned a Frame
 
+  for (std::size_t i = first; i < last; ++i) {
+    IPipelineStage& stage = *stages_[i];
     const auto stage_start = std::chrono::steady_clock::now();
-    auto result = stages_[i]->process(*frame_ptr);
-    if (timing_cb) {
+    const auto report_timing = [&]() {
+      if (!timing_cb) return;
       const auto stage_end = std::chrono::steady_clock::now();
       const double ms = 1e-6 * static_cast<double>(
           std::chrono::duration_cast<std::chrono::microseconds>(stage_end - stage_start).count());
       (*timing_cb)(i, ms);
+    };
+
+    if (stage.supports_process_into()) {
+      Frame& into = scratch[next_scratch];
+      auto written = stage.process_into(*current, into);
+      report_timing();
+      if (!written) {
+        return std::unexpected(written.error());
+      }
+      if (*written == StageIntoResult::Written) {
+        current = &into;
+        next_scratch ^= 1u;
+      }
+      continue;
     }
 
+    auto result = stage.process(*current);
+    report_timing();
     if (!result) {
       return std::unexpected(result.error());
     }
+    if (auto* defects = std::get_if<DefectResult>(&*result)) {
+      return std::optional<DefectResult>{std::move(*defects)};
+    }
+    owned = std::get<Frame>(std::move(*result));
+    current = &owned;
+  }
+
+  if (out) {
+    if (current == &input) {
+      *out = input;
+    } else {
+      // Hand the buffer over; the next run() on this thread allocates a fresh scratch frame.
+      *out = std::move(current == &owned ? owned : scratch[next_scratch ^ 1u]);
+    }
+  }
+  return std::optional<DefectResult>{};
+}
+
+std::size_t Pipeline::batch_stage() const noexcept {
+  std::size_t i = 0;
+  while (i < stages_.size() && !stages_[i]->supports_batch()) ++i;
+  return i;
+}
 
-    current = std::move(*result);
+std::expected<StageOutput, PipelineError> Pipeline::run_stages(std::size_t first,
+                                                              std::size_t last,
+                                                              const Frame& input) {
+  Frame prepared;
+  auto result = run_range(first, std::min(last, stages_.size()), input, &prepared, nullptr);
+  if (!result) {
+    return std::unexpected(result.error());
   }
+  if (*result) {
+    return StageOutput{std::move(**result)};
+  }
+  return StageOutput{std::move(prepared)};
+}
 
-  if (const auto* result = std::get_if<DefectResult>(&current)) {
-    return *result;
+std::vector<std::expected<DefectResult, PipelineError>> Pipeline::run_batch(
+    std::span<const Frame> inputs,
+    std::size_t num_workers,
+    Executor* executor) {
+  // Copies share buffers; no pixel copy.
+  return run_batch_from(0, std::vector<Frame>(inputs.begin(), inputs.end()), num_workers,
+                        executor);
+}
+
+std::vector<std::expected<DefectResult, PipelineError>> Pipeline::run_from_batch_stage(
+    std::span<const Frame> prepared,
+    std::size_t num_workers,
+    Executor* executor) {
+  return run_batch_from(batch_stage(), std::vector<Frame>(prepared.begin(), prepared.end()),
+                        num_workers, executor);
+}
+
+std::vector<std::expected<DefectResult, PipelineError>> Pipeline::run_batch_from(
+    std::size_t first,
+    std::vector<Frame> frames,
+    std::size_t num_workers,
+    Executor* executor) {
+  const std::size_t n = frames.size();
+  Executor& pool = executor ? *executor : Executor::shared();
+  // Frames that pass every stage without a DefectResult keep InvalidConfig, as in run().
+  std::vector<std::expected<DefectResult, PipelineError>> results(
+      n, std::unexpected(PipelineError::InvalidConfig));
+  std::vector<std::uint8_t> finished(n, 0);
+  std::vector<std::size_t> live(n);  // indices of frames still in flight, in input order
+  for (std::size_t i = 0; i < n; ++i) live[i] = i;
+
+  const auto finish = [&](std::size_t idx, std::expected<DefectResult, PipelineError> result) {
+    results[idx] = std::move(result);
+    finished[idx] = 1;
+  };
+  const auto drop_finished = [&]() {
+    std::erase_if(live, [&](std::size_t idx) { return finished[idx] != 0; });
+  };
+
+  while (!live.empty() && first < stages_.size()) {
+    std::size_t batch_at = first;
+    while (batch_at < stages_.size() && !stages_[batch_at]->supports_batch()) ++batch_at;
+
+    if (batch_at > first) {
+      pool.parallel_for(live.size(), [&](std::size_t k) {
+        const std::size_t idx = live[k];
+        Frame next;
+        auto result = run_range(first, batch_at, frames[idx], &next, nullptr);
+        if (!result) {
+          finish(idx, std::unexpected(result.error()));
+        } else if (*result) {
+          finish(idx, std::move(**result));
+        } else {
+          frames[idx] = std::move(next);
+        }
+      }, num_workers);
+      drop_finished();
+    }
+    if (batch_at == stages_.size() || live.empty()) break;
+
+    std::vector<Frame> batch;
+    batch.reserve(live.size());
+    for (std::size_t idx : live) batch.push_back(std::move(frames[idx]));
+    auto outputs = stages_[batch_at]->process_batch(batch);
+    for (std::size_t k = 0; k < live.size(); ++k) {
+      const std::size_t idx = live[k];
+      if (k >= outputs.size()) {
+        finish(idx, std::unexpected(PipelineError::InvalidConfig));
+      } else if (!outputs[k]) {
+        finish(idx, std::unexpected(outputs[k].error()));
+      } else if (auto* defects = std::get_if<DefectResult>(&*outputs[k])) {
+        finish(idx, std::move(*defects));
+      } else {
+        frames[idx] = std::get<Frame>(std::move(*outputs[k]));
+      }
+    }
+    drop_finished();
+    first = batch_at + 1;
   }
-  return std::unexpected(PipelineError::InvalidConfig);
+  return results;
 }
 
 }  // namespace normitri::core
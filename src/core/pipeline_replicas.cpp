@@ -0,0 +1,76 @@
+#include <normitri/core/pipeline_replicas.hpp>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace normitri::core {
+
+struct PipelineReplicas::State {
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<Pipeline>> replicas;
+  std::vector<Pipeline*> idle;
+};
+
+PipelineReplicas::Lease::Lease(Lease&& other) noexcept
+    : owner_(std::exchange(other.owner_, nullptr)),
+      pipeline_(std::exchange(other.pipeline_, nullptr)) {}
+
+PipelineReplicas::Lease& PipelineReplicas::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    if (owner_) owner_->give_back(pipeline_);
+    owner_ = std::exchange(other.owner_, nullptr);
+    pipeline_ = std::exchange(other.pipeline_, nullptr);
+  }
+  return *this;
+}
+
+PipelineReplicas::Lease::~Lease() {
+  if (owner_) owner_->give_back(pipeline_);
+}
+
+PipelineReplicas::PipelineReplicas(Pipeline prototype)
+    : prototype_(std::move(prototype)), state_(std::make_unique<State>()) {
+  auto first = prototype_.clone();
+  if (!first) {
+    throw std::invalid_argument("PipelineReplicas: every stage must support clone()");
+  }
+  state_->replicas.push_back(std::make_unique<Pipeline>(std::move(*first)));
+  state_->idle.push_back(state_->replicas.back().get());
+}
+
+PipelineReplicas::~PipelineReplicas() = default;
+
+PipelineReplicas::Lease PipelineReplicas::acquire() {
+  {
+    std::lock_guard lock(state_->mutex);
+    if (!state_->idle.empty()) {
+      Pipeline* pipeline = state_->idle.back();
+      state_->idle.pop_back();
+      return Lease(this, pipeline);
+    }
+  }
+  // Cloning may be slow (e.g. device buffers), so it runs outside the lock.
+  auto replica = prototype_.clone();
+  if (!replica) {
+    throw std::runtime_error("PipelineReplicas: clone failed");
+  }
+  auto owned = std::make_unique<Pipeline>(std::move(*replica));
+  Pipeline* pipeline = owned.get();
+  std::lock_guard lock(state_->mutex);
+  state_->replicas.push_back(std::move(owned));
+  state_->idle.reserve(state_->replicas.size());  // so give_back never allocates
+  return Lease(this, pipeline);
+}
+
+std::size_t PipelineReplicas::size() const {
+  std::lock_guard lock(state_->mutex);
+  return state_->replicas.size();
+}
+
+void PipelineReplicas::give_back(Pipeline* pipeline) noexcept {
+  std::lock_guard lock(state_->mutex);
+  state_->idle.push_back(pipeline);
+}
+
+}  // namespace normitri::core
@@ -3,16 +3,30 @@
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
 #include <opencv2/imgproc.hpp>
-#include <vector>
 
 namespace normitri::vision {
 
 ColorConvertStage::ColorConvertStage(
-    normitri::core::PixelFormat output_format)
-    : output_format_(output_format) {}
+    normitri::core::PixelFormat output_format,
+    std::shared_ptr<normitri::core::BufferPool> pool)
+    : output_format_(output_format), pool_(std::move(pool)) {}
 
 std::expected<normitri::core::StageOutput, normitri::core::PipelineError>
 ColorConvertStage::process(const normitri::core::Frame& input) {
+  normitri::core::Frame out;
+  auto written = process_into(input, out);
+  if (!written) {
+    return std::unexpected(written.error());
+  }
+  if (*written == normitri::core::StageIntoResult::PassThrough) {
+    return normitri::core::StageOutput{input};  // shares the buffer; no pixel copy
+  }
+  return normitri::core::StageOutput{std::move(out)};
+}
+
+std::expected<normitri::core::StageIntoResult, normitri::core::PipelineError>
+ColorConvertStage::process_into(const normitri::core::Frame& input,
+                                normitri::core::Frame& output) {
   if (input.empty()) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
@@ -25,12 +39,9 @@ ColorConvertStage::process(const normitri::core::Frame& input) {
   }
 
   if (input.format() == output_format_) {
-    std::vector<std::byte> buf(input.data().begin(), input.data().end());
-    return StageOutput{
-        Frame(input.width(), input.height(), output_format_, std::move(buf))};
+    return StageIntoResult::PassThrough;
   }
 
-  cv::Mat mat_out;
   int code = -1;
   if (input.format() == PixelFormat::BGR8 && output_format_ == PixelFormat::RGB8) {
     code = cv::COLOR_BGR2RGB;
@@ -51,14 +62,18 @@ ColorConvertStage::process(const normitri::core::Frame& input) {
   }
 
   if (code >= 0) {
+    const std::size_t out_bytes =
+        Frame::min_bytes(input.width(), input.height(), output_format_);
+    const int out_channels = static_cast<int>(out_bytes / mat_in->total());
+    output.prepare(input.width(), input.height(), output_format_, out_bytes, pool_.get());
+    cv::Mat mat_out = detail::frame_mat(output, CV_8UC(out_channels));
     cv::cvtColor(*mat_in, mat_out, code);
-    Frame out = detail::mat_to_frame(mat_out, output_format_);
-    return StageOutput{std::move(out)};
+    return StageIntoResult::Written;
   }
 
-  std::vector<std::byte> buffer(input.data().begin(), input.data().end());
-  return StageOutput{
-      Frame(input.width(), input.height(), output_format_, std::move(buffer))};
+  output = Frame(input.width(), input.height(), output_format_, input.buffer(),
+                 input.size_bytes());
+  return StageIntoResult::Written;
 }
 
 }  // namespace normitri::vision
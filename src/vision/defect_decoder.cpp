@@ -1,48 +1,187 @@
 #include <normitri/vision/defect_decoder.hpp>
 #include <normitri/core/defect.hpp>
+#include <normitri/vision/simd_kernels.hpp>
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace normitri::vision {
 
+namespace {
+
+/// One candidate as it is sorted: the key fields inline, so the sort touches one array.
+struct Candidate {
+  std::int64_t cls;
+  float score;
+  std::uint32_t index;
+};
+
+/// Per-thread NMS buffers, grown to the largest candidate count seen and then reused.
+struct NmsScratch {
+  std::vector<Candidate> candidates;
+  std::vector<float> x1, y1, x2, y2, area;
+  std::vector<std::uint32_t> suppressed;
+  std::vector<std::uint32_t> kept;  // positions into candidates, then detection indices
+};
+
+/// Higher score first; ties keep model order so results are deterministic.
+bool higher_score(const Candidate& a, const Candidate& b) noexcept {
+  return a.score != b.score ? a.score > b.score : a.index < b.index;
+}
+
+}  // namespace
+
 DefectDecoder::DefectDecoder(float confidence_threshold,
-                             ClassToDefectKindMap class_to_kind)
+                             ClassToDefectKindMap class_to_kind,
+                             NmsOptions nms)
     : confidence_threshold_(confidence_threshold),
-      class_to_kind_(std::move(class_to_kind)) {}
+      class_to_kind_(std::move(class_to_kind)),
+      nms_(nms) {}
 
 std::vector<normitri::core::Defect> DefectDecoder::decode(
     const InferenceResult& result) const {
+  return decode(DetectionView::of(result));
+}
+
+std::vector<normitri::core::Defect> DefectDecoder::decode(
+    const DetectionView& detections) const {
   std::vector<normitri::core::Defect> out;
-  const std::size_t n = static_cast<std::size_t>(result.num_detections);
+  const std::size_t n = detections.count;
+  if (n == 0) {
+    return out;
+  }
+
+  // Indices of the detections at or above the threshold; reused across calls on this thread.
+  thread_local std::vector<std::uint32_t> selected;
+  if (selected.size() < n) {
+    selected.resize(n);
+  }
+  const std::size_t kept = simd::simd_kernels().select_at_least(
+      detections.scores, n, detections.score_stride, confidence_threshold_, selected.data());
+
+  if (!nms_.enabled()) {
+    out.reserve(kept);
+    for (std::size_t k = 0; k < kept; ++k) emit(detections, selected[k], out);
+    return out;
+  }
+  const auto ranked = suppress(detections, selected.data(), kept);
+  out.reserve(ranked.size());
+  for (std::uint32_t i : ranked) emit(detections, i, out);
+  return out;
+}
+
+void DefectDecoder::emit(const DetectionView& detections, std::size_t i,
+                         std::vector<normitri::core::Defect>& out) const {
   const std::size_t max_class =
       class_to_kind_.empty() ? 0 : class_to_kind_.size() - 1;
+  normitri::core::Defect d;
+  d.confidence = detections.score(i);
+  d.kind = normitri::core::DefectKind::ProcessError;
+  if (detections.has_class_id(i)) {
+    const auto cid = detections.class_id(i);
+    if (cid >= 0) {
+      d.product_id = static_cast<std::uint64_t>(cid);
+      if (static_cast<std::size_t>(cid) <= max_class) {
+        d.kind = class_to_kind_[static_cast<std::size_t>(cid)];
+      }
+    }
+  }
+  if (detections.has_box(i)) {
+    d.bbox.x = detections.box(i, 0);
+    d.bbox.y = detections.box(i, 1);
+    d.bbox.w = detections.box(i, 2) - d.bbox.x;
+    d.bbox.h = detections.box(i, 3) - d.bbox.y;
+  }
+  out.push_back(std::move(d));
+}
+
+std::span<const std::uint32_t> DefectDecoder::suppress(const DetectionView& detections,
+                                                       const std::uint32_t* selected,
+                                                       std::size_t count) const {
+  thread_local NmsScratch s;
+  const bool by_class = nms_.class_aware && detections.has_class_ids();
+
+  s.candidates.clear();
+  for (std::size_t k = 0; k < count; ++k) {
+    const std::uint32_t i = selected[k];
+    const float score = detections.score(i);
+    if (std::isnan(score)) continue;
+    // Detections without a class id share group -1; like negative ids they decode to
+    // ProcessError.
+    std::int64_t cls = 0;
+    if (by_class) cls = detections.has_class_id(i) ? detections.class_id(i) : -1;
+    s.candidates.push_back({cls, score, i});
+  }
+  auto& c = s.candidates;
+  if (nms_.top_k > 0 && c.size() > nms_.top_k) {
+    const auto top = c.begin() + static_cast<std::ptrdiff_t>(nms_.top_k);
+    std::nth_element(c.begin(), top, c.end(), higher_score);
+    c.erase(top, c.end());
+  }
+  // Grouped by class (a single group when class-agnostic), each group by descending score.
+  std::ranges::sort(c, [](const Candidate& a, const Candidate& b) {
+    return a.cls != b.cls ? a.cls < b.cls : higher_score(a, b);
+  });
 
-  for (std::size_t i = 0; i < n; ++i) {
-    const float score =
-        i < result.scores.size() ? result.scores[i] : 0.f;
-    if (score < confidence_threshold_) {
-      continue;
+  const std::size_t n = c.size();
+  for (auto* v : {&s.x1, &s.y1, &s.x2, &s.y2, &s.area}) v->resize(n);
+  s.suppressed.assign(n, 0u);
+  for (std::size_t p = 0; p < n; ++p) {
+    const std::size_t i = c[p].index;
+    if (detections.has_box(i)) {
+      s.x1[p] = std::min(detections.box(i, 0), detections.box(i, 2));
+      s.y1[p] = std::min(detections.box(i, 1), detections.box(i, 3));
+      s.x2[p] = std::max(detections.box(i, 0), detections.box(i, 2));
+      s.y2[p] = std::max(detections.box(i, 1), detections.box(i, 3));
+    } else {
+      s.x1[p] = s.y1[p] = s.x2[p] = s.y2[p] = 0.f;  // no boxes: nothing overlaps
     }
+    s.area[p] = (s.x2[p] - s.x1[p]) * (s.y2[p] - s.y1[p]);
+  }
 
-    normitri::core::Defect d;
-    d.confidence = score;
-    d.kind = normitri::core::DefectKind::ProcessError;
-    if (i < result.class_ids.size()) {
-      const auto cid = result.class_ids[i];
-      if (cid >= 0) {
-        d.product_id = static_cast<std::uint64_t>(cid);
-        if (static_cast<std::size_t>(cid) <= max_class) {
-          d.kind = class_to_kind_[static_cast<std::size_t>(cid)];
-        }
+  // Greedy NMS per class group. A group never contributes more than max_detections.
+  const simd::BoxesSoA boxes{s.x1.data(), s.y1.data(), s.x2.data(), s.y2.data(), s.area.data()};
+  const auto& kernels = simd::simd_kernels();
+  const bool suppressing = nms_.iou_threshold < 1.f;
+  s.kept.clear();
+  for (std::size_t begin = 0; begin < n;) {
+    std::size_t end = begin + 1;
+    while (end < n && c[end].cls == c[begin].cls) ++end;
+    std::size_t group_kept = 0;
+    for (std::size_t p = begin; p < end; ++p) {
+      if (s.suppressed[p] != 0) continue;
+      s.kept.push_back(static_cast<std::uint32_t>(p));
+      if (nms_.max_detections > 0 && ++group_kept == nms_.max_detections) break;
+      if (suppressing) {
+        kernels.suppress_overlaps(boxes, p, p + 1, end, nms_.iou_threshold,
+                                  s.suppressed.data());
       }
     }
-    if (i * 4 + 3 < result.boxes.size()) {
-      d.bbox.x = result.boxes[i * 4 + 0];
-      d.bbox.y = result.boxes[i * 4 + 1];
-      d.bbox.w = result.boxes[i * 4 + 2] - d.bbox.x;
-      d.bbox.h = result.boxes[i * 4 + 3] - d.bbox.y;
-    }
-    out.push_back(std::move(d));
+    begin = end;
+  }
+
+  if (by_class) {
+    std::ranges::sort(s.kept, [&c](std::uint32_t a, std::uint32_t b) {
+      return higher_score(c[a], c[b]);
+    });
+  }
+  if (nms_.max_detections > 0 && s.kept.size() > nms_.max_detections) {
+    s.kept.resize(nms_.max_detections);
+  }
+  for (auto& p : s.kept) p = c[p].index;
+  return s.kept;
+}
+
+std::vector<std::vector<normitri::core::Defect>> DefectDecoder::decode_batch(
+    std::span<const InferenceResult> results) const {
+  std::vector<std::vector<normitri::core::Defect>> out;
+  out.reserve(results.size());
+  for (const auto& result : results) {
+    out.push_back(decode(result));
   }
   return out;
 }
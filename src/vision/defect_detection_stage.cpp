@@ -1,5 +1,8 @@
 #include <normitri/vision/defect_detection_stage.hpp>
 #include <normitri/core/defect_result.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 
 namespace normitri::vision {
 
@@ -11,21 +14,91 @@ DefectDetectionStage::DefectDetectionStage(
       decoder_(std::move(decoder)),
       frame_id_(frame_id) {}
 
+std::unique_ptr<normitri::core::IPipelineStage> DefectDetectionStage::clone() const {
+  auto backend = backend_->clone();
+  if (!backend) {
+    return nullptr;
+  }
+  return std::make_unique<DefectDetectionStage>(std::move(backend), decoder_, frame_id_);
+}
+
 std::expected<normitri::core::StageOutput, normitri::core::PipelineError>
 DefectDetectionStage::process(const normitri::core::Frame& input) {
   auto valid = backend_->validate_input(input);
   if (!valid) {
     return std::unexpected(valid.error());
   }
-  auto result = backend_->infer(input);
-  if (!result) {
-    return std::unexpected(result.error());
-  }
-
   normitri::core::DefectResult out;
   out.frame_id = frame_id_;
-  out.defects = decoder_.decode(*result);
+  bool visited = false;
+  auto ran = backend_->infer_visit(
+      std::span<const normitri::core::Frame>(&input, 1),
+      [&](std::size_t, const DetectionView& detections) {
+        out.defects = decoder_.decode(detections);
+        visited = true;
+      });
+  if (!ran) {
+    return std::unexpected(ran.error());
+  }
+  if (!visited) {
+    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+  }
   return normitri::core::StageOutput{std::move(out)};
 }
 
+std::vector<std::expected<normitri::core::StageOutput, normitri::core::PipelineError>>
+DefectDetectionStage::process_batch(std::span<const normitri::core::Frame> inputs) {
+  using namespace normitri::core;
+  std::vector<std::expected<StageOutput, PipelineError>> outputs(
+      inputs.size(), std::unexpected(PipelineError::InvalidFrame));
+
+  // Positions of the frames that pass validation; only those go to the backend.
+  std::vector<std::size_t> valid;
+  valid.reserve(inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    auto ok = backend_->validate_input(inputs[i]);
+    if (ok) {
+      valid.push_back(i);
+    } else {
+      outputs[i] = std::unexpected(ok.error());
+    }
+  }
+  if (valid.empty()) {
+    return outputs;
+  }
+
+  std::span<const Frame> batch = inputs;
+  std::vector<Frame> valid_frames;  // shares buffers; only built when some frames were rejected
+  if (valid.size() != inputs.size()) {
+    valid_frames.reserve(valid.size());
+    for (std::size_t i : valid) valid_frames.push_back(inputs[i]);
+    batch = valid_frames;
+  }
+
+  // Decoded straight from the backend's output views; a frame counts only once visited.
+  std::vector<std::vector<Defect>> defects(valid.size());
+  std::vector<char> visited(valid.size(), 0);
+  auto ran = backend_->infer_visit(batch, [&](std::size_t k, const DetectionView& detections) {
+    if (k < defects.size()) {
+      defects[k] = decoder_.decode(detections);
+      visited[k] = 1;
+    }
+  });
+  if (ran && std::ranges::find(visited, 0) != visited.end()) {
+    ran = std::unexpected(PipelineError::InferenceFailed);
+  }
+  if (!ran) {
+    for (std::size_t i : valid) outputs[i] = std::unexpected(ran.error());
+    return outputs;
+  }
+
+  for (std::size_t k = 0; k < valid.size(); ++k) {
+    DefectResult out;
+    out.frame_id = frame_id_;
+    out.defects = std::move(defects[k]);
+    outputs[valid[k]] = StageOutput{std::move(out)};
+  }
+  return outputs;
+}
+
 }  // namespace normitri::vision
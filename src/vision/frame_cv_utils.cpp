@@ -2,14 +2,17 @@
 #include <normitri/core/frame.hpp>
 #include <opencv2/core.hpp>
 #include <cstddef>
-#include <vector>
+#include <memory>
 
 namespace normitri::vision::detail {
 
 namespace nc = normitri::core;
 
 std::optional<cv::Mat> frame_to_mat(const nc::Frame& frame) {
-  if (frame.empty()) return std::nullopt;
+  if (frame.empty() || frame.element_type() != nc::ElementType::UInt8 ||
+      frame.layout() != nc::TensorLayout::HWC) {
+    return std::nullopt;
+  }
 
   const int w = static_cast<int>(frame.width());
   const int h = static_cast<int>(frame.height());
@@ -41,12 +44,22 @@ std::optional<cv::Mat> frame_to_mat(const nc::Frame& frame) {
 nc::Frame mat_to_frame(const cv::Mat& mat, nc::PixelFormat format) {
   if (mat.empty()) return nc::Frame();
 
-  const std::uint32_t w = static_cast<std::uint32_t>(mat.cols);
-  const std::uint32_t h = static_cast<std::uint32_t>(mat.rows);
-  const std::size_t len = mat.total() * mat.elemSize();
-  std::vector<std::byte> buffer(len);
-  std::memcpy(buffer.data(), mat.ptr(), len);
-  return nc::Frame(w, h, format, std::move(buffer));
+  // Keep the Mat's refcounted allocation alive instead of copying it. Mats that wrap external
+  // memory (no UMatData) or have row padding are cloned once so the Frame owns packed bytes.
+  auto holder = std::make_shared<cv::Mat>(
+      mat.isContinuous() && mat.u != nullptr ? mat : mat.clone());
+
+  const std::uint32_t w = static_cast<std::uint32_t>(holder->cols);
+  const std::uint32_t h = static_cast<std::uint32_t>(holder->rows);
+  const std::size_t len = holder->total() * holder->elemSize();
+  std::shared_ptr<const std::byte> bytes(holder,
+                                         reinterpret_cast<const std::byte*>(holder->ptr()));
+  return nc::Frame(w, h, format, std::move(bytes), len);
+}
+
+cv::Mat frame_mat(nc::Frame& frame, int cv_type) {
+  return cv::Mat(static_cast<int>(frame.height()), static_cast<int>(frame.width()), cv_type,
+                 frame.data().data());
 }
 
 }  // namespace normitri::vision::detail
@@ -6,11 +6,18 @@
 
 namespace normitri::vision::detail {
 
-/// Convert Frame to cv::Mat (shared view or copy). Returns nullopt if format unsupported.
+/// Convert Frame to cv::Mat (shared view or copy). Returns nullopt if format unsupported
+/// (only interleaved uint8 image frames map to a Mat).
 std::optional<cv::Mat> frame_to_mat(const normitri::core::Frame& frame);
 
-/// Convert cv::Mat to Frame (copy).
+/// Convert cv::Mat to Frame without copying: the Frame shares the Mat's refcounted buffer.
+/// Mats that do not own their data or are not continuous are cloned once.
 normitri::core::Frame mat_to_frame(const cv::Mat& mat,
                                     normitri::core::PixelFormat format);
 
+/// Mutable cv::Mat header (frame height x width, \p cv_type) over a writable Frame's buffer,
+/// e.g. one from Frame::allocate(). OpenCV functions given this Mat as destination write
+/// straight into the Frame, since their create() keeps a buffer of matching size and type.
+cv::Mat frame_mat(normitri::core::Frame& frame, int cv_type);
+
 }  // namespace normitri::vision::detail
@@ -1,5 +1,6 @@
 #include <normitri/vision/inference_backend.hpp>
 #include <normitri/core/error.hpp>
+#include <cstddef>
 #include <span>
 #include <vector>
 
@@ -19,4 +20,20 @@ IInferenceBackend::infer_batch(std::span<const normitri::core::Frame> inputs) {
   return results;
 }
 
+std::expected<void, normitri::core::PipelineError>
+IInferenceBackend::infer_visit(std::span<const normitri::core::Frame> inputs,
+                               const DetectionVisitor& visitor) {
+  auto results = infer_batch(inputs);
+  if (!results) {
+    return std::unexpected(results.error());
+  }
+  if (results->size() != inputs.size()) {
+    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+  }
+  for (std::size_t i = 0; i < results->size(); ++i) {
+    visitor(i, DetectionView::of((*results)[i]));
+  }
+  return {};
+}
+
 }  // namespace normitri::vision
@@ -0,0 +1,38 @@
+#include <normitri/vision/inference_result.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace normitri::vision {
+
+DetectionView DetectionView::of(const InferenceResult& result) noexcept {
+  DetectionView view;
+  view.count = std::min<std::size_t>(result.num_detections, result.scores.size());
+  view.scores = result.scores.data();
+  view.box_count = std::min(view.count, result.boxes.size() / 4u);
+  if (view.box_count > 0) view.boxes = result.boxes.data();
+  view.class_id_count = std::min(view.count, result.class_ids.size());
+  if (view.class_id_count > 0) view.class_ids_i64 = result.class_ids.data();
+  return view;
+}
+
+InferenceResult DetectionView::materialize() const {
+  InferenceResult result;
+  result.num_detections = static_cast<std::uint32_t>(count);
+  result.scores.resize(count);
+  for (std::size_t i = 0; i < count; ++i) result.scores[i] = score(i);
+  // Boxes and class ids cover a prefix of the detections, as in of().
+  std::size_t with_box = 0;
+  while (with_box < count && has_box(with_box)) ++with_box;
+  result.boxes.resize(with_box * 4u);
+  for (std::size_t i = 0; i < with_box; ++i) {
+    for (std::size_t k = 0; k < 4u; ++k) result.boxes[i * 4u + k] = box(i, k);
+  }
+  std::size_t with_class = 0;
+  while (with_class < count && has_class_id(with_class)) ++with_class;
+  result.class_ids.resize(with_class);
+  for (std::size_t i = 0; i < with_class; ++i) result.class_ids[i] = class_id(i);
+  return result;
+}
+
+}  // namespace normitri::vision
@@ -0,0 +1,244 @@
+#include <normitri/vision/inference_session_pool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace normitri::vision {
+
+namespace {
+
+std::size_t pool_capacity(const SessionPoolOptions& options) {
+  if (options.memory_budget_bytes > 0 && options.session_memory_bytes == 0) {
+    throw std::invalid_argument(
+        "InferenceSessionPool: memory_budget_bytes needs session_memory_bytes");
+  }
+  std::size_t capacity = options.max_sessions;
+  if (options.memory_budget_bytes > 0) {
+    capacity = std::min(capacity, options.memory_budget_bytes / options.session_memory_bytes);
+  }
+  return std::max<std::size_t>(capacity, 1);
+}
+
+}  // namespace
+
+struct InferenceSessionPool::State {
+  mutable std::mutex mutex;
+  std::condition_variable returned;
+  std::vector<std::unique_ptr<IInferenceBackend>> sessions;
+  std::vector<IInferenceBackend*> idle;  // reserved to capacity, so give_back never allocates
+  std::size_t reserved{0};               // sessions created or being created
+  std::size_t in_use{0};
+
+  std::uint64_t checkouts{0};
+  std::uint64_t waits{0};
+  std::uint64_t total_wait_ns{0};
+  std::uint64_t max_wait_ns{0};
+};
+
+InferenceSessionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      session_(std::exchange(other.session_, nullptr)) {}
+
+InferenceSessionPool::Lease& InferenceSessionPool::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    if (pool_) pool_->give_back(session_);
+    pool_ = std::exchange(other.pool_, nullptr);
+    session_ = std::exchange(other.session_, nullptr);
+  }
+  return *this;
+}
+
+InferenceSessionPool::Lease::~Lease() {
+  if (pool_) pool_->give_back(session_);
+}
+
+InferenceSessionPool::InferenceSessionPool(Factory factory, SessionPoolOptions options)
+    : factory_(std::move(factory)),
+      capacity_(pool_capacity(options)),
+      state_(std::make_unique<State>()) {
+  if (!factory_) {
+    throw std::invalid_argument("InferenceSessionPool: factory must not be empty");
+  }
+  state_->sessions.reserve(capacity_);
+  state_->idle.reserve(capacity_);
+}
+
+InferenceSessionPool::~InferenceSessionPool() = default;
+
+IInferenceBackend* InferenceSessionPool::create_session() {
+  std::unique_ptr<IInferenceBackend> session;
+  try {
+    session = factory_();
+    if (!session) {
+      throw std::runtime_error("InferenceSessionPool: factory returned no session");
+    }
+    // Warmed before anyone can lease it, so the first frame on a lazily created session does
+    // not pay the warmup latency while holding a lease.
+    session->warmup();
+  } catch (...) {
+    {
+      std::lock_guard lock(state_->mutex);
+      --state_->reserved;
+    }
+    state_->returned.notify_one();  // a waiter may take the free slot
+    throw;
+  }
+  IInferenceBackend* raw = session.get();
+  std::lock_guard lock(state_->mutex);
+  state_->sessions.push_back(std::move(session));
+  return raw;
+}
+
+InferenceSessionPool::Lease InferenceSessionPool::checkout() {
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_lock lock(state_->mutex);
+  bool waited = false;
+  IInferenceBackend* session = nullptr;
+  while (session == nullptr) {
+    if (!state_->idle.empty()) {
+      session = state_->idle.back();
+      state_->idle.pop_back();
+    } else if (state_->reserved < capacity_) {
+      ++state_->reserved;
+      lock.unlock();
+      session = create_session();
+      lock.lock();
+    } else {
+      waited = true;
+      state_->returned.wait(lock);
+    }
+  }
+  ++state_->in_use;
+  ++state_->checkouts;
+  if (waited) {
+    const auto waited_for = std::chrono::steady_clock::now() - start;
+    const auto ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(waited_for).count());
+    ++state_->waits;
+    state_->total_wait_ns += ns;
+    state_->max_wait_ns = std::max(state_->max_wait_ns, ns);
+  }
+  return Lease(this, session);
+}
+
+std::optional<InferenceSessionPool::Lease> InferenceSessionPool::try_checkout() {
+  std::unique_lock lock(state_->mutex);
+  IInferenceBackend* session = nullptr;
+  if (!state_->idle.empty()) {
+    session = state_->idle.back();
+    state_->idle.pop_back();
+  } else if (state_->reserved < capacity_) {
+    ++state_->reserved;
+    lock.unlock();
+    session = create_session();
+    lock.lock();
+  } else {
+    return std::nullopt;
+  }
+  ++state_->in_use;
+  ++state_->checkouts;
+  return Lease(this, session);
+}
+
+void InferenceSessionPool::give_back(IInferenceBackend* session) noexcept {
+  {
+    std::lock_guard lock(state_->mutex);
+    state_->idle.push_back(session);
+    --state_->in_use;
+  }
+  state_->returned.notify_one();
+}
+
+void InferenceSessionPool::warmup() {
+  for (;;) {
+    {
+      std::lock_guard lock(state_->mutex);
+      if (state_->reserved >= capacity_) return;
+      ++state_->reserved;
+    }
+    IInferenceBackend* session = create_session();
+    {
+      std::lock_guard lock(state_->mutex);
+      state_->idle.push_back(session);
+    }
+    state_->returned.notify_one();
+  }
+}
+
+std::expected<void, normitri::core::PipelineError>
+InferenceSessionPool::validate_input(const normitri::core::Frame& input) {
+  IInferenceBackend* reference = nullptr;
+  {
+    std::unique_lock lock(state_->mutex);
+    if (!state_->sessions.empty()) {
+      reference = state_->sessions.front().get();
+    } else if (state_->reserved < capacity_) {
+      ++state_->reserved;
+      lock.unlock();
+      reference = create_session();
+      lock.lock();
+      state_->idle.push_back(reference);
+      state_->returned.notify_one();
+    }
+  }
+  if (reference == nullptr) {
+    // Every slot is still being created by other callers; wait for one of those sessions.
+    auto lease = checkout();
+    return lease->validate_input(input);
+  }
+  return reference->validate_input(input);
+}
+
+SessionPoolStats InferenceSessionPool::stats() const {
+  std::lock_guard lock(state_->mutex);
+  SessionPoolStats s;
+  s.sessions = state_->sessions.size();
+  s.in_use = state_->in_use;
+  s.checkouts = state_->checkouts;
+  s.waits = state_->waits;
+  s.total_wait_ns = state_->total_wait_ns;
+  s.max_wait_ns = state_->max_wait_ns;
+  return s;
+}
+
+PooledInferenceBackend::PooledInferenceBackend(std::shared_ptr<InferenceSessionPool> pool)
+    : pool_(std::move(pool)) {
+  if (!pool_) {
+    throw std::invalid_argument("PooledInferenceBackend: pool must not be null");
+  }
+}
+
+std::expected<InferenceResult, normitri::core::PipelineError>
+PooledInferenceBackend::infer(const normitri::core::Frame& input) {
+  auto lease = pool_->checkout();
+  return lease->infer(input);
+}
+
+std::expected<void, normitri::core::PipelineError>
+PooledInferenceBackend::validate_input(const normitri::core::Frame& input) const {
+  return pool_->validate_input(input);
+}
+
+std::expected<std::vector<InferenceResult>, normitri::core::PipelineError>
+PooledInferenceBackend::infer_batch(std::span<const normitri::core::Frame> inputs) {
+  auto lease = pool_->checkout();
+  return lease->infer_batch(inputs);
+}
+
+std::expected<void, normitri::core::PipelineError>
+PooledInferenceBackend::infer_visit(std::span<const normitri::core::Frame> inputs,
+                                    const DetectionVisitor& visitor) {
+  auto lease = pool_->checkout();
+  return lease->infer_visit(inputs, visitor);
+}
+
+void PooledInferenceBackend::warmup() { pool_->warmup(); }
+
+std::unique_ptr<IInferenceBackend> PooledInferenceBackend::clone() const {
+  return std::make_unique<PooledInferenceBackend>(pool_);
+}
+
+}  // namespace normitri::vision
@@ -0,0 +1,56 @@
+#include "mapped_file.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NORMITRI_HAS_MMAP 1
+#endif
+
+namespace normitri::vision::detail {
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef NORMITRI_HAS_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+      const auto size = static_cast<std::size_t>(st.st_size);
+      void* addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      if (addr != MAP_FAILED) {
+        data_ = static_cast<const std::byte*>(addr);
+        size_ = size;
+        mapped_ = true;
+      }
+    }
+    ::close(fd);  // the mapping stays valid after close
+    if (mapped_) return;
+  }
+#endif
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw std::runtime_error("MappedFile: cannot open " + path.string());
+  }
+  fallback_.resize(static_cast<std::size_t>(in.tellg()));
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char*>(fallback_.data()),
+               static_cast<std::streamsize>(fallback_.size()))) {
+    throw std::runtime_error("MappedFile: cannot read " + path.string());
+  }
+  data_ = fallback_.data();
+  size_ = fallback_.size();
+}
+
+MappedFile::~MappedFile() {
+#ifdef NORMITRI_HAS_MMAP
+  if (mapped_) {
+    ::munmap(const_cast<std::byte*>(data_), size_);
+  }
+#endif
+}
+
+}  // namespace normitri::vision::detail
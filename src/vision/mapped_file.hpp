@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace normitri::vision::detail {
+
+/// Read-only view of a whole file. On POSIX the file is memory-mapped, so every mapping of the
+/// same file (in this or another process) shares one copy in the page cache; elsewhere it is
+/// read into memory. Throws std::runtime_error if the file cannot be opened or read.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::filesystem::path& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+
+ private:
+  const std::byte* data_{nullptr};
+  std::size_t size_{0};
+  bool mapped_{false};
+  std::vector<std::byte> fallback_;  // contents when mmap is unavailable
+};
+
+}  // namespace normitri::vision::detail
@@ -2,6 +2,7 @@
 #include <normitri/core/defect.hpp>
 #include <normitri/core/error.hpp>
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -12,6 +13,10 @@ void MockInferenceBackend::set_defects(
   defects_to_return_ = std::move(defects);
 }
 
+std::unique_ptr<IInferenceBackend> MockInferenceBackend::clone() const {
+  return std::make_unique<MockInferenceBackend>(*this);
+}
+
 static InferenceResult mock_to_result(
     const std::vector<normitri::core::Defect>& defects) {
   InferenceResult r;
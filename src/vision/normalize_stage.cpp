@@ -2,17 +2,37 @@
 #include "frame_cv_utils.hpp"
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
+#include <normitri/vision/simd_kernels.hpp>
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace normitri::vision {
 
-NormalizeStage::NormalizeStage(float mean, float scale)
-    : mean_(mean), scale_(scale) {}
+NormalizeStage::NormalizeStage(float mean,
+                               float scale,
+                               std::shared_ptr<normitri::core::BufferPool> pool,
+                               normitri::core::TensorLayout layout)
+    : mean_(mean), scale_(scale), pool_(std::move(pool)), layout_(layout) {}
 
 std::expected<normitri::core::StageOutput, normitri::core::PipelineError>
 NormalizeStage::process(const normitri::core::Frame& input) {
+  normitri::core::Frame out;
+  auto written = process_into(input, out);
+  if (!written) {
+    return std::unexpected(written.error());
+  }
+  if (*written == normitri::core::StageIntoResult::PassThrough) {
+    return normitri::core::StageOutput{input};  // shares the buffer; no pixel copy
+  }
+  return normitri::core::StageOutput{std::move(out)};
+}
+
+std::expected<normitri::core::StageIntoResult, normitri::core::PipelineError>
+NormalizeStage::process_into(const normitri::core::Frame& input,
+                             normitri::core::Frame& output) {
   if (input.empty()) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
@@ -24,17 +44,49 @@ NormalizeStage::process(const normitri::core::Frame& input) {
     return std::unexpected(PipelineError::InvalidFrame);
   }
 
-  cv::Mat mat_float;
-  mat_in->convertTo(mat_float, CV_32FC(mat_in->channels()), scale_, -mean_ * scale_);
-
-  const std::size_t len = mat_float.total() * mat_float.elemSize();
-  std::vector<std::byte> buffer(len);
-  std::memcpy(buffer.data(), mat_float.ptr(), len);
-  Frame out(static_cast<std::uint32_t>(mat_float.cols),
-            static_cast<std::uint32_t>(mat_float.rows),
-            PixelFormat::Float32Planar,
-            std::move(buffer));
-  return StageOutput{std::move(out)};
+  const int channels = mat_in->channels();
+  const int out_type = CV_32FC(channels);
+  auto bytes = output.prepare(input.width(), input.height(), PixelFormat::Float32Planar,
+                              mat_in->total() * static_cast<std::size_t>(CV_ELEM_SIZE(out_type)),
+                              pool_.get());
+  float* out = reinterpret_cast<float*>(bytes.data());
+  const float bias = -mean_ * scale_;
+  const auto& kernels = simd::simd_kernels();
+
+  // Source rows may be padded; a continuous Mat is processed as one long row.
+  const bool continuous = mat_in->isContinuous();
+  const int rows = continuous ? 1 : mat_in->rows;
+  const std::size_t cols = continuous ? mat_in->total() : static_cast<std::size_t>(mat_in->cols);
+  const auto nch = static_cast<std::size_t>(channels);
+
+  if (layout_ == TensorLayout::HWC || channels == 1) {
+    for (int r = 0; r < rows; ++r) {
+      kernels.u8_to_f32(mat_in->ptr<std::uint8_t>(r), cols * nch, scale_, bias,
+                        out + static_cast<std::size_t>(r) * cols * nch);
+    }
+    output.set_layout(layout_);
+    return StageIntoResult::Written;
+  }
+
+  const std::size_t plane = mat_in->total();
+  if (channels == 3) {
+    // CHW: de-interleave, convert and normalize in one pass.
+    for (int r = 0; r < rows; ++r) {
+      float* row_out = out + static_cast<std::size_t>(r) * cols;
+      kernels.u8_to_f32_planar(mat_in->ptr<std::uint8_t>(r), cols, 3, {0, 1, 2}, scale_, bias,
+                               row_out, row_out + plane, row_out + 2 * plane);
+    }
+  } else {
+    // Other channel counts: split into per-thread planes, then convert each into its plane.
+    thread_local std::vector<cv::Mat> planes;
+    cv::split(*mat_in, planes);
+    for (std::size_t c = 0; c < nch; ++c) {
+      cv::Mat dst(mat_in->rows, mat_in->cols, CV_32FC1, out + c * plane);
+      planes[c].convertTo(dst, CV_32F, scale_, bias);
+    }
+  }
+  output.set_layout(TensorLayout::CHW);
+  return StageIntoResult::Written;
 }
 
 }  // namespace normitri::vision
@@ -1,12 +1,23 @@
 #include <normitri/vision/onnx_inference_backend.hpp>
+#include "mapped_file.hpp"
+#include "onnx_model_cache.hpp"
+#include "tensor_copy.hpp"
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
+#include <normitri/vision/simd_kernels.hpp>
 #include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <expected>
+#include <filesystem>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace normitri::vision {
@@ -19,23 +30,248 @@ Ort::MemoryInfo CpuMemoryInfo() {
   return Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
 }
 
-/// Copy HWC (height, width, channels) float buffer to NCHW (batch, channels, height, width).
-void HwcToNchw(const float* hwc, std::uint32_t h, std::uint32_t w, float* nchw) {
-  const std::size_t hw = static_cast<std::size_t>(h) * w;
-  for (std::uint32_t y = 0; y < h; ++y) {
-    for (std::uint32_t x = 0; x < w; ++x) {
-      const std::size_t src_idx = (static_cast<std::size_t>(y) * w + x) * kNumChannels;
-      nchw[0 * hw + y * w + x] = hwc[src_idx + 0];
-      nchw[1 * hw + y * w + x] = hwc[src_idx + 1];
-      nchw[2 * hw + y * w + x] = hwc[src_idx + 2];
+/// Maps the model's input element type to Frame's ElementType; throws for unsupported types.
+normitri::core::ElementType ToElementType(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return normitri::core::ElementType::Float32;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+      return normitri::core::ElementType::Float16;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return normitri::core::ElementType::UInt8;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+      return normitri::core::ElementType::Int8;
+    default:
+      throw std::runtime_error(
+          "OnnxInferenceBackend: input element type must be float, float16, uint8 or int8");
+  }
+}
+
+/// Bytes per element of an output tensor type; 0 if outputs of that type are not preallocated.
+std::size_t OutputElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+/// One session output as view_of() reads it: element data and shape.
+struct TensorView {
+  const std::byte* data{nullptr};
+  std::span<const std::int64_t> shape;
+
+  template <typename T>
+  [[nodiscard]] const T* as() const noexcept {
+    return reinterpret_cast<const T*>(data);
+  }
+};
+
+/// Process-wide Env: ONNX Runtime keeps one environment per process anyway, and sharing it lets
+/// sessions run on its global thread pools. Released with the last backend that holds it.
+struct SharedEnv {
+  std::shared_ptr<Ort::Env> env;
+  bool global_thread_pools{false};
+};
+
+SharedEnv acquire_env(const OnnxSessionOptions& options) {
+  static std::mutex mutex;
+  static std::weak_ptr<Ort::Env> current;
+  static bool current_has_global_pools = false;
+
+  std::lock_guard lock(mutex);
+  if (auto env = current.lock()) {
+    return {std::move(env), current_has_global_pools};
+  }
+  std::shared_ptr<Ort::Env> env;
+  if (options.use_global_thread_pool) {
+    Ort::ThreadingOptions threading;
+    threading.SetGlobalIntraOpNumThreads(options.intra_op_threads);
+    threading.SetGlobalInterOpNumThreads(options.inter_op_threads);
+    threading.SetGlobalSpinControl(options.allow_spinning ? 1 : 0);
+    env = std::make_shared<Ort::Env>(threading, ORT_LOGGING_LEVEL_WARNING, "normitri");
+  } else {
+    env = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "normitri");
+  }
+  current = env;
+  current_has_global_pools = options.use_global_thread_pool;
+  return {std::move(env), current_has_global_pools};
+}
+
+GraphOptimizationLevel ToOrt(OnnxGraphOptimization level) {
+  switch (level) {
+    case OnnxGraphOptimization::Disabled: return ORT_DISABLE_ALL;
+    case OnnxGraphOptimization::Basic: return ORT_ENABLE_BASIC;
+    case OnnxGraphOptimization::Extended: return ORT_ENABLE_EXTENDED;
+    case OnnxGraphOptimization::All: return ORT_ENABLE_ALL;
+  }
+  return ORT_ENABLE_EXTENDED;
+}
+
+/// Applies \p options to \p session_options; with \p global_pools the session runs on the
+/// Env's thread pools, so per-session thread counts and spinning do not apply.
+void ApplySessionOptions(const OnnxSessionOptions& options,
+                         bool global_pools,
+                         Ort::SessionOptions& session_options) {
+  session_options.SetGraphOptimizationLevel(ToOrt(options.graph_optimization));
+  session_options.SetExecutionMode(
+      options.execution_mode == OnnxExecutionMode::Parallel ? ORT_PARALLEL : ORT_SEQUENTIAL);
+  if (options.enable_mem_pattern) {
+    session_options.EnableMemPattern();
+  } else {
+    session_options.DisableMemPattern();
+  }
+  if (options.enable_cpu_mem_arena) {
+    session_options.EnableCpuMemArena();
+  } else {
+    session_options.DisableCpuMemArena();
+  }
+  if (global_pools) {
+    session_options.DisablePerSessionThreads();
+    return;
+  }
+  session_options.SetIntraOpNumThreads(options.intra_op_threads);
+  session_options.SetInterOpNumThreads(options.inter_op_threads);
+  const char* spin = options.allow_spinning ? "1" : "0";
+  session_options.AddConfigEntry("session.intra_op.allow_spinning", spin);
+  session_options.AddConfigEntry("session.inter_op.allow_spinning", spin);
+}
+
+/// CPU features the saved graph may depend on: at higher optimization levels ONNX Runtime bakes
+/// in layout transforms for this CPU (e.g. the NCHWc block size follows the widest vector unit).
+std::string CpuSignature() {
+  std::string signature = simd::simd_level_name(simd::detected_simd_level());
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  if (__builtin_cpu_supports("avx512vnni")) signature += "+vnni";
+#endif
+  return signature;
+}
+
+/// Cache key part besides the model hash: anything that changes the saved optimized graph, so a
+/// cache directory shared between machines (an image, a network volume) never hands one CPU the
+/// graph optimized for another. Sessions only use the CPU execution provider.
+std::string CacheVariant(const OnnxSessionOptions& options) {
+  static const std::string cpu = CpuSignature();
+  return std::string(OrtGetApiBase()->GetVersionString()) +
+         "|opt=" + std::to_string(static_cast<int>(options.graph_optimization)) +
+         "|mode=" + std::to_string(static_cast<int>(options.execution_mode)) + "|ep=cpu" +
+         "|isa=" + cpu;
+}
+
+/// One model file loaded once per process: its bytes and the prepacked weights of every
+/// session created from them.
+struct SharedModel {
+  explicit SharedModel(const std::filesystem::path& path) : file(path) {}
+
+  detail::MappedFile file;
+  Ort::PrepackedWeightsContainer prepacked;
+};
+
+/// Model registry: returns the loaded entry for \p path, loading it on first use. Entries are
+/// keyed by file identity and modification time, and released with the last session using them.
+std::shared_ptr<SharedModel> acquire_shared_model(const std::filesystem::path& path) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<SharedModel>> models;
+
+  std::error_code ec;
+  std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+  if (ec) canonical = path;
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  const std::string key = canonical.string() + "|" +
+                          std::to_string(ec ? 0 : mtime.time_since_epoch().count());
+
+  std::lock_guard lock(mutex);
+  std::erase_if(models, [](const auto& entry) { return entry.second.expired(); });
+  if (auto it = models.find(key); it != models.end()) {
+    if (auto model = it->second.lock()) return model;
+  }
+  auto model = std::make_shared<SharedModel>(path);
+  models[key] = model;
+  return model;
+}
+
+/// Opens \p path; when \p shared is non-null, from the registry's bytes with its prepacked
+/// weights container (and keeps the entry alive in *shared).
+Ort::Session OpenSession(const Ort::Env& env,
+                         const std::filesystem::path& path,
+                         const Ort::SessionOptions& session_options,
+                         std::shared_ptr<SharedModel>* shared) {
+  if (shared == nullptr) {
+    return Ort::Session(env, path.c_str(), session_options);
+  }
+  *shared = acquire_shared_model(path);
+  const auto bytes = (*shared)->file.bytes();
+  return Ort::Session(env, bytes.data(), bytes.size(), session_options, (*shared)->prepacked);
+}
+
+/// Creates the session, through the optimized-model cache when one is configured. A cache entry
+/// that fails to load is deleted and rebuilt from the .onnx file. With \p shared, the model is
+/// loaded through the registry; an ORT-format cache entry is then used in place, initializers
+/// included, so its weights are the mapped file's pages.
+Ort::Session CreateSession(const Ort::Env& env,
+                           const std::string& model_path,
+                           const OnnxSessionOptions& options,
+                           Ort::SessionOptions& session_options,
+                           OnnxCacheStatus& status,
+                           std::shared_ptr<SharedModel>* shared) {
+  status = OnnxCacheStatus::Disabled;
+  std::filesystem::path cache_file;
+  if (!options.optimized_model_cache_dir.empty()) {
+    if (auto hash = detail::hash_file(model_path)) {
+      cache_file = detail::optimized_model_cache_path(options.optimized_model_cache_dir,
+                                                      model_path, *hash, CacheVariant(options));
+    }
+  }
+  if (cache_file.empty()) {
+    return OpenSession(env, model_path, session_options, shared);
+  }
+
+  std::error_code ec;
+  if (std::filesystem::exists(cache_file, ec)) {
+    try {
+      // Already optimized: skip the graph passes that made it.
+      Ort::SessionOptions cached = session_options.Clone();
+      cached.SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+      cached.AddConfigEntry("session.load_model_format", "ORT");
+      if (shared != nullptr) {
+        cached.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        cached.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+      }
+      Ort::Session session = OpenSession(env, cache_file, cached, shared);
+      status = OnnxCacheStatus::Hit;
+      return session;
+    } catch (const Ort::Exception&) {
+      if (shared != nullptr) shared->reset();
+      std::filesystem::remove(cache_file, ec);
     }
   }
+
+  // Cold start: ONNX Runtime writes the optimized model while creating the session; publish it
+  // under its final name only once complete, so concurrent starters never load a partial file.
+  std::filesystem::create_directories(options.optimized_model_cache_dir, ec);
+  const std::filesystem::path temp = detail::cache_temp_path(cache_file);
+  Ort::SessionOptions saving = session_options.Clone();
+  saving.SetOptimizedModelFilePath(temp.c_str());
+  saving.AddConfigEntry("session.save_model_format", "ORT");
+  Ort::Session session = OpenSession(env, model_path, saving, shared);
+  if (std::filesystem::exists(temp, ec)) {
+    detail::publish_cache_file(temp, cache_file);
+  }
+  status = OnnxCacheStatus::Miss;
+  return session;
 }
 
 }  // namespace
 
 struct OnnxInferenceBackend::Impl {
-  Ort::Env env{ORT_LOGGING_LEVEL_WARNING, "normitri"};
+  std::shared_ptr<Ort::Env> env;  // shared by all backends; outlives session
+  /// Registry entry the session was created from (share_model_weights); outlives session, which
+  /// may reference its bytes and prepacked weights.
+  std::shared_ptr<SharedModel> shared_model;
   Ort::SessionOptions session_options;
   Ort::Session session{nullptr};
 
@@ -46,23 +282,309 @@ struct OnnxInferenceBackend::Impl {
   std::uint32_t input_height{0};
   std::uint32_t input_width{0};
   bool input_is_nchw{true};
+  /// True if the model's batch dimension is symbolic (e.g. "batch_size"); false for a fixed 1.
+  bool dynamic_batch{false};
+  OnnxCacheStatus cache_status{OnnxCacheStatus::Disabled};
+  ONNXTensorElementDataType input_onnx_type{ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT};
+  normitri::core::ElementType input_type{normitri::core::ElementType::Float32};
   /// True if model has a single output with [1, N, 6] or [1, 6, N] (xmin, ymin, xmax, ymax, score, class_id) — e.g. YOLOv10.
   bool use_yolo_single_output{false};
 
-  std::vector<float> nchw_buffer;  // scratch for HWC -> NCHW
+  /// Declared shape (-1 for symbolic dimensions) and element type of each decoded output.
+  struct OutputSpec {
+    std::vector<std::int64_t> shape;
+    ONNXTensorElementDataType type{ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT};
+  };
+  std::vector<OutputSpec> output_specs;
+  /// True if every output's shape is known up to the batch dimension, so each run context binds
+  /// preallocated output tensors; otherwise ONNX Runtime allocates outputs (from its arena).
+  bool preallocate_outputs{false};
+
+  /// IoBinding state for one in-flight run. Inputs and outputs stay bound between runs and are
+  /// rebound only when the batch size or the input buffer changes.
+  struct RunContext {
+    explicit RunContext(Ort::Session& session) : binding(session) {}
+
+    Ort::IoBinding binding;
+    std::vector<std::byte> input_buffer;  // HWC -> NCHW transposes and stacked batches
+    const std::byte* bound_input{nullptr};
+    std::int64_t bound_batch{0};
+    std::vector<std::vector<std::byte>> output_buffers;  // when preallocate_outputs
+    std::vector<Ort::Value> outputs;                     // bound (or last returned) outputs
+    std::vector<std::vector<std::int64_t>> output_shapes;
+  };
+
+  /// Takes an idle context from \p contexts, or creates one; one is taken per run(), so
+  /// concurrent runs never share bindings.
+  std::unique_ptr<RunContext> acquire_context(Contexts& contexts);
+  void release_context(Contexts& contexts, std::unique_ptr<RunContext> context);
+
+  /// Binds \p batch outputs in \p ctx: preallocated tensors, or CPU memory for ORT to fill.
+  void bind_outputs(RunContext& ctx, std::int64_t batch);
+
+  /// Runs the session once on \p inputs (already validated) as one [N, ...] tensor and calls
+  /// \p visitor with a view of frame i's detections as index \p first + i, straight over the
+  /// output tensors. Reentrant: each call has its own RunContext from \p contexts and
+  /// Session::Run is thread-safe, so concurrent calls share the session and nothing else.
+  std::expected<void, normitri::core::PipelineError> run(
+      Contexts& contexts, std::span<const normitri::core::Frame> inputs,
+      const DetectionVisitor& visitor, std::size_t first = 0);
+
+  /// Materializes one InferenceResult per frame of \p inputs through run().
+  std::expected<std::vector<InferenceResult>, normitri::core::PipelineError> run_results(
+      Contexts& contexts, std::span<const normitri::core::Frame> inputs);
+
+  /// View of frame \p b's detections in a batch of \p batch from the session outputs.
+  std::expected<DetectionView, normitri::core::PipelineError> view_of(
+      std::span<const TensorView> outputs, std::int64_t batch, std::int64_t b) const;
+};
 
-  Impl() {
-    session_options.SetIntraOpNumThreads(1);
-    session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
-  }
+/// Run contexts not in use. Each backend, and each clone() of it, has its own set on the shared
+/// session, so replicas on different threads never contend for them.
+struct OnnxInferenceBackend::Contexts {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Impl::RunContext>> idle;
 };
 
+std::unique_ptr<OnnxInferenceBackend::Impl::RunContext>
+OnnxInferenceBackend::Impl::acquire_context(Contexts& contexts) {
+  {
+    std::lock_guard lock(contexts.mutex);
+    if (!contexts.idle.empty()) {
+      auto context = std::move(contexts.idle.back());
+      contexts.idle.pop_back();
+      return context;
+    }
+  }
+  return std::make_unique<RunContext>(session);
+}
+
+void OnnxInferenceBackend::Impl::release_context(Contexts& contexts,
+                                                 std::unique_ptr<RunContext> context) {
+  std::lock_guard lock(contexts.mutex);
+  contexts.idle.push_back(std::move(context));
+}
+
+void OnnxInferenceBackend::Impl::bind_outputs(RunContext& ctx, std::int64_t batch) {
+  ctx.binding.ClearBoundOutputs();
+  ctx.outputs.clear();
+  ctx.output_buffers.resize(output_specs.size());
+  ctx.output_shapes.resize(output_specs.size());
+  const Ort::MemoryInfo mem_info = CpuMemoryInfo();
+  for (std::size_t i = 0; i < output_specs.size(); ++i) {
+    if (!preallocate_outputs) {
+      ctx.binding.BindOutput(output_name_ptrs[i], mem_info);
+      continue;
+    }
+    const OutputSpec& spec = output_specs[i];
+    std::vector<std::int64_t>& shape = ctx.output_shapes[i];
+    shape = spec.shape;
+    shape[0] = batch;
+    std::size_t bytes = OutputElementSize(spec.type);
+    for (std::int64_t d : shape) bytes *= static_cast<std::size_t>(d);
+    ctx.output_buffers[i].resize(bytes);
+    ctx.outputs.push_back(Ort::Value::CreateTensor(mem_info, ctx.output_buffers[i].data(), bytes,
+                                                   shape.data(), shape.size(), spec.type));
+    ctx.binding.BindOutput(output_name_ptrs[i], ctx.outputs.back());
+  }
+}
+
+std::expected<void, normitri::core::PipelineError>
+OnnxInferenceBackend::Impl::run(Contexts& contexts,
+                                std::span<const normitri::core::Frame> inputs,
+                                const DetectionVisitor& visitor, std::size_t first) {
+  using normitri::core::TensorLayout;
+  const auto batch = static_cast<std::int64_t>(inputs.size());
+  const std::size_t frame_bytes = inputs.front().min_bytes();
+  const auto h = static_cast<std::int64_t>(input_height);
+  const auto w = static_cast<std::int64_t>(input_width);
+  std::array<std::int64_t, 4> shape{batch, h, w, kNumChannels};
+  if (input_is_nchw) {
+    shape = {batch, kNumChannels, h, w};
+  }
+
+  std::unique_ptr<RunContext> ctx = acquire_context(contexts);
+  struct Release {
+    Impl* impl;
+    Contexts& contexts;
+    std::unique_ptr<RunContext>& ctx;
+    ~Release() { impl->release_context(contexts, std::move(ctx)); }
+  } release{this, contexts, ctx};
+
+  // A single frame already in the tensor layout is bound without a copy; otherwise each frame is
+  // copied (and transposed from HWC if the model is NCHW) into its slot of the context's buffer.
+  const std::byte* tensor_data = inputs.front().data().data();
+  const auto needs_transpose = [&](const normitri::core::Frame& f) {
+    return input_is_nchw && f.layout() == TensorLayout::HWC;
+  };
+  if (inputs.size() > 1 || needs_transpose(inputs.front())) {
+    ctx->input_buffer.resize(inputs.size() * frame_bytes);
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+      const std::byte* src = inputs[i].data().data();
+      std::byte* dst = ctx->input_buffer.data() + i * frame_bytes;
+      if (needs_transpose(inputs[i])) {
+        detail::hwc_to_chw(src, input_height, input_width,
+                           static_cast<std::uint32_t>(kNumChannels),
+                           normitri::core::element_size(input_type), dst);
+      } else {
+        std::memcpy(dst, src, frame_bytes);
+      }
+    }
+    tensor_data = ctx->input_buffer.data();
+  }
+
+  try {
+    if (tensor_data != ctx->bound_input || batch != ctx->bound_batch) {
+      Ort::Value input_tensor = Ort::Value::CreateTensor(
+          CpuMemoryInfo(), const_cast<std::byte*>(tensor_data), inputs.size() * frame_bytes,
+          shape.data(), shape.size(), input_onnx_type);
+      ctx->binding.ClearBoundInputs();
+      ctx->binding.BindInput(input_name.c_str(), input_tensor);
+      ctx->bound_input = tensor_data;
+    }
+    if (batch != ctx->bound_batch) {
+      ctx->bound_batch = 0;  // until rebound
+      bind_outputs(*ctx, batch);
+      ctx->bound_batch = batch;
+    }
+    session.Run(Ort::RunOptions{}, ctx->binding);
+    if (!preallocate_outputs) {
+      ctx->outputs = ctx->binding.GetOutputValues();
+      for (std::size_t i = 0; i < ctx->outputs.size(); ++i) {
+        ctx->output_shapes[i] = ctx->outputs[i].GetTensorTypeAndShapeInfo().GetShape();
+      }
+    }
+  } catch (const Ort::Exception&) {
+    ctx->bound_input = nullptr;
+    ctx->bound_batch = 0;
+    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+  }
+
+  std::array<TensorView, 3> views{};
+  const std::size_t num_views = std::min(ctx->outputs.size(), views.size());
+  for (std::size_t i = 0; i < num_views; ++i) {
+    views[i] = {ctx->outputs[i].GetTensorData<std::byte>(), ctx->output_shapes[i]};
+  }
+
+  // Every frame's view is built before the first visit, so a bad output shape fails the whole
+  // call without a partial visit.
+  const std::span<const TensorView> outputs(views.data(), num_views);
+  std::vector<DetectionView> frames;
+  frames.reserve(inputs.size());
+  for (std::int64_t b = 0; b < batch; ++b) {
+    auto view = view_of(outputs, batch, b);
+    if (!view) {
+      return std::unexpected(view.error());
+    }
+    frames.push_back(*view);
+  }
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    visitor(first + i, frames[i]);
+  }
+  return {};
+}
+
+std::expected<std::vector<InferenceResult>, normitri::core::PipelineError>
+OnnxInferenceBackend::Impl::run_results(Contexts& contexts,
+                                        std::span<const normitri::core::Frame> inputs) {
+  std::vector<InferenceResult> results(inputs.size());
+  auto ran = run(contexts, inputs, [&results](std::size_t i, const DetectionView& detections) {
+    results[i] = detections.materialize();
+  });
+  if (!ran) {
+    return std::unexpected(ran.error());
+  }
+  return results;
+}
+
+std::expected<DetectionView, normitri::core::PipelineError>
+OnnxInferenceBackend::Impl::view_of(std::span<const TensorView> outputs,
+                                    std::int64_t batch,
+                                    std::int64_t b) const {
+  DetectionView view;
+
+  if (use_yolo_single_output) {
+    // Single output: [B, N, 6] or [B, 6, N] — (xmin, ymin, xmax, ymax, score, class_id)
+    if (outputs.size() != 1u) {
+      return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+    }
+    const auto shape = outputs[0].shape;
+    int64_t n = 0;
+    bool rows_are_n6 = false;  // true: [B, N, 6]; false: [B, 6, N]
+    if (shape.size() == 3u && shape[0] == batch && shape[2] == 6) {
+      n = shape[1];
+      rows_are_n6 = true;
+    } else if (shape.size() == 3u && shape[0] == batch && shape[1] == 6) {
+      n = shape[2];
+      rows_are_n6 = false;
+    }
+    if (n <= 0) {
+      return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+    }
+    const float* data = outputs[0].as<float>() + b * n * 6;
+    const auto count = static_cast<std::size_t>(n);
+    // Column k of detection i: data[i * 6 + k] for [N, 6] rows, data[k * N + i] for [6, N].
+    const std::size_t row_step = rows_are_n6 ? 6u : 1u;
+    const std::size_t col_step = rows_are_n6 ? 1u : count;
+    view.count = count;
+    view.boxes = data;
+    view.box_stride = row_step;
+    view.coord_stride = col_step;
+    view.scores = data + 4 * col_step;
+    view.score_stride = row_step;
+    view.class_ids_f32 = data + 5 * col_step;
+    view.class_stride = row_step;
+    return view;
+  }
+
+  // Three-output path: boxes, scores, class_ids
+  if (outputs.size() < 3u) {
+    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+  }
+  const auto boxes_shape = outputs[0].shape;
+
+  // Support [B, N, 4]; for a single frame also [N, 4, 1] or [N, 4]. Scores and class ids are
+  // [B, N] (or [N]) in the same order.
+  int64_t n = 0;
+  if (boxes_shape.size() == 3u && boxes_shape[0] == batch) {
+    n = boxes_shape[1];
+    if (boxes_shape[2] != 4) n = 0;
+  } else if (batch == 1 && boxes_shape.size() == 3u && boxes_shape[2] == 1 &&
+             boxes_shape[1] == 4) {
+    n = boxes_shape[0];
+  } else if (batch == 1 && boxes_shape.size() == 2u && boxes_shape[1] == 4) {
+    n = boxes_shape[0];
+  }
+  if (n <= 0) {
+    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+  }
+
+  const auto count = static_cast<std::size_t>(n);
+  const bool boxes_is_n4 = (boxes_shape.size() == 3u && boxes_shape[2] == 4) ||
+                           (boxes_shape.size() == 2u && boxes_shape[1] == 4);
+  view.count = count;
+  view.boxes = outputs[0].as<float>() + b * n * 4;
+  // [N, 4, 1]: coordinate k of detection i at k * N + i.
+  view.box_stride = boxes_is_n4 ? 4u : 1u;
+  view.coord_stride = boxes_is_n4 ? 1u : count;
+  view.scores = outputs[1].as<float>() + b * n;
+  view.class_ids_i64 = outputs[2].as<int64_t>() + b * n;
+  return view;
+}
+
 OnnxInferenceBackend::OnnxInferenceBackend(std::string model_path,
                                            std::string input_name,
-                                           std::array<std::string, 3> output_names)
-    : impl_(std::make_unique<Impl>()) {
-  impl_->session_options.SetIntraOpNumThreads(1);
-  impl_->session = Ort::Session(impl_->env, model_path.c_str(), impl_->session_options);
+                                           std::array<std::string, 3> output_names,
+                                           OnnxSessionOptions options)
+    : impl_(std::make_shared<Impl>()), contexts_(std::make_unique<Contexts>()) {
+  // Global pools only if the shared Env has them (it may predate this backend's options).
+  SharedEnv shared = acquire_env(options);
+  impl_->env = std::move(shared.env);
+  ApplySessionOptions(options, options.use_global_thread_pool && shared.global_thread_pools,
+                      impl_->session_options);
+  impl_->session = CreateSession(*impl_->env, model_path, options, impl_->session_options,
+                                 impl_->cache_status,
+                                 options.share_model_weights ? &impl_->shared_model : nullptr);
 
   Ort::AllocatorWithDefaultOptions allocator;
   const size_t num_inputs = impl_->session.GetInputCount();
@@ -78,8 +600,11 @@ OnnxInferenceBackend::OnnxInferenceBackend(std::string model_path,
   Ort::TypeInfo input_type = impl_->session.GetInputTypeInfo(0);
   const auto shape_info = input_type.GetTensorTypeAndShapeInfo();
   std::vector<int64_t> dims = shape_info.GetShape();
+  impl_->input_onnx_type = shape_info.GetElementType();
+  impl_->input_type = ToElementType(impl_->input_onnx_type);
   if (dims.size() == 4u) {
-    // NCHW: [1, C, H, W] or NHWC: [1, H, W, C]
+    // NCHW: [N, C, H, W] or NHWC: [N, H, W, C]; N is 1 or symbolic (reported as -1).
+    impl_->dynamic_batch = dims[0] < 0;
     if (dims[1] == kNumChannels) {
       impl_->input_is_nchw = true;
       impl_->input_height = static_cast<std::uint32_t>(dims[2]);
@@ -89,7 +614,7 @@ OnnxInferenceBackend::OnnxInferenceBackend(std::string model_path,
       impl_->input_height = static_cast<std::uint32_t>(dims[1]);
       impl_->input_width = static_cast<std::uint32_t>(dims[2]);
     } else {
-      throw std::runtime_error("OnnxInferenceBackend: expected input shape [1,3,H,W] or [1,H,W,3]");
+      throw std::runtime_error("OnnxInferenceBackend: expected input shape [N,3,H,W] or [N,H,W,3]");
     }
   } else {
     throw std::runtime_error("OnnxInferenceBackend: expected 4D input");
@@ -116,24 +641,58 @@ OnnxInferenceBackend::OnnxInferenceBackend(std::string model_path,
   } else {
     throw std::runtime_error("OnnxInferenceBackend: model must have 1 output (YOLO-style) or at least 3 outputs (boxes, scores, class_ids)");
   }
+
+  // Outputs are preallocated and bound once per run context if every decoded output has a known
+  // shape apart from the batch dimension; data-dependent shapes (e.g. [N, 4]) are left to ORT.
+  impl_->preallocate_outputs = true;
+  for (const char* name : impl_->output_name_ptrs) {
+    Impl::OutputSpec spec;
+    for (std::size_t i = 0; i < num_outputs; ++i) {
+      if (impl_->session.GetOutputNameAllocated(i, allocator).get() == std::string_view(name)) {
+        const auto info = impl_->session.GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo();
+        spec = {info.GetShape(), info.GetElementType()};
+        break;
+      }
+    }
+    const auto& out_dims = spec.shape;
+    bool known = !out_dims.empty() && OutputElementSize(spec.type) > 0 &&
+                 (out_dims[0] < 0 || (out_dims[0] == 1 && !impl_->dynamic_batch));
+    for (std::size_t d = 1; known && d < out_dims.size(); ++d) {
+      known = out_dims[d] > 0;
+    }
+    impl_->preallocate_outputs = impl_->preallocate_outputs && known;
+    impl_->output_specs.push_back(std::move(spec));
+  }
 }
 
+OnnxInferenceBackend::OnnxInferenceBackend(std::shared_ptr<Impl> impl)
+    : impl_(std::move(impl)), contexts_(std::make_unique<Contexts>()) {}
+
 OnnxInferenceBackend::~OnnxInferenceBackend() = default;
 
+std::unique_ptr<IInferenceBackend> OnnxInferenceBackend::clone() const {
+  // Private constructor, so no make_unique; the session and its weights are shared, not copied.
+  return std::unique_ptr<IInferenceBackend>(new OnnxInferenceBackend(impl_));
+}
+
 std::expected<void, normitri::core::PipelineError>
 OnnxInferenceBackend::validate_input(const normitri::core::Frame& input) const {
   if (input.empty()) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
-  if (input.format() != normitri::core::PixelFormat::Float32Planar) {
+  // Any 3-channel tensor (Float32Planar, or RGB8/BGR8 for uint8 models) of the model's dtype.
+  if (normitri::core::channel_count(input.format()) != kNumChannels ||
+      input.element_type() != impl_->input_type) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
   if (input.width() != impl_->input_width || input.height() != impl_->input_height) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
-  const std::size_t expected_bytes =
-      static_cast<std::size_t>(impl_->input_height) * impl_->input_width * kNumChannels * sizeof(float);
-  if (input.size_bytes() < expected_bytes) {
+  if (input.size_bytes() < input.min_bytes()) {
+    return std::unexpected(normitri::core::PipelineError::InvalidFrame);
+  }
+  // CHW frames (e.g. from PreprocessStage) are only fed as-is; NHWC models need HWC.
+  if (input.layout() == normitri::core::TensorLayout::CHW && !impl_->input_is_nchw) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
   return {};
@@ -145,162 +704,70 @@ OnnxInferenceBackend::infer(const normitri::core::Frame& input) {
   if (!valid) {
     return std::unexpected(valid.error());
   }
-
-  const std::uint32_t h = input.height();
-  const std::uint32_t w = input.width();
-  const float* src = reinterpret_cast<const float*>(input.data().data());
-
-  Ort::MemoryInfo mem_info = CpuMemoryInfo();
-  Ort::Value input_tensor{nullptr};
-
-  if (impl_->input_is_nchw) {
-    const std::size_t num_floats = static_cast<std::size_t>(1) * kNumChannels * h * w;
-    impl_->nchw_buffer.resize(num_floats);
-    HwcToNchw(src, h, w, impl_->nchw_buffer.data());
-    const std::array<int64_t, 4> shape{1, static_cast<int64_t>(kNumChannels),
-                                        static_cast<int64_t>(h), static_cast<int64_t>(w)};
-    input_tensor = Ort::Value::CreateTensor<float>(
-        mem_info, impl_->nchw_buffer.data(), num_floats * sizeof(float),
-        shape.data(), shape.size());
-  } else {
-    const std::size_t num_floats = static_cast<std::size_t>(1) * h * w * kNumChannels;
-    const std::array<int64_t, 4> shape{1, static_cast<int64_t>(h), static_cast<int64_t>(w),
-                                        static_cast<int64_t>(kNumChannels)};
-    input_tensor = Ort::Value::CreateTensor<float>(
-        mem_info, const_cast<float*>(src), num_floats * sizeof(float),
-        shape.data(), shape.size());
+  auto results = impl_->run_results(*contexts_, std::span<const normitri::core::Frame>(&input, 1));
+  if (!results) {
+    return std::unexpected(results.error());
   }
+  return std::move(results->front());
+}
 
-  const char* input_names_c[] = {impl_->input_name.c_str()};
-  Ort::RunOptions run_options;
-
-  std::vector<Ort::Value> outputs;
-  try {
-    outputs = impl_->session.Run(
-        run_options,
-        input_names_c, &input_tensor, 1,
-        impl_->output_name_ptrs.data(), impl_->output_name_ptrs.size());
-  } catch (const Ort::Exception& e) {
-    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+std::expected<std::vector<InferenceResult>, normitri::core::PipelineError>
+OnnxInferenceBackend::infer_batch(std::span<const normitri::core::Frame> inputs) {
+  // Fixed-batch models (batch dimension 1) run one frame per session call.
+  if (!impl_->dynamic_batch || inputs.size() <= 1) {
+    return IInferenceBackend::infer_batch(inputs);
   }
-
-  InferenceResult result;
-
-  if (impl_->use_yolo_single_output) {
-    // Single output: [1, N, 6] or [1, 6, N] — (xmin, ymin, xmax, ymax, score, class_id)
-    if (outputs.size() != 1u) {
-      return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+  for (const auto& frame : inputs) {
+    auto valid = validate_input(frame);
+    if (!valid) {
+      return std::unexpected(valid.error());
     }
-    Ort::Value& out = outputs[0];
-    const auto shape = out.GetTensorTypeAndShapeInfo().GetShape();
-    const float* data = out.GetTensorData<float>();
-    int64_t n = 0;
-    bool rows_are_n6 = false;  // true: [1, N, 6]; false: [1, 6, N]
-    if (shape.size() == 3u && shape[0] == 1 && shape[2] == 6) {
-      n = shape[1];
-      rows_are_n6 = true;
-    } else if (shape.size() == 3u && shape[0] == 1 && shape[1] == 6) {
-      n = shape[2];
-      rows_are_n6 = false;
-    }
-    if (n <= 0) {
-      return std::unexpected(normitri::core::PipelineError::InferenceFailed);
-    }
-    result.num_detections = static_cast<std::uint32_t>(n);
-    result.boxes.reserve(static_cast<std::size_t>(n) * 4u);
-    result.scores.reserve(static_cast<std::size_t>(n));
-    result.class_ids.reserve(static_cast<std::size_t>(n));
-    const int64_t stride = rows_are_n6 ? 6 : static_cast<int64_t>(n);
-    for (int64_t i = 0; i < n; ++i) {
-      if (rows_are_n6) {
-        const float* row = data + i * 6;
-        result.boxes.push_back(row[0]);
-        result.boxes.push_back(row[1]);
-        result.boxes.push_back(row[2]);
-        result.boxes.push_back(row[3]);
-        result.scores.push_back(row[4]);
-        result.class_ids.push_back(static_cast<int64_t>(row[5]));
-      } else {
-        result.boxes.push_back(data[0 * stride + i]);
-        result.boxes.push_back(data[1 * stride + i]);
-        result.boxes.push_back(data[2 * stride + i]);
-        result.boxes.push_back(data[3 * stride + i]);
-        result.scores.push_back(data[4 * stride + i]);
-        result.class_ids.push_back(static_cast<int64_t>(data[5 * stride + i]));
-      }
-    }
-    return result;
   }
+  return impl_->run_results(*contexts_, inputs);
+}
 
-  // Three-output path: boxes, scores, class_ids
-  if (outputs.size() < 3u) {
-    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+std::expected<void, normitri::core::PipelineError>
+OnnxInferenceBackend::infer_visit(std::span<const normitri::core::Frame> inputs,
+                                  const DetectionVisitor& visitor) {
+  for (const auto& frame : inputs) {
+    auto valid = validate_input(frame);
+    if (!valid) {
+      return std::unexpected(valid.error());
+    }
   }
-  Ort::Value& boxes_val = outputs[0];
-  Ort::Value& scores_val = outputs[1];
-  Ort::Value& classes_val = outputs[2];
-
-  auto boxes_info = boxes_val.GetTensorTypeAndShapeInfo();
-  auto scores_info = scores_val.GetTensorTypeAndShapeInfo();
-  auto classes_info = classes_val.GetTensorTypeAndShapeInfo();
-
-  const std::vector<int64_t> boxes_shape = boxes_info.GetShape();
-  const std::vector<int64_t> scores_shape = scores_info.GetShape();
-  const std::vector<int64_t> classes_shape = classes_info.GetShape();
-
-  // Support [1, N, 4], [1, 4, N], or [N, 4]; similarly [1, N] or [N] for scores/classes.
-  int64_t n = 0;
-  if (boxes_shape.size() == 3u && boxes_shape[0] == 1) {
-    n = boxes_shape[1];
-    if (boxes_shape[2] != 4) n = 0;
-  } else if (boxes_shape.size() == 3u && boxes_shape[2] == 1 && boxes_shape[1] == 4) {
-    n = boxes_shape[0];
-  } else if (boxes_shape.size() == 2u && boxes_shape[1] == 4) {
-    n = boxes_shape[0];
+  if (inputs.empty()) {
+    return {};
   }
-  if (n <= 0) {
-    return std::unexpected(normitri::core::PipelineError::InferenceFailed);
+  if (impl_->dynamic_batch) {
+    return impl_->run(*contexts_, inputs, visitor);
   }
-
-  const float* boxes_data = boxes_val.GetTensorData<float>();
-  const float* scores_data = scores_val.GetTensorData<float>();
-  const int64_t* classes_data = classes_val.GetTensorData<int64_t>();
-
-  result.num_detections = static_cast<std::uint32_t>(n);
-  result.boxes.reserve(static_cast<std::size_t>(n) * 4u);
-  result.scores.reserve(static_cast<std::size_t>(n));
-  result.class_ids.reserve(static_cast<std::size_t>(n));
-
-  const bool boxes_is_n4 = (boxes_shape.size() == 3u && boxes_shape[2] == 4) ||
-                           (boxes_shape.size() == 2u && boxes_shape[1] == 4);
-  const std::int64_t boxes_stride = boxes_is_n4 ? 4 : static_cast<std::int64_t>(n);
-
-  for (int64_t i = 0; i < n; ++i) {
-    if (boxes_is_n4) {
-      const float* row = boxes_data + i * 4;
-      result.boxes.push_back(row[0]);
-      result.boxes.push_back(row[1]);
-      result.boxes.push_back(row[2]);
-      result.boxes.push_back(row[3]);
-    } else {
-      result.boxes.push_back(boxes_data[0 * boxes_stride + i]);
-      result.boxes.push_back(boxes_data[1 * boxes_stride + i]);
-      result.boxes.push_back(boxes_data[2 * boxes_stride + i]);
-      result.boxes.push_back(boxes_data[3 * boxes_stride + i]);
+  // Fixed-batch models run one frame per session call.
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    auto ran = impl_->run(*contexts_, inputs.subspan(i, 1), visitor, i);
+    if (!ran) {
+      return ran;
     }
-    result.scores.push_back(scores_data[i]);
-    result.class_ids.push_back(classes_data[i]);
   }
+  return {};
+}
+
+bool OnnxInferenceBackend::supports_dynamic_batch() const noexcept {
+  return impl_->dynamic_batch;
+}
 
-  return result;
+OnnxCacheStatus OnnxInferenceBackend::cache_status() const noexcept {
+  return impl_->cache_status;
 }
 
 void OnnxInferenceBackend::warmup() {
-  const std::size_t num_bytes =
-      static_cast<std::size_t>(impl_->input_height) * impl_->input_width * kNumChannels * sizeof(float);
+  using namespace normitri::core;
+  const std::size_t num_bytes = Frame::min_bytes(impl_->input_width, impl_->input_height,
+                                                 PixelFormat::Float32Planar, impl_->input_type);
   std::vector<std::byte> buffer(num_bytes, std::byte{0});
-  normitri::core::Frame frame(impl_->input_width, impl_->input_height,
-                              normitri::core::PixelFormat::Float32Planar, std::move(buffer));
+  Frame frame(impl_->input_width, impl_->input_height, PixelFormat::Float32Planar,
+              std::move(buffer));
+  frame.set_element_type(impl_->input_type);
+  frame.set_layout(impl_->input_is_nchw ? TensorLayout::CHW : TensorLayout::HWC);
   (void)infer(frame);
 }
 
@@ -0,0 +1,79 @@
+#include "onnx_model_cache.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace normitri::vision::detail {
+
+namespace {
+
+constexpr std::uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+std::uint64_t fnv1a(std::uint64_t hash, const char* data, std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+std::string to_hex(std::uint64_t value) {
+  std::array<char, 17> buf{};
+  std::snprintf(buf.data(), buf.size(), "%016llx", static_cast<unsigned long long>(value));
+  return std::string(buf.data());
+}
+
+}  // namespace
+
+std::optional<std::uint64_t> hash_file(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return std::nullopt;
+  std::uint64_t hash = kFnvOffset;
+  std::array<char, 1 << 16> chunk{};
+  while (in) {
+    in.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    hash = fnv1a(hash, chunk.data(), static_cast<std::size_t>(in.gcount()));
+  }
+  if (in.bad()) return std::nullopt;
+  return hash;
+}
+
+std::filesystem::path optimized_model_cache_path(const std::filesystem::path& cache_dir,
+                                                 const std::filesystem::path& model_path,
+                                                 std::uint64_t model_hash,
+                                                 std::string_view variant) {
+  const std::uint64_t key = fnv1a(model_hash, variant.data(), variant.size());
+  return cache_dir / (model_path.stem().string() + "." + to_hex(key) + ".ort");
+}
+
+std::filesystem::path cache_temp_path(const std::filesystem::path& final_path) {
+  static std::atomic<std::uint64_t> counter{0};
+  const auto now = static_cast<std::uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+  const std::uint64_t unique = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ now ^
+                               (counter.fetch_add(1) * kFnvPrime);
+  std::filesystem::path temp = final_path;
+  temp += ".tmp-" + to_hex(unique) + ".ort";  // keeps the .ort extension ORT keys the format on
+  return temp;
+}
+
+bool publish_cache_file(const std::filesystem::path& temp_path,
+                        const std::filesystem::path& final_path) noexcept {
+  std::error_code ec;
+  std::filesystem::rename(temp_path, final_path, ec);
+  if (ec) {
+    std::filesystem::remove(temp_path, ec);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace normitri::vision::detail
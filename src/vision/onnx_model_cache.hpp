@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace normitri::vision::detail {
+
+/// 64-bit FNV-1a over a file's bytes; nullopt if the file cannot be read.
+[[nodiscard]] std::optional<std::uint64_t> hash_file(const std::filesystem::path& path);
+
+/// Path of the optimized-model cache entry for \p model_path in \p cache_dir:
+/// "<stem>.<key>.ort", where key mixes \p model_hash with \p variant (runtime version and the
+/// session options that shape the optimized graph). Any change to either gives a new entry.
+[[nodiscard]] std::filesystem::path optimized_model_cache_path(
+    const std::filesystem::path& cache_dir,
+    const std::filesystem::path& model_path,
+    std::uint64_t model_hash,
+    std::string_view variant);
+
+/// Unique temporary name next to \p final_path, for writing an entry before publishing it.
+[[nodiscard]] std::filesystem::path cache_temp_path(const std::filesystem::path& final_path);
+
+/// Atomically renames \p temp_path to \p final_path (readers see the old entry or the complete
+/// new one, never a partial file). Removes \p temp_path and returns false on failure.
+bool publish_cache_file(const std::filesystem::path& temp_path,
+                        const std::filesystem::path& final_path) noexcept;
+
+}  // namespace normitri::vision::detail
@@ -0,0 +1,191 @@
+#include <normitri/vision/preprocess_stage.hpp>
+#include <normitri/core/error.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/vision/simd_kernels.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace normitri::vision {
+
+namespace {
+
+constexpr std::size_t kPlanes = 3;
+
+/// Bilinear tap along one axis: value = (1 - w1) * src[i0] + w1 * src[i1].
+struct AxisTap {
+  std::uint32_t i0{0};
+  std::uint32_t i1{0};
+  float w1{0.f};
+};
+
+/// Pixel-center aligned taps, matching cv::resize with INTER_LINEAR (identity when src == dst).
+void compute_taps(std::uint32_t src, std::uint32_t dst, std::vector<AxisTap>& taps) {
+  taps.resize(dst);
+  const double ratio = static_cast<double>(src) / static_cast<double>(dst);
+  for (std::uint32_t d = 0; d < dst; ++d) {
+    double s = (static_cast<double>(d) + 0.5) * ratio - 0.5;
+    if (s < 0.0) s = 0.0;
+    auto i0 = static_cast<std::uint32_t>(std::floor(s));
+    AxisTap& tap = taps[d];
+    if (i0 + 1 >= src) {
+      tap = {src - 1, src - 1, 0.f};
+    } else {
+      tap = {i0, i0 + 1, static_cast<float>(s - static_cast<double>(i0))};
+    }
+  }
+}
+
+/// Per-thread scratch so concurrent Pipeline::run() calls never share state.
+struct Scratch {
+  std::vector<AxisTap> x_taps;
+  std::vector<AxisTap> y_taps;
+  std::array<std::vector<float>, 2> rows;  // horizontally resampled rows, planar (c * W + x)
+};
+
+thread_local Scratch t_scratch;
+
+/// Horizontally resample one uint8 interleaved source row into kPlanes float planes.
+void resample_row(const std::uint8_t* src,
+                  std::size_t src_channels,
+                  const std::array<std::uint32_t, kPlanes>& channel_map,
+                  const std::vector<AxisTap>& x_taps,
+                  float* out) {
+  const std::size_t w = x_taps.size();
+  for (std::size_t c = 0; c < kPlanes; ++c) {
+    const std::size_t sc = channel_map[c];
+    float* plane = out + c * w;
+    for (std::size_t x = 0; x < w; ++x) {
+      const AxisTap& t = x_taps[x];
+      const float a = static_cast<float>(src[t.i0 * src_channels + sc]);
+      const float b = static_cast<float>(src[t.i1 * src_channels + sc]);
+      plane[x] = a + t.w1 * (b - a);
+    }
+  }
+}
+
+bool is_rgb_order(normitri::core::PixelFormat f) {
+  return f == normitri::core::PixelFormat::RGB8 || f == normitri::core::PixelFormat::RGBA8;
+}
+
+}  // namespace
+
+PreprocessStage::PreprocessStage(PreprocessOptions options,
+                                 std::shared_ptr<normitri::core::BufferPool> pool)
+    : options_(options), pool_(std::move(pool)) {}
+
+std::expected<normitri::core::StageOutput, normitri::core::PipelineError>
+PreprocessStage::process(const normitri::core::Frame& input) {
+  normitri::core::Frame out;
+  auto written = process_into(input, out);
+  if (!written) {
+    return std::unexpected(written.error());
+  }
+  return normitri::core::StageOutput{std::move(out)};
+}
+
+std::expected<normitri::core::StageIntoResult, normitri::core::PipelineError>
+PreprocessStage::process_into(const normitri::core::Frame& input,
+                              normitri::core::Frame& output) {
+  using namespace normitri::core;
+
+  if (input.empty() || input.layout() != TensorLayout::HWC || options_.width == 0 ||
+      options_.height == 0) {
+    return std::unexpected(PipelineError::InvalidFrame);
+  }
+
+  std::uint32_t src_channels = 0;
+  switch (input.format()) {
+    case PixelFormat::Grayscale8: src_channels = 1; break;
+    case PixelFormat::RGB8:
+    case PixelFormat::BGR8: src_channels = 3; break;
+    case PixelFormat::RGBA8:
+    case PixelFormat::BGRA8: src_channels = 4; break;
+    default: return std::unexpected(PipelineError::InvalidFrame);
+  }
+  const std::uint32_t src_w = input.width();
+  const std::uint32_t src_h = input.height();
+  if (src_w == 0 || src_h == 0 ||
+      input.size_bytes() < Frame::min_bytes(src_w, src_h, input.format())) {
+    return std::unexpected(PipelineError::InvalidFrame);
+  }
+  const std::size_t src_step = input.size_bytes() / src_h;
+
+  std::array<std::uint32_t, kPlanes> channel_map{0, 1, 2};
+  if (src_channels == 1) {
+    channel_map = {0, 0, 0};
+  } else if (options_.channel_order != PixelFormat::Unknown &&
+             is_rgb_order(options_.channel_order) != is_rgb_order(input.format())) {
+    channel_map = {2, 1, 0};
+  }
+
+  const std::uint32_t dst_w = options_.width;
+  const std::uint32_t dst_h = options_.height;
+  const std::size_t plane_size = static_cast<std::size_t>(dst_w) * dst_h;
+  auto bytes = output.prepare(dst_w, dst_h, PixelFormat::Float32Planar,
+                              kPlanes * plane_size * sizeof(float), pool_.get());
+  output.set_layout(TensorLayout::CHW);
+  float* dst = reinterpret_cast<float*>(bytes.data());
+
+  const auto* src = reinterpret_cast<const std::uint8_t*>(input.data().data());
+  const float bias = -options_.mean * options_.scale;
+
+  if (src_w == dst_w && src_h == dst_h) {
+    // No resize: de-interleave, swap and normalize with the SIMD kernel, row by row.
+    const auto& kernels = simd::simd_kernels();
+    for (std::uint32_t y = 0; y < dst_h; ++y) {
+      float* out = dst + static_cast<std::size_t>(y) * dst_w;
+      kernels.u8_to_f32_planar(src + y * src_step, dst_w, src_channels, channel_map,
+                               options_.scale, bias, out, out + plane_size, out + 2 * plane_size);
+    }
+    return StageIntoResult::Written;
+  }
+
+  Scratch& scratch = t_scratch;
+  compute_taps(src_w, dst_w, scratch.x_taps);
+  compute_taps(src_h, dst_h, scratch.y_taps);
+  for (auto& row : scratch.rows) row.resize(kPlanes * dst_w);
+
+  // Source rows currently held in scratch.rows[0] / [1]; consecutive output rows reuse them.
+  std::array<std::int64_t, 2> cached{-1, -1};
+
+  for (std::uint32_t y = 0; y < dst_h; ++y) {
+    const AxisTap& ty = scratch.y_taps[y];
+    if (cached[0] != ty.i0) {
+      if (cached[1] == ty.i0) {
+        std::swap(scratch.rows[0], scratch.rows[1]);
+        std::swap(cached[0], cached[1]);
+      } else {
+        resample_row(src + ty.i0 * src_step, src_channels, channel_map, scratch.x_taps,
+                     scratch.rows[0].data());
+        cached[0] = ty.i0;
+      }
+    }
+    const bool blend = ty.w1 != 0.f;
+    if (blend && cached[1] != ty.i1) {
+      resample_row(src + ty.i1 * src_step, src_channels, channel_map, scratch.x_taps,
+                   scratch.rows[1].data());
+      cached[1] = ty.i1;
+    }
+
+    // out = ((1 - wy) * r0 + wy * r1 - mean) * scale, folded into two weights and a bias.
+    const float w0 = (1.f - ty.w1) * options_.scale;
+    const float w1 = ty.w1 * options_.scale;
+    for (std::size_t c = 0; c < kPlanes; ++c) {
+      const float* r0 = scratch.rows[0].data() + c * dst_w;
+      const float* r1 = scratch.rows[1].data() + c * dst_w;
+      float* out = dst + c * plane_size + static_cast<std::size_t>(y) * dst_w;
+      if (blend) {
+        for (std::uint32_t x = 0; x < dst_w; ++x) out[x] = r0[x] * w0 + r1[x] * w1 + bias;
+      } else {
+        for (std::uint32_t x = 0; x < dst_w; ++x) out[x] = r0[x] * w0 + bias;
+      }
+    }
+  }
+  return StageIntoResult::Written;
+}
+
+}  // namespace normitri::vision
@@ -3,16 +3,32 @@
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
 #include <opencv2/imgproc.hpp>
-#include <vector>
 
 namespace normitri::vision {
 
 ResizeStage::ResizeStage(std::uint32_t target_width,
-                         std::uint32_t target_height)
-    : target_width_(target_width), target_height_(target_height) {}
+                         std::uint32_t target_height,
+                         std::shared_ptr<normitri::core::BufferPool> pool)
+    : target_width_(target_width),
+      target_height_(target_height),
+      pool_(std::move(pool)) {}
 
 std::expected<normitri::core::StageOutput, normitri::core::PipelineError>
 ResizeStage::process(const normitri::core::Frame& input) {
+  normitri::core::Frame out;
+  auto written = process_into(input, out);
+  if (!written) {
+    return std::unexpected(written.error());
+  }
+  if (*written == normitri::core::StageIntoResult::PassThrough) {
+    return normitri::core::StageOutput{input};  // shares the buffer; no pixel copy
+  }
+  return normitri::core::StageOutput{std::move(out)};
+}
+
+std::expected<normitri::core::StageIntoResult, normitri::core::PipelineError>
+ResizeStage::process_into(const normitri::core::Frame& input,
+                          normitri::core::Frame& output) {
   if (input.empty()) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
@@ -25,19 +41,15 @@ ResizeStage::process(const normitri::core::Frame& input) {
   }
 
   if (input.width() == target_width_ && input.height() == target_height_) {
-    std::vector<std::byte> buf(input.data().begin(), input.data().end());
-    return StageOutput{
-        Frame(input.width(), input.height(), input.format(), std::move(buf))};
+    return StageIntoResult::PassThrough;
   }
 
-  cv::Mat mat_out;
-  cv::resize(*mat_in, mat_out,
-             cv::Size(static_cast<int>(target_width_),
-                      static_cast<int>(target_height_)),
-             0, 0, cv::INTER_LINEAR);
-
-  Frame out = detail::mat_to_frame(mat_out, input.format());
-  return StageOutput{std::move(out)};
+  output.prepare(target_width_, target_height_, input.format(),
+                 static_cast<std::size_t>(target_width_) * target_height_ * mat_in->elemSize(),
+                 pool_.get());
+  cv::Mat mat_out = detail::frame_mat(output, mat_in->type());
+  cv::resize(*mat_in, mat_out, mat_out.size(), 0, 0, cv::INTER_LINEAR);
+  return StageIntoResult::Written;
 }
 
 }  // namespace normitri::vision
@@ -0,0 +1,686 @@
+#include <normitri/vision/simd_kernels.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NORMITRI_SIMD_X86 1
+#include <immintrin.h>
+#define NORMITRI_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace normitri::vision::simd {
+
+namespace {
+
+// ---------------------------------------------------------------------------------------------
+// Scalar reference (also handles the tails of the vector kernels)
+// ---------------------------------------------------------------------------------------------
+
+void deinterleave3_f32_scalar(const float* src,
+                              std::size_t pixels,
+                              float* dst0,
+                              float* dst1,
+                              float* dst2) {
+  for (std::size_t i = 0; i < pixels; ++i) {
+    dst0[i] = src[3 * i + 0];
+    dst1[i] = src[3 * i + 1];
+    dst2[i] = src[3 * i + 2];
+  }
+}
+
+void u8_to_f32_planar_scalar(const std::uint8_t* src,
+                             std::size_t pixels,
+                             std::uint32_t src_channels,
+                             const std::array<std::uint32_t, 3>& channel_map,
+                             float scale,
+                             float bias,
+                             float* dst0,
+                             float* dst1,
+                             float* dst2) {
+  float* const dst[3] = {dst0, dst1, dst2};
+  for (std::size_t c = 0; c < 3; ++c) {
+    const std::uint8_t* s = src + channel_map[c];
+    float* d = dst[c];
+    for (std::size_t i = 0; i < pixels; ++i) {
+      d[i] = static_cast<float>(s[i * src_channels]) * scale + bias;
+    }
+  }
+}
+
+void u8_to_f32_scalar(const std::uint8_t* src,
+                      std::size_t count,
+                      float scale,
+                      float bias,
+                      float* dst) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = static_cast<float>(src[i]) * scale + bias;
+  }
+}
+
+std::size_t select_at_least_scalar(const float* src,
+                                   std::size_t count,
+                                   std::size_t stride,
+                                   float threshold,
+                                   std::uint32_t* indices) {
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    indices[n] = static_cast<std::uint32_t>(i);
+    n += !(src[i * stride] < threshold) ? 1u : 0u;  // branchless: always write, advance on keep
+  }
+  return n;
+}
+
+void suppress_overlaps_scalar(const BoxesSoA& b,
+                              std::size_t ref,
+                              std::size_t begin,
+                              std::size_t end,
+                              float iou_threshold,
+                              std::uint32_t* suppressed) {
+  const float rx1 = b.x1[ref];
+  const float ry1 = b.y1[ref];
+  const float rx2 = b.x2[ref];
+  const float ry2 = b.y2[ref];
+  const float ra = b.area[ref];
+  for (std::size_t j = begin; j < end; ++j) {
+    const float iw = std::max(0.f, std::min(rx2, b.x2[j]) - std::max(rx1, b.x1[j]));
+    const float ih = std::max(0.f, std::min(ry2, b.y2[j]) - std::max(ry1, b.y1[j]));
+    const float inter = iw * ih;
+    suppressed[j] |= inter > iou_threshold * (ra + b.area[j] - inter) ? 1u : 0u;
+  }
+}
+
+constexpr SimdKernels kScalarKernels{SimdLevel::Scalar, deinterleave3_f32_scalar,
+                                     u8_to_f32_planar_scalar, u8_to_f32_scalar,
+                                     select_at_least_scalar, suppress_overlaps_scalar};
+
+#ifdef NORMITRI_SIMD_X86
+
+/// Appends base + (set bits of \p mask) to \p indices; returns the new count.
+inline std::size_t append_mask(unsigned mask, std::size_t base, std::uint32_t* indices,
+                               std::size_t n) {
+  while (mask != 0) {
+    const auto lane = static_cast<std::size_t>(__builtin_ctz(mask));
+    indices[n++] = static_cast<std::uint32_t>(base + lane);
+    mask &= mask - 1;
+  }
+  return n;
+}
+
+/// Strided gathers use 32-bit lane offsets (up to 15 * stride); wider strides take the scalar path.
+constexpr bool gather_fits(std::size_t stride) {
+  return stride <= (std::size_t{1} << 31) / 16;
+}
+
+/// pshufb mask gathering byte \p channel of four consecutive pixels of \p stride bytes into the
+/// low dword (remaining bytes zeroed).
+NORMITRI_TARGET("ssse3")
+__m128i gather4_mask(std::uint32_t stride, std::uint32_t channel) {
+  const auto b = [&](std::uint32_t pixel) { return static_cast<char>(pixel * stride + channel); };
+  const char z = static_cast<char>(0x80);
+  return _mm_setr_epi8(b(0), b(1), b(2), b(3), z, z, z, z, z, z, z, z, z, z, z, z);
+}
+
+/// Pixels the vector loop must leave for the tail so 16-byte loads of \p groups groups of four
+/// pixels stay inside the source (3-channel groups are 12 bytes, so the last load reads ahead).
+constexpr std::size_t planar_reserve(std::uint32_t stride, std::size_t groups) {
+  const std::size_t bytes = (groups - 1) * 4 * stride + 16;
+  return (bytes + stride - 1) / stride;
+}
+
+// ---------------------------------------------------------------------------------------------
+// SSE4.1
+// ---------------------------------------------------------------------------------------------
+
+NORMITRI_TARGET("sse4.1")
+void deinterleave3_f32_sse41(const float* src,
+                             std::size_t pixels,
+                             float* dst0,
+                             float* dst1,
+                             float* dst2) {
+  std::size_t i = 0;
+  for (; i + 4 <= pixels; i += 4) {
+    const float* p = src + 3 * i;
+    const __m128 a = _mm_loadu_ps(p);      // x0 y0 z0 x1
+    const __m128 b = _mm_loadu_ps(p + 4);  // y1 z1 x2 y2
+    const __m128 c = _mm_loadu_ps(p + 8);  // z2 x3 y3 z3
+    const __m128 x = _mm_blend_ps(_mm_blend_ps(a, b, 0x4), c, 0x2);  // x0 x3 x2 x1
+    const __m128 y = _mm_blend_ps(_mm_blend_ps(a, b, 0x9), c, 0x4);  // y1 y0 y3 y2
+    const __m128 z = _mm_blend_ps(_mm_blend_ps(a, b, 0x2), c, 0x9);  // z2 z1 z0 z3
+    _mm_storeu_ps(dst0 + i, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 2, 3, 0)));
+    _mm_storeu_ps(dst1 + i, _mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 3, 0, 1)));
+    _mm_storeu_ps(dst2 + i, _mm_shuffle_ps(z, z, _MM_SHUFFLE(3, 0, 1, 2)));
+  }
+  deinterleave3_f32_scalar(src + 3 * i, pixels - i, dst0 + i, dst1 + i, dst2 + i);
+}
+
+NORMITRI_TARGET("sse4.1,ssse3")
+void u8_to_f32_planar_sse41(const std::uint8_t* src,
+                            std::size_t pixels,
+                            std::uint32_t src_channels,
+                            const std::array<std::uint32_t, 3>& channel_map,
+                            float scale,
+                            float bias,
+                            float* dst0,
+                            float* dst1,
+                            float* dst2) {
+  std::size_t i = 0;
+  if (src_channels == 3 || src_channels == 4) {
+    float* const dst[3] = {dst0, dst1, dst2};
+    const __m128i masks[3] = {gather4_mask(src_channels, channel_map[0]),
+                              gather4_mask(src_channels, channel_map[1]),
+                              gather4_mask(src_channels, channel_map[2])};
+    const __m128 vscale = _mm_set1_ps(scale);
+    const __m128 vbias = _mm_set1_ps(bias);
+    const std::size_t group = 4 * src_channels;
+    const std::size_t reserve = planar_reserve(src_channels, 2);
+    for (; i + reserve <= pixels; i += 8) {
+      const std::uint8_t* p = src + i * src_channels;
+      const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + group));
+      for (std::size_t c = 0; c < 3; ++c) {
+        const __m128 lo = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_shuffle_epi8(v0, masks[c])));
+        const __m128 hi = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_shuffle_epi8(v1, masks[c])));
+        _mm_storeu_ps(dst[c] + i, _mm_add_ps(_mm_mul_ps(lo, vscale), vbias));
+        _mm_storeu_ps(dst[c] + i + 4, _mm_add_ps(_mm_mul_ps(hi, vscale), vbias));
+      }
+    }
+  }
+  u8_to_f32_planar_scalar(src + i * src_channels, pixels - i, src_channels, channel_map, scale,
+                          bias, dst0 + i, dst1 + i, dst2 + i);
+}
+
+NORMITRI_TARGET("sse4.1")
+void u8_to_f32_sse41(const std::uint8_t* src,
+                     std::size_t count,
+                     float scale,
+                     float bias,
+                     float* dst) {
+  const __m128 vscale = _mm_set1_ps(scale);
+  const __m128 vbias = _mm_set1_ps(bias);
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128 f0 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(v));
+    const __m128 f1 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+    const __m128 f2 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    const __m128 f3 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12)));
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(f0, vscale), vbias));
+    _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(f1, vscale), vbias));
+    _mm_storeu_ps(dst + i + 8, _mm_add_ps(_mm_mul_ps(f2, vscale), vbias));
+    _mm_storeu_ps(dst + i + 12, _mm_add_ps(_mm_mul_ps(f3, vscale), vbias));
+  }
+  u8_to_f32_scalar(src + i, count - i, scale, bias, dst + i);
+}
+
+NORMITRI_TARGET("sse4.1")
+std::size_t select_at_least_sse41(const float* src,
+                                  std::size_t count,
+                                  std::size_t stride,
+                                  float threshold,
+                                  std::uint32_t* indices) {
+  if (stride != 1) return select_at_least_scalar(src, count, stride, threshold, indices);
+  const __m128 vt = _mm_set1_ps(threshold);
+  std::size_t n = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128 keep = _mm_cmpnlt_ps(_mm_loadu_ps(src + i), vt);
+    n = append_mask(static_cast<unsigned>(_mm_movemask_ps(keep)), i, indices, n);
+  }
+  const std::size_t tail = select_at_least_scalar(src + i, count - i, 1, threshold, indices + n);
+  for (std::size_t k = 0; k < tail; ++k) indices[n + k] += static_cast<std::uint32_t>(i);
+  return n + tail;
+}
+
+NORMITRI_TARGET("sse4.1")
+void suppress_overlaps_sse41(const BoxesSoA& b,
+                             std::size_t ref,
+                             std::size_t begin,
+                             std::size_t end,
+                             float iou_threshold,
+                             std::uint32_t* suppressed) {
+  const __m128 rx1 = _mm_set1_ps(b.x1[ref]);
+  const __m128 ry1 = _mm_set1_ps(b.y1[ref]);
+  const __m128 rx2 = _mm_set1_ps(b.x2[ref]);
+  const __m128 ry2 = _mm_set1_ps(b.y2[ref]);
+  const __m128 ra = _mm_set1_ps(b.area[ref]);
+  const __m128 thr = _mm_set1_ps(iou_threshold);
+  const __m128 zero = _mm_setzero_ps();
+  std::size_t j = begin;
+  for (; j + 4 <= end; j += 4) {
+    const __m128 iw = _mm_max_ps(_mm_sub_ps(_mm_min_ps(rx2, _mm_loadu_ps(b.x2 + j)),
+                                             _mm_max_ps(rx1, _mm_loadu_ps(b.x1 + j))),
+                                  zero);
+    const __m128 ih = _mm_max_ps(_mm_sub_ps(_mm_min_ps(ry2, _mm_loadu_ps(b.y2 + j)),
+                                             _mm_max_ps(ry1, _mm_loadu_ps(b.y1 + j))),
+                                  zero);
+    const __m128 inter = _mm_mul_ps(iw, ih);
+    const __m128 uni = _mm_sub_ps(_mm_add_ps(ra, _mm_loadu_ps(b.area + j)), inter);
+    const __m128i hit = _mm_castps_si128(_mm_cmpgt_ps(inter, _mm_mul_ps(thr, uni)));
+    auto* dst = reinterpret_cast<__m128i*>(suppressed + j);
+    _mm_storeu_si128(dst, _mm_or_si128(_mm_loadu_si128(dst), hit));
+  }
+  suppress_overlaps_scalar(b, ref, j, end, iou_threshold, suppressed);
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX2 + FMA
+// ---------------------------------------------------------------------------------------------
+
+NORMITRI_TARGET("avx2")
+std::size_t select_at_least_avx2(const float* src,
+                                 std::size_t count,
+                                 std::size_t stride,
+                                 float threshold,
+                                 std::uint32_t* indices) {
+  if (!gather_fits(stride)) {
+    return select_at_least_scalar(src, count, stride, threshold, indices);
+  }
+  const __m256 vt = _mm256_set1_ps(threshold);
+  const auto s = static_cast<int>(stride);
+  // Element offsets of lanes 0..7; strided rows (e.g. the score column of [N, 6]) are gathered.
+  const __m256i lane_offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                  _mm256_set1_epi32(s));
+  std::size_t n = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const float* base = src + i * stride;
+    const __m256 v = stride == 1 ? _mm256_loadu_ps(base)
+                                 : _mm256_i32gather_ps(base, lane_offsets, 4);
+    const __m256 keep = _mm256_cmp_ps(v, vt, _CMP_NLT_UQ);
+    n = append_mask(static_cast<unsigned>(_mm256_movemask_ps(keep)), i, indices, n);
+  }
+  const std::size_t tail =
+      select_at_least_scalar(src + i * stride, count - i, stride, threshold, indices + n);
+  for (std::size_t k = 0; k < tail; ++k) indices[n + k] += static_cast<std::uint32_t>(i);
+  return n + tail;
+}
+
+NORMITRI_TARGET("avx2")
+void deinterleave3_f32_avx2(const float* src,
+                            std::size_t pixels,
+                            float* dst0,
+                            float* dst1,
+                            float* dst2) {
+  // After blending, lane k of channel ch holds the pixel at these positions; permute them back.
+  const __m256i idx0 = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+  const __m256i idx1 = _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6);
+  const __m256i idx2 = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);
+  std::size_t i = 0;
+  for (; i + 8 <= pixels; i += 8) {
+    const float* p = src + 3 * i;
+    const __m256 a = _mm256_loadu_ps(p);
+    const __m256 b = _mm256_loadu_ps(p + 8);
+    const __m256 c = _mm256_loadu_ps(p + 16);
+    const __m256 x = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24);
+    const __m256 y = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49);
+    const __m256 z = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92);
+    _mm256_storeu_ps(dst0 + i, _mm256_permutevar8x32_ps(x, idx0));
+    _mm256_storeu_ps(dst1 + i, _mm256_permutevar8x32_ps(y, idx1));
+    _mm256_storeu_ps(dst2 + i, _mm256_permutevar8x32_ps(z, idx2));
+  }
+  deinterleave3_f32_sse41(src + 3 * i, pixels - i, dst0 + i, dst1 + i, dst2 + i);
+}
+
+NORMITRI_TARGET("avx2,fma")
+void u8_to_f32_planar_avx2(const std::uint8_t* src,
+                           std::size_t pixels,
+                           std::uint32_t src_channels,
+                           const std::array<std::uint32_t, 3>& channel_map,
+                           float scale,
+                           float bias,
+                           float* dst0,
+                           float* dst1,
+                           float* dst2) {
+  std::size_t i = 0;
+  if (src_channels == 3 || src_channels == 4) {
+    float* const dst[3] = {dst0, dst1, dst2};
+    const __m128i masks[3] = {gather4_mask(src_channels, channel_map[0]),
+                              gather4_mask(src_channels, channel_map[1]),
+                              gather4_mask(src_channels, channel_map[2])};
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vbias = _mm256_set1_ps(bias);
+    const std::size_t group = 4 * src_channels;
+    const std::size_t reserve = planar_reserve(src_channels, 2);
+    for (; i + reserve <= pixels; i += 8) {
+      const std::uint8_t* p = src + i * src_channels;
+      const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + group));
+      for (std::size_t c = 0; c < 3; ++c) {
+        const __m128i bytes =
+            _mm_unpacklo_epi32(_mm_shuffle_epi8(v0, masks[c]), _mm_shuffle_epi8(v1, masks[c]));
+        const __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        _mm256_storeu_ps(dst[c] + i, _mm256_fmadd_ps(f, vscale, vbias));
+      }
+    }
+  }
+  u8_to_f32_planar_scalar(src + i * src_channels, pixels - i, src_channels, channel_map, scale,
+                          bias, dst0 + i, dst1 + i, dst2 + i);
+}
+
+NORMITRI_TARGET("avx2,fma")
+void u8_to_f32_avx2(const std::uint8_t* src,
+                    std::size_t count,
+                    float scale,
+                    float bias,
+                    float* dst) {
+  const __m256 vscale = _mm256_set1_ps(scale);
+  const __m256 vbias = _mm256_set1_ps(bias);
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m256 f0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+    const __m256 f1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+    _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(f0, vscale, vbias));
+    _mm256_storeu_ps(dst + i + 8, _mm256_fmadd_ps(f1, vscale, vbias));
+  }
+  u8_to_f32_scalar(src + i, count - i, scale, bias, dst + i);
+}
+
+NORMITRI_TARGET("avx2")
+void suppress_overlaps_avx2(const BoxesSoA& b,
+                            std::size_t ref,
+                            std::size_t begin,
+                            std::size_t end,
+                            float iou_threshold,
+                            std::uint32_t* suppressed) {
+  const __m256 rx1 = _mm256_set1_ps(b.x1[ref]);
+  const __m256 ry1 = _mm256_set1_ps(b.y1[ref]);
+  const __m256 rx2 = _mm256_set1_ps(b.x2[ref]);
+  const __m256 ry2 = _mm256_set1_ps(b.y2[ref]);
+  const __m256 ra = _mm256_set1_ps(b.area[ref]);
+  const __m256 thr = _mm256_set1_ps(iou_threshold);
+  const __m256 zero = _mm256_setzero_ps();
+  std::size_t j = begin;
+  for (; j + 8 <= end; j += 8) {
+    const __m256 iw = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(rx2, _mm256_loadu_ps(b.x2 + j)),
+                                                  _mm256_max_ps(rx1, _mm256_loadu_ps(b.x1 + j))),
+                                    zero);
+    const __m256 ih = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(ry2, _mm256_loadu_ps(b.y2 + j)),
+                                                  _mm256_max_ps(ry1, _mm256_loadu_ps(b.y1 + j))),
+                                    zero);
+    const __m256 inter = _mm256_mul_ps(iw, ih);
+    const __m256 uni = _mm256_sub_ps(_mm256_add_ps(ra, _mm256_loadu_ps(b.area + j)), inter);
+    const __m256i hit =
+        _mm256_castps_si256(_mm256_cmp_ps(inter, _mm256_mul_ps(thr, uni), _CMP_GT_OQ));
+    auto* dst = reinterpret_cast<__m256i*>(suppressed + j);
+    _mm256_storeu_si256(dst, _mm256_or_si256(_mm256_loadu_si256(dst), hit));
+  }
+  suppress_overlaps_scalar(b, ref, j, end, iou_threshold, suppressed);
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX-512F
+// ---------------------------------------------------------------------------------------------
+
+// GCC's AVX-512 conversion intrinsics seed their pass-through operand with a self-initialized
+// "undefined" register, which -Wmaybe-uninitialized reports once inlined here; the gather macro
+// casts its all-ones mask through a signed type, which -Wsign-conversion reports.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#endif
+
+/// Two-step permute indices for channel \p ch of 16 pixels spread over three registers (a, b, c):
+/// first[k] picks stream position 3k+ch from a:b, second[k] keeps it or takes it from c.
+struct Deinterleave512Indices {
+  std::array<std::int32_t, 16> first{};
+  std::array<std::int32_t, 16> second{};
+};
+
+constexpr Deinterleave512Indices deinterleave512_indices(std::int32_t ch) {
+  Deinterleave512Indices idx;
+  for (std::int32_t k = 0; k < 16; ++k) {
+    const std::int32_t pos = 3 * k + ch;
+    const auto lane = static_cast<std::size_t>(k);
+    idx.first[lane] = pos < 32 ? pos : 0;
+    idx.second[lane] = pos < 32 ? k : 16 + (pos - 32);
+  }
+  return idx;
+}
+
+constexpr std::array<Deinterleave512Indices, 3> kDeinterleave512 = {
+    deinterleave512_indices(0), deinterleave512_indices(1), deinterleave512_indices(2)};
+
+NORMITRI_TARGET("avx512f")
+void deinterleave3_f32_avx512(const float* src,
+                              std::size_t pixels,
+                              float* dst0,
+                              float* dst1,
+                              float* dst2) {
+  float* const dst[3] = {dst0, dst1, dst2};
+  __m512i first[3];
+  __m512i second[3];
+  for (std::size_t c = 0; c < 3; ++c) {
+    first[c] = _mm512_loadu_si512(kDeinterleave512[c].first.data());
+    second[c] = _mm512_loadu_si512(kDeinterleave512[c].second.data());
+  }
+  std::size_t i = 0;
+  for (; i + 16 <= pixels; i += 16) {
+    const float* p = src + 3 * i;
+    const __m512 a = _mm512_loadu_ps(p);
+    const __m512 b = _mm512_loadu_ps(p + 16);
+    const __m512 c = _mm512_loadu_ps(p + 32);
+    for (std::size_t ch = 0; ch < 3; ++ch) {
+      const __m512 ab = _mm512_permutex2var_ps(a, first[ch], b);
+      _mm512_storeu_ps(dst[ch] + i, _mm512_permutex2var_ps(ab, second[ch], c));
+    }
+  }
+  deinterleave3_f32_avx2(src + 3 * i, pixels - i, dst0 + i, dst1 + i, dst2 + i);
+}
+
+NORMITRI_TARGET("avx512f,avx2,fma")
+void u8_to_f32_planar_avx512(const std::uint8_t* src,
+                             std::size_t pixels,
+                             std::uint32_t src_channels,
+                             const std::array<std::uint32_t, 3>& channel_map,
+                             float scale,
+                             float bias,
+                             float* dst0,
+                             float* dst1,
+                             float* dst2) {
+  std::size_t i = 0;
+  if (src_channels == 3 || src_channels == 4) {
+    float* const dst[3] = {dst0, dst1, dst2};
+    const __m128i masks[3] = {gather4_mask(src_channels, channel_map[0]),
+                              gather4_mask(src_channels, channel_map[1]),
+                              gather4_mask(src_channels, channel_map[2])};
+    const __m512 vscale = _mm512_set1_ps(scale);
+    const __m512 vbias = _mm512_set1_ps(bias);
+    const std::size_t group = 4 * src_channels;
+    const std::size_t reserve = planar_reserve(src_channels, 4);
+    for (; i + reserve <= pixels; i += 16) {
+      const std::uint8_t* p = src + i * src_channels;
+      const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + group));
+      const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2 * group));
+      const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 3 * group));
+      for (std::size_t c = 0; c < 3; ++c) {
+        const __m128i b01 =
+            _mm_unpacklo_epi32(_mm_shuffle_epi8(v0, masks[c]), _mm_shuffle_epi8(v1, masks[c]));
+        const __m128i b23 =
+            _mm_unpacklo_epi32(_mm_shuffle_epi8(v2, masks[c]), _mm_shuffle_epi8(v3, masks[c]));
+        const __m512 f = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_unpacklo_epi64(b01, b23)));
+        _mm512_storeu_ps(dst[c] + i, _mm512_fmadd_ps(f, vscale, vbias));
+      }
+    }
+  }
+  u8_to_f32_planar_avx2(src + i * src_channels, pixels - i, src_channels, channel_map, scale,
+                        bias, dst0 + i, dst1 + i, dst2 + i);
+}
+
+NORMITRI_TARGET("avx512f,avx2,fma")
+void u8_to_f32_avx512(const std::uint8_t* src,
+                      std::size_t count,
+                      float scale,
+                      float bias,
+                      float* dst) {
+  const __m512 vscale = _mm512_set1_ps(scale);
+  const __m512 vbias = _mm512_set1_ps(bias);
+  std::size_t i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+    const __m512 f0 = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(v0));
+    const __m512 f1 = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(v1));
+    _mm512_storeu_ps(dst + i, _mm512_fmadd_ps(f0, vscale, vbias));
+    _mm512_storeu_ps(dst + i + 16, _mm512_fmadd_ps(f1, vscale, vbias));
+  }
+  u8_to_f32_avx2(src + i, count - i, scale, bias, dst + i);
+}
+
+NORMITRI_TARGET("avx512f")
+std::size_t select_at_least_avx512(const float* src,
+                                   std::size_t count,
+                                   std::size_t stride,
+                                   float threshold,
+                                   std::uint32_t* indices) {
+  if (!gather_fits(stride)) {
+    return select_at_least_scalar(src, count, stride, threshold, indices);
+  }
+  const __m512 vt = _mm512_set1_ps(threshold);
+  const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m512i lane_offsets =
+      _mm512_mullo_epi32(lanes, _mm512_set1_epi32(static_cast<int>(stride)));
+  std::size_t n = 0;
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const float* base = src + i * stride;
+    const __m512 v = stride == 1 ? _mm512_loadu_ps(base)
+                                 : _mm512_i32gather_ps(lane_offsets, base, 4);
+    const __mmask16 keep = _mm512_cmp_ps_mask(v, vt, _CMP_NLT_UQ);
+    // Compress the kept lane indices straight into the output.
+    const __m512i idx = _mm512_add_epi32(lanes, _mm512_set1_epi32(static_cast<int>(i)));
+    _mm512_mask_compressstoreu_epi32(indices + n, keep, idx);
+    n += static_cast<std::size_t>(__builtin_popcount(keep));
+  }
+  const std::size_t tail =
+      select_at_least_scalar(src + i * stride, count - i, stride, threshold, indices + n);
+  for (std::size_t k = 0; k < tail; ++k) indices[n + k] += static_cast<std::uint32_t>(i);
+  return n + tail;
+}
+
+NORMITRI_TARGET("avx512f")
+void suppress_overlaps_avx512(const BoxesSoA& b,
+                              std::size_t ref,
+                              std::size_t begin,
+                              std::size_t end,
+                              float iou_threshold,
+                              std::uint32_t* suppressed) {
+  const __m512 rx1 = _mm512_set1_ps(b.x1[ref]);
+  const __m512 ry1 = _mm512_set1_ps(b.y1[ref]);
+  const __m512 rx2 = _mm512_set1_ps(b.x2[ref]);
+  const __m512 ry2 = _mm512_set1_ps(b.y2[ref]);
+  const __m512 ra = _mm512_set1_ps(b.area[ref]);
+  const __m512 thr = _mm512_set1_ps(iou_threshold);
+  const __m512 zero = _mm512_setzero_ps();
+  const __m512i ones = _mm512_set1_epi32(-1);
+  std::size_t j = begin;
+  for (; j + 16 <= end; j += 16) {
+    const __m512 iw = _mm512_max_ps(_mm512_sub_ps(_mm512_min_ps(rx2, _mm512_loadu_ps(b.x2 + j)),
+                                                  _mm512_max_ps(rx1, _mm512_loadu_ps(b.x1 + j))),
+                                    zero);
+    const __m512 ih = _mm512_max_ps(_mm512_sub_ps(_mm512_min_ps(ry2, _mm512_loadu_ps(b.y2 + j)),
+                                                  _mm512_max_ps(ry1, _mm512_loadu_ps(b.y1 + j))),
+                                    zero);
+    const __m512 inter = _mm512_mul_ps(iw, ih);
+    const __m512 uni = _mm512_sub_ps(_mm512_add_ps(ra, _mm512_loadu_ps(b.area + j)), inter);
+    const __mmask16 hit = _mm512_cmp_ps_mask(inter, _mm512_mul_ps(thr, uni), _CMP_GT_OQ);
+    // Masked store: only the overlapping lanes are written, the rest keep their flag.
+    _mm512_mask_storeu_epi32(suppressed + j, hit, ones);
+  }
+  suppress_overlaps_scalar(b, ref, j, end, iou_threshold, suppressed);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+constexpr SimdKernels kSse41Kernels{SimdLevel::SSE41, deinterleave3_f32_sse41,
+                                    u8_to_f32_planar_sse41, u8_to_f32_sse41,
+                                    select_at_least_sse41, suppress_overlaps_sse41};
+constexpr SimdKernels kAvx2Kernels{SimdLevel::AVX2, deinterleave3_f32_avx2,
+                                   u8_to_f32_planar_avx2, u8_to_f32_avx2, select_at_least_avx2,
+                                   suppress_overlaps_avx2};
+constexpr SimdKernels kAvx512Kernels{SimdLevel::AVX512, deinterleave3_f32_avx512,
+                                     u8_to_f32_planar_avx512, u8_to_f32_avx512,
+                                     select_at_least_avx512, suppress_overlaps_avx512};
+
+#endif  // NORMITRI_SIMD_X86
+
+SimdLevel detect() noexcept {
+#ifdef NORMITRI_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") &&
+      __builtin_cpu_supports("fma")) {
+    return SimdLevel::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3")) {
+    return SimdLevel::SSE41;
+  }
+#endif
+  return SimdLevel::Scalar;
+}
+
+/// Level requested through NORMITRI_SIMD, or AVX512 (no cap) when unset or unrecognized.
+SimdLevel env_cap() noexcept {
+  const char* env = std::getenv("NORMITRI_SIMD");
+  if (env == nullptr) return SimdLevel::AVX512;
+  const std::string_view value(env);
+  if (value == "scalar") return SimdLevel::Scalar;
+  if (value == "sse4.1") return SimdLevel::SSE41;
+  if (value == "avx2") return SimdLevel::AVX2;
+  return SimdLevel::AVX512;
+}
+
+}  // namespace
+
+SimdLevel detected_simd_level() noexcept {
+  static const SimdLevel level = detect();
+  return level;
+}
+
+const SimdKernels& simd_kernels(SimdLevel level) noexcept {
+  if (level > detected_simd_level()) level = detected_simd_level();
+#ifdef NORMITRI_SIMD_X86
+  switch (level) {
+    case SimdLevel::AVX512:
+      return kAvx512Kernels;
+    case SimdLevel::AVX2:
+      return kAvx2Kernels;
+    case SimdLevel::SSE41:
+      return kSse41Kernels;
+    case SimdLevel::Scalar:
+      break;
+  }
+#endif
+  return kScalarKernels;
+}
+
+const SimdKernels& simd_kernels() noexcept {
+  static const SimdKernels& kernels = simd_kernels(env_cap());
+  return kernels;
+}
+
+const char* simd_level_name(SimdLevel level) noexcept {
+  switch (level) {
+    case SimdLevel::Scalar:
+      return "scalar";
+    case SimdLevel::SSE41:
+      return "sse4.1";
+    case SimdLevel::AVX2:
+      return "avx2";
+    case SimdLevel::AVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+}  // namespace normitri::vision::simd
@@ -0,0 +1,58 @@
+#include "tensor_copy.hpp"
+#include <normitri/vision/simd_kernels.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace normitri::vision::detail {
+
+namespace {
+
+/// Fixed-width copy; memcpy of sizeof(T) compiles to a single load/store and avoids
+/// type-punning the element storage.
+template <typename T>
+void hwc_to_chw_typed(const std::byte* hwc,
+                      std::uint32_t h,
+                      std::uint32_t w,
+                      std::uint32_t c,
+                      std::byte* chw) {
+  const std::size_t hw = static_cast<std::size_t>(h) * w;
+  for (std::size_t i = 0; i < hw; ++i) {
+    for (std::uint32_t ch = 0; ch < c; ++ch) {
+      std::memcpy(chw + (ch * hw + i) * sizeof(T), hwc + (i * c + ch) * sizeof(T), sizeof(T));
+    }
+  }
+}
+
+}  // namespace
+
+void hwc_to_chw(const std::byte* hwc,
+                std::uint32_t height,
+                std::uint32_t width,
+                std::uint32_t channels,
+                std::size_t element_size,
+                std::byte* chw) {
+  if (channels == 3 && element_size == 4) {
+    // Float32 (and any 4-byte type): vectorized de-interleave; moves bits only.
+    const std::size_t hw = static_cast<std::size_t>(height) * width;
+    auto* planes = reinterpret_cast<float*>(chw);
+    simd::simd_kernels().deinterleave3_f32(reinterpret_cast<const float*>(hwc), hw, planes,
+                                           planes + hw, planes + 2 * hw);
+    return;
+  }
+  switch (element_size) {
+    case 1:
+      hwc_to_chw_typed<std::uint8_t>(hwc, height, width, channels, chw);
+      break;
+    case 2:
+      hwc_to_chw_typed<std::uint16_t>(hwc, height, width, channels, chw);
+      break;
+    case 4:
+      hwc_to_chw_typed<std::uint32_t>(hwc, height, width, channels, chw);
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace normitri::vision::detail
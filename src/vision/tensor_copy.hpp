@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace normitri::vision::detail {
+
+/// Transposes an interleaved HWC tensor to planar CHW. \p element_size is the scalar width in
+/// bytes (1, 2 or 4, see core::element_size); values are moved bitwise, so any element type of
+/// that width works. \p hwc and \p chw must not overlap. The common 3-channel 4-byte case runs
+/// on the SIMD de-interleave kernel (see simd_kernels.hpp).
+void hwc_to_chw(const std::byte* hwc,
+                std::uint32_t height,
+                std::uint32_t width,
+                std::uint32_t channels,
+                std::size_t element_size,
+                std::byte* chw);
+
+}  // namespace normitri::vision::detail
@@ -1,4 +1,5 @@
 #include <normitri/vision/tensorrt_inference_backend.hpp>
+#include "tensor_copy.hpp"
 #include <normitri/core/error.hpp>
 #include <normitri/core/frame.hpp>
 #include <NvInfer.h>
@@ -15,18 +16,22 @@ namespace normitri::vision {
 
 namespace {
 
-constexpr int kNumChannels = 3;
-
-/// Copy HWC float buffer to NCHW.
-void HwcToNchw(const float* hwc, std::uint32_t h, std::uint32_t w, float* nchw) {
-  const std::size_t hw = static_cast<std::size_t>(h) * w;
-  for (std::uint32_t y = 0; y < h; ++y) {
-    for (std::uint32_t x = 0; x < w; ++x) {
-      const std::size_t src_idx = (static_cast<std::size_t>(y) * w + x) * kNumChannels;
-      nchw[0 * hw + y * w + x] = hwc[src_idx + 0];
-      nchw[1 * hw + y * w + x] = hwc[src_idx + 1];
-      nchw[2 * hw + y * w + x] = hwc[src_idx + 2];
-    }
+constexpr std::uint32_t kNumChannels = 3;
+
+/// Maps the engine's input data type to Frame's ElementType; throws for unsupported types.
+normitri::core::ElementType ToElementType(nvinfer1::DataType dt) {
+  switch (dt) {
+    case nvinfer1::DataType::kFLOAT:
+      return normitri::core::ElementType::Float32;
+    case nvinfer1::DataType::kHALF:
+      return normitri::core::ElementType::Float16;
+    case nvinfer1::DataType::kUINT8:
+      return normitri::core::ElementType::UInt8;
+    case nvinfer1::DataType::kINT8:
+      return normitri::core::ElementType::Int8;
+    default:
+      throw std::runtime_error(
+          "TensorRTInferenceBackend: input data type must be float, half, uint8 or int8");
   }
 }
 
@@ -39,19 +44,26 @@ class Logger : public nvinfer1::ILogger {
   }
 };
 
-}  // namespace
-
-struct TensorRTInferenceBackend::Impl {
+/// Deserialized engine (weights on the device); shared by a backend and its clones.
+struct Engine {
   Logger logger;
   std::unique_ptr<nvinfer1::IRuntime> runtime;
   std::unique_ptr<nvinfer1::ICudaEngine> engine;
+};
+
+}  // namespace
+
+struct TensorRTInferenceBackend::Impl {
+  std::shared_ptr<Engine> shared;  // outlives context
+  nvinfer1::ICudaEngine* engine{nullptr};
   std::unique_ptr<nvinfer1::IExecutionContext> context;
 
   std::uint32_t input_height{0};
   std::uint32_t input_width{0};
-  std::size_t input_num_floats{0};
+  std::size_t input_num_elements{0};
+  normitri::core::ElementType input_type{normitri::core::ElementType::Float32};
 
-  std::vector<float> nchw_buffer;
+  std::vector<std::byte> nchw_buffer;
   std::vector<void*> device_buffers;
   std::vector<std::vector<std::byte>> host_output_buffers;
   std::vector<std::size_t> output_num_elements;
@@ -61,8 +73,71 @@ struct TensorRTInferenceBackend::Impl {
   int num_io_tensors{0};
   int input_io_index{0};
   std::vector<std::string> io_tensor_names;
+
+  ~Impl();
+
+  /// Creates this instance's execution context and device/host buffers from the engine
+  /// description above. Throws on CUDA or TensorRT failure.
+  void allocate();
+  /// New Impl on the same engine with the same description and its own context and buffers.
+  [[nodiscard]] std::unique_ptr<Impl> replica() const;
 };
 
+TensorRTInferenceBackend::Impl::~Impl() {
+  for (void* ptr : device_buffers) {
+    if (ptr) {
+      cudaFree(ptr);
+    }
+  }
+}
+
+void TensorRTInferenceBackend::Impl::allocate() {
+  context.reset(engine->createExecutionContext());
+  if (!context) {
+    throw std::runtime_error("TensorRTInferenceBackend: createExecutionContext failed");
+  }
+  const auto count = static_cast<std::size_t>(num_io_tensors);
+  device_buffers.assign(count, nullptr);
+  host_output_buffers.assign(count, {});
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::string& name = io_tensor_names[i];
+    std::size_t element_size =
+        (output_dtypes[i] == nvinfer1::DataType::kFLOAT) ? sizeof(float) : sizeof(int64_t);
+    if (static_cast<int>(i) == input_io_index) {
+      element_size = normitri::core::element_size(input_type);
+    }
+    const std::size_t bytes = output_num_elements[i] * element_size;
+    void* ptr = nullptr;
+    cudaError_t err = cudaMalloc(&ptr, bytes);
+    if (err != cudaSuccess) {
+      throw std::runtime_error("TensorRTInferenceBackend: cudaMalloc failed for tensor " + name);
+    }
+    device_buffers[i] = ptr;
+    if (engine->getTensorIOMode(name.c_str()) != nvinfer1::TensorIOMode::kINPUT) {
+      host_output_buffers[i].resize(bytes);
+    }
+  }
+  nchw_buffer.resize(input_num_elements * normitri::core::element_size(input_type));
+}
+
+std::unique_ptr<TensorRTInferenceBackend::Impl> TensorRTInferenceBackend::Impl::replica() const {
+  auto copy = std::make_unique<Impl>();
+  copy->shared = shared;
+  copy->engine = engine;
+  copy->input_height = input_height;
+  copy->input_width = input_width;
+  copy->input_num_elements = input_num_elements;
+  copy->input_type = input_type;
+  copy->output_num_elements = output_num_elements;
+  copy->output_dtypes = output_dtypes;
+  copy->use_yolo_single_output = use_yolo_single_output;
+  copy->num_io_tensors = num_io_tensors;
+  copy->input_io_index = input_io_index;
+  copy->io_tensor_names = io_tensor_names;
+  copy->allocate();
+  return copy;
+}
+
 TensorRTInferenceBackend::TensorRTInferenceBackend(std::string engine_path) : impl_(std::make_unique<Impl>()) {
   std::ifstream f(engine_path, std::ios::binary | std::ios::ate);
   if (!f) {
@@ -75,18 +150,17 @@ TensorRTInferenceBackend::TensorRTInferenceBackend(std::string engine_path) : im
     throw std::runtime_error("TensorRTInferenceBackend: failed to read engine file");
   }
 
-  impl_->runtime.reset(nvinfer1::createInferRuntime(impl_->logger));
-  if (!impl_->runtime) {
+  auto shared = std::make_shared<Engine>();
+  shared->runtime.reset(nvinfer1::createInferRuntime(shared->logger));
+  if (!shared->runtime) {
     throw std::runtime_error("TensorRTInferenceBackend: createInferRuntime failed");
   }
-  impl_->engine.reset(impl_->runtime->deserializeCudaEngine(blob.data(), static_cast<std::size_t>(size)));
-  if (!impl_->engine) {
+  shared->engine.reset(shared->runtime->deserializeCudaEngine(blob.data(), static_cast<std::size_t>(size)));
+  if (!shared->engine) {
     throw std::runtime_error("TensorRTInferenceBackend: deserializeCudaEngine failed");
   }
-  impl_->context.reset(impl_->engine->createExecutionContext());
-  if (!impl_->context) {
-    throw std::runtime_error("TensorRTInferenceBackend: createExecutionContext failed");
-  }
+  impl_->engine = shared->engine.get();
+  impl_->shared = std::move(shared);
 
   impl_->num_io_tensors = impl_->engine->getNbIOTensors();
   if (impl_->num_io_tensors < 1) {
@@ -115,19 +189,18 @@ TensorRTInferenceBackend::TensorRTInferenceBackend(std::string engine_path) : im
   }
   // NCHW: dims.d[0]=N, d[1]=C, d[2]=H, d[3]=W (TensorRT 10 may use int64 in Dims; cast for our use)
   const int n = (dims.d[0] <= 0) ? 1 : static_cast<int>(dims.d[0]);
-  const int c = (dims.d[1] <= 0) ? kNumChannels : static_cast<int>(dims.d[1]);
+  const int c = (dims.d[1] <= 0) ? static_cast<int>(kNumChannels) : static_cast<int>(dims.d[1]);
   const int h = (dims.d[2] <= 0) ? 640 : static_cast<int>(dims.d[2]);
   const int w = (dims.d[3] <= 0) ? 640 : static_cast<int>(dims.d[3]);
-  if (c != kNumChannels) {
+  if (c != static_cast<int>(kNumChannels)) {
     throw std::runtime_error("TensorRTInferenceBackend: expected 3-channel input");
   }
   impl_->input_height = static_cast<std::uint32_t>(h);
   impl_->input_width = static_cast<std::uint32_t>(w);
-  impl_->input_num_floats = static_cast<std::size_t>(n) * static_cast<std::size_t>(c) * static_cast<std::size_t>(h) *
+  impl_->input_type = ToElementType(impl_->engine->getTensorDataType(input_name.c_str()));
+  impl_->input_num_elements = static_cast<std::size_t>(n) * static_cast<std::size_t>(c) * static_cast<std::size_t>(h) *
                             static_cast<std::size_t>(w);
 
-  impl_->device_buffers.resize(static_cast<std::size_t>(impl_->num_io_tensors), nullptr);
-  impl_->host_output_buffers.resize(static_cast<std::size_t>(impl_->num_io_tensors));
   impl_->output_num_elements.resize(static_cast<std::size_t>(impl_->num_io_tensors), 0);
   impl_->output_dtypes.resize(static_cast<std::size_t>(impl_->num_io_tensors), nvinfer1::DataType::kFLOAT);
 
@@ -135,7 +208,6 @@ TensorRTInferenceBackend::TensorRTInferenceBackend(std::string engine_path) : im
     const std::string& name = impl_->io_tensor_names[static_cast<std::size_t>(i)];
     nvinfer1::Dims d = impl_->engine->getTensorShape(name.c_str());
     nvinfer1::DataType dt = impl_->engine->getTensorDataType(name.c_str());
-    std::size_t element_size = (dt == nvinfer1::DataType::kFLOAT) ? sizeof(float) : sizeof(int64_t);
     std::size_t num = 1;
     for (int j = 0; j < d.nbDims; ++j) {
       const int64_t dim_val = (d.d[j] > 0) ? d.d[j] : 1;
@@ -143,29 +215,20 @@ TensorRTInferenceBackend::TensorRTInferenceBackend(std::string engine_path) : im
     }
     impl_->output_num_elements[static_cast<std::size_t>(i)] = num;
     impl_->output_dtypes[static_cast<std::size_t>(i)] = dt;
-    std::size_t bytes = num * element_size;
-    void* ptr = nullptr;
-    cudaError_t err = cudaMalloc(&ptr, bytes);
-    if (err != cudaSuccess) {
-      throw std::runtime_error("TensorRTInferenceBackend: cudaMalloc failed for tensor " + name);
-    }
-    impl_->device_buffers[static_cast<std::size_t>(i)] = ptr;
-    if (impl_->engine->getTensorIOMode(name.c_str()) != nvinfer1::TensorIOMode::kINPUT) {
-      impl_->host_output_buffers[static_cast<std::size_t>(i)].resize(bytes);
-    }
   }
 
   impl_->use_yolo_single_output = (impl_->num_io_tensors == 2);
-  impl_->nchw_buffer.resize(impl_->input_num_floats);
+  impl_->allocate();
 }
 
-TensorRTInferenceBackend::~TensorRTInferenceBackend() {
-  if (!impl_) return;
-  for (void* ptr : impl_->device_buffers) {
-    if (ptr) {
-      cudaFree(ptr);
-    }
-  }
+TensorRTInferenceBackend::TensorRTInferenceBackend(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+
+TensorRTInferenceBackend::~TensorRTInferenceBackend() = default;
+
+std::unique_ptr<IInferenceBackend> TensorRTInferenceBackend::clone() const {
+  // Private constructor, so no make_unique; the engine is shared, not deserialized again.
+  return std::unique_ptr<IInferenceBackend>(new TensorRTInferenceBackend(impl_->replica()));
 }
 
 std::expected<void, normitri::core::PipelineError>
@@ -173,15 +236,14 @@ TensorRTInferenceBackend::validate_input(const normitri::core::Frame& input) con
   if (input.empty()) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
-  if (input.format() != normitri::core::PixelFormat::Float32Planar) {
+  if (normitri::core::channel_count(input.format()) != kNumChannels ||
+      input.element_type() != impl_->input_type) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
   if (input.width() != impl_->input_width || input.height() != impl_->input_height) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
-  const std::size_t expected_bytes =
-      static_cast<std::size_t>(impl_->input_height) * impl_->input_width * kNumChannels * sizeof(float);
-  if (input.size_bytes() < expected_bytes) {
+  if (input.size_bytes() < input.min_bytes()) {
     return std::unexpected(normitri::core::PipelineError::InvalidFrame);
   }
   return {};
@@ -196,12 +258,16 @@ TensorRTInferenceBackend::infer(const normitri::core::Frame& input) {
 
   const std::uint32_t h = input.height();
   const std::uint32_t w = input.width();
-  const float* src = reinterpret_cast<const float*>(input.data().data());
-  HwcToNchw(src, h, w, impl_->nchw_buffer.data());
+  const std::byte* nchw = input.data().data();  // CHW frames are uploaded directly
+  if (input.layout() == normitri::core::TensorLayout::HWC) {
+    detail::hwc_to_chw(nchw, h, w, kNumChannels, normitri::core::element_size(impl_->input_type),
+                       impl_->nchw_buffer.data());
+    nchw = impl_->nchw_buffer.data();
+  }
 
   cudaError_t err = cudaMemcpy(impl_->device_buffers[static_cast<std::size_t>(impl_->input_io_index)],
-                              impl_->nchw_buffer.data(),
-                              impl_->input_num_floats * sizeof(float),
+                              nchw,
+                              input.min_bytes(),
                               cudaMemcpyHostToDevice);
   if (err != cudaSuccess) {
     return std::unexpected(normitri::core::PipelineError::InferenceFailed);
@@ -313,10 +379,11 @@ TensorRTInferenceBackend::infer(const normitri::core::Frame& input) {
 }
 
 void TensorRTInferenceBackend::warmup() {
-  const std::size_t num_bytes = impl_->input_num_floats * sizeof(float);
-  std::vector<std::byte> buffer(num_bytes, std::byte{0});
+  std::vector<std::byte> buffer(impl_->nchw_buffer.size(), std::byte{0});
   normitri::core::Frame frame(impl_->input_width, impl_->input_height,
                               normitri::core::PixelFormat::Float32Planar, std::move(buffer));
+  frame.set_element_type(impl_->input_type);
+  frame.set_layout(normitri::core::TensorLayout::CHW);
   (void)infer(frame);
 }
 
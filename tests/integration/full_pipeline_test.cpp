@@ -3,14 +3,17 @@
 #include <normitri/core/defect.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_replicas.hpp>
 #include <normitri/vision/defect_decoder.hpp>
 #include <normitri/vision/defect_detection_stage.hpp>
 #include <normitri/vision/mock_inference_backend.hpp>
 #include <normitri/vision/normalize_stage.hpp>
 #include <normitri/vision/resize_stage.hpp>
 #include <gtest/gtest.h>
+#include <cstddef>
 #include <mutex>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace {
@@ -77,6 +80,61 @@ TEST(FullPipeline, BatchParallel) {
   }
 }
 
+TEST(FullPipeline, BatchParallelOnReplicas) {
+  PipelineReplicas replicas(build_demo_pipeline());
+  std::vector<Frame> frames;
+  for (int i = 0; i < 8; ++i) {
+    std::vector<std::byte> buf(64 * 64 * 3);
+    frames.emplace_back(64, 64, PixelFormat::RGB8, std::move(buf));
+  }
+
+  for (std::size_t batch_size : {std::size_t{1}, std::size_t{3}}) {
+    std::vector<DefectResult> results;
+    std::mutex results_mutex;
+    run_pipeline_batch_parallel(
+        replicas, frames,
+        [&](const DefectResult& r) {
+          std::lock_guard lock(results_mutex);
+          results.push_back(r);
+        },
+        4, nullptr, nullptr, batch_size);
+
+    EXPECT_EQ(results.size(), 8u);
+    for (const auto& r : results) {
+      EXPECT_EQ(r.frame_id, 42u);
+      ASSERT_EQ(r.defects.size(), 1u);
+      EXPECT_EQ(r.defects[0].kind, DefectKind::WrongItem);
+    }
+  }
+  EXPECT_LE(replicas.size(), 4u);  // at most one per thread
+}
+
+TEST(FullPipeline, BatchParallelInFrameOrder) {
+  PipelineReplicas replicas(build_demo_pipeline());
+  Pipeline pipeline = build_demo_pipeline();
+  std::vector<Frame> frames;
+  std::vector<std::string> camera_ids;
+  for (int i = 0; i < 100; ++i) {
+    std::vector<std::byte> buf(64 * 64 * 3);
+    frames.emplace_back(64, 64, PixelFormat::RGB8, std::move(buf));
+    camera_ids.push_back(std::to_string(i));
+  }
+
+  for (std::size_t batch_size : {std::size_t{1}, std::size_t{3}}) {
+    std::vector<std::string> order;  // no lock: ordered delivery calls back one at a time
+    const DefectResultCallback record = [&](const DefectResult& r) {
+      order.push_back(r.camera_id.value_or(""));
+    };
+    run_pipeline_batch_parallel(replicas, frames, record, 4, &camera_ids, nullptr, batch_size,
+                                nullptr, DeliveryOrder::Input);
+    EXPECT_EQ(order, camera_ids);
+    order.clear();
+    run_pipeline_batch_parallel(pipeline, frames, record, 4, &camera_ids, nullptr, batch_size,
+                                DeliveryOrder::Input);
+    EXPECT_EQ(order, camera_ids);
+  }
+}
+
 TEST(FullPipeline, StageTimingCallbackInvoked) {
   Pipeline pipeline = build_demo_pipeline();
   std::vector<std::byte> buf(64 * 64 * 3);
@@ -0,0 +1,229 @@
+#include <normitri/app/dynamic_batcher.hpp>
+#include <normitri/core/defect_result.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_stage.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace na = normitri::app;
+namespace nc = normitri::core;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Fails frames whose first byte is zero and finishes frames whose first byte is 1 early
+/// (frame_id 1); passes the others on.
+class TriageStage : public nc::IPipelineStage {
+ public:
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    if (input.data()[0] == std::byte{0}) return std::unexpected(nc::PipelineError::InvalidFrame);
+    if (input.data()[0] == std::byte{1}) {
+      nc::DefectResult r;
+      r.frame_id = 1;
+      return nc::StageOutput{std::move(r)};
+    }
+    return nc::StageOutput{input};
+  }
+};
+
+/// Batch stage emitting frame_id = first byte (failing 2s); records batch sizes.
+class RecordingBatchStage : public nc::IPipelineStage {
+ public:
+  explicit RecordingBatchStage(std::vector<std::size_t>* sizes) : sizes_(sizes) {}
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    if (input.data()[0] == std::byte{2}) return std::unexpected(nc::PipelineError::InferenceFailed);
+    nc::DefectResult r;
+    r.frame_id = static_cast<std::uint64_t>(input.data()[0]);
+    return nc::StageOutput{std::move(r)};
+  }
+  bool supports_batch() const noexcept override { return true; }
+  std::vector<std::expected<nc::StageOutput, nc::PipelineError>> process_batch(
+      std::span<const nc::Frame> inputs) override {
+    sizes_->push_back(inputs.size());  // only the scheduler thread calls this
+    return nc::IPipelineStage::process_batch(inputs);
+  }
+
+ private:
+  std::vector<std::size_t>* sizes_;
+};
+
+nc::Pipeline make_batching_pipeline(std::vector<std::size_t>* sizes) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<TriageStage>());
+  p.add_stage(std::make_unique<RecordingBatchStage>(sizes));
+  return p;
+}
+
+/// RecordingBatchStage whose first batch blocks until \p release is ready; \p entered is set
+/// once it is inside.
+class GatedBatchStage : public RecordingBatchStage {
+ public:
+  GatedBatchStage(std::vector<std::size_t>* sizes, std::promise<void>* entered,
+                  std::shared_future<void> release)
+      : RecordingBatchStage(sizes), entered_(entered), release_(std::move(release)) {}
+  std::vector<std::expected<nc::StageOutput, nc::PipelineError>> process_batch(
+      std::span<const nc::Frame> inputs) override {
+    if (entered_) {
+      std::exchange(entered_, nullptr)->set_value();
+      release_.wait();
+    }
+    return RecordingBatchStage::process_batch(inputs);
+  }
+
+ private:
+  std::promise<void>* entered_;
+  std::shared_future<void> release_;
+};
+
+nc::Frame make_byte_frame(std::uint8_t value) {
+  return nc::Frame(2, 2, nc::PixelFormat::Grayscale8, std::vector<std::byte>(4, std::byte{value}));
+}
+
+/// Per-unit callbacks that record frame ids (callbacks run on the scheduler thread only).
+struct Recorder {
+  std::vector<std::uint64_t> cam_a;
+  std::vector<std::uint64_t> cam_b;
+
+  std::unordered_map<std::string, na::DefectResultCallback> callbacks() {
+    return {
+        {"cam_a",
+         [this](const nc::DefectResult& r) {
+           EXPECT_EQ(r.camera_id.value_or(""), "cam_a");
+           cam_a.push_back(r.frame_id);
+         }},
+        {"cam_b",
+         [this](const nc::DefectResult& r) {
+           EXPECT_EQ(r.camera_id.value_or(""), "cam_b");
+           cam_b.push_back(r.frame_id);
+         }},
+    };
+  }
+};
+
+}  // namespace
+
+TEST(DynamicBatcher, BatchesAcrossUnitsAndScattersResults) {
+  std::vector<std::size_t> sizes;
+  nc::Pipeline pipeline = make_batching_pipeline(&sizes);
+  Recorder recorder;
+  na::DynamicBatcher batcher(pipeline, recorder.callbacks(),
+                             {.max_batch_size = 4, .max_wait = std::chrono::microseconds(10s)});
+  for (std::uint8_t v = 10; v < 18; ++v) {
+    EXPECT_TRUE(batcher.submit(v % 2 == 0 ? "cam_a" : "cam_b", make_byte_frame(v)));
+  }
+  batcher.flush();  // both batches filled up; nothing waits for the deadline
+  EXPECT_EQ(sizes, (std::vector<std::size_t>{4, 4}));
+  EXPECT_EQ(recorder.cam_a, (std::vector<std::uint64_t>{10, 12, 14, 16}));
+  EXPECT_EQ(recorder.cam_b, (std::vector<std::uint64_t>{11, 13, 15, 17}));
+  const na::DynamicBatcherStats s = batcher.stats();
+  EXPECT_EQ(s.submitted, 8u);
+  EXPECT_EQ(s.batches, 2u);
+  EXPECT_EQ(s.batched_frames, 8u);
+  EXPECT_EQ(s.full_batches, 2u);
+  EXPECT_EQ(s.queued, 0u);
+}
+
+TEST(DynamicBatcher, DeadlineClosesAPartialBatch) {
+  std::vector<std::size_t> sizes;
+  nc::Pipeline pipeline = make_batching_pipeline(&sizes);
+  std::promise<void> delivered;
+  int remaining = 3;
+  na::DynamicBatcher batcher(
+      pipeline,
+      {{"cam_a", [&](const nc::DefectResult&) {
+          if (--remaining == 0) delivered.set_value();
+        }}},
+      {.max_batch_size = 64, .max_wait = std::chrono::microseconds(5ms)});
+  const auto start = std::chrono::steady_clock::now();
+  for (std::uint8_t v = 20; v < 23; ++v) batcher.submit("cam_a", make_byte_frame(v));
+  ASSERT_EQ(delivered.get_future().wait_for(5s), std::future_status::ready);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 5ms);
+  EXPECT_EQ(sizes, std::vector<std::size_t>{3});
+  const na::DynamicBatcherStats s = batcher.stats();
+  EXPECT_EQ(s.deadline_batches, 1u);
+  EXPECT_GE(s.max_wait_ns, 4'000'000u);  // the first frame waited (almost) max_wait
+}
+
+TEST(DynamicBatcher, FlushWaitsForEveryEarlierFrameNotACount) {
+  std::vector<std::size_t> sizes;
+  std::promise<void> entered;
+  std::promise<void> release;
+  nc::Pipeline pipeline;
+  pipeline.add_stage(std::make_unique<TriageStage>());
+  pipeline.add_stage(
+      std::make_unique<GatedBatchStage>(&sizes, &entered, release.get_future().share()));
+  Recorder recorder;
+  na::DynamicBatcher batcher(pipeline, recorder.callbacks(),
+                             {.max_batch_size = 2, .max_wait = std::chrono::microseconds(10s)});
+
+  batcher.submit("cam_a", make_byte_frame(3));
+  batcher.submit("cam_a", make_byte_frame(4));
+  entered.get_future().wait();  // the scheduler is stuck in the first batch
+  for (std::uint8_t v = 5; v < 8; ++v) batcher.submit("cam_a", make_byte_frame(v));
+  auto flushed = std::async(std::launch::async, [&batcher] { batcher.flush(); });
+  std::this_thread::sleep_for(20ms);
+  // Early results accepted after flush() started are delivered ahead of the queued frames, so a
+  // count of deliveries would reach flush()'s target while frame 7 still waits for max_wait.
+  batcher.submit("cam_b", make_byte_frame(1));
+  batcher.submit("cam_b", make_byte_frame(1));
+  release.set_value();
+  flushed.get();
+  EXPECT_EQ(recorder.cam_a, (std::vector<std::uint64_t>{3, 4, 5, 6, 7}));
+}
+
+TEST(DynamicBatcher, RejectsUnknownUnitsAndCountsFailures) {
+  std::vector<std::size_t> sizes;
+  nc::Pipeline pipeline = make_batching_pipeline(&sizes);
+  Recorder recorder;
+  na::DynamicBatcher batcher(pipeline, recorder.callbacks(),
+                             {.max_batch_size = 8, .max_wait = std::chrono::microseconds(10s)});
+  EXPECT_FALSE(batcher.submit("cam_unknown", make_byte_frame(30)));
+  EXPECT_FALSE(batcher.submit("cam_a", make_byte_frame(0)));  // fails before the batch stage
+  EXPECT_TRUE(batcher.submit("cam_a", make_byte_frame(1)));   // finishes before it
+  EXPECT_TRUE(batcher.submit("cam_a", make_byte_frame(2)));   // fails in it
+  EXPECT_TRUE(batcher.submit("cam_b", make_byte_frame(31)));
+  batcher.flush();
+  EXPECT_EQ(recorder.cam_a, std::vector<std::uint64_t>{1});
+  EXPECT_EQ(recorder.cam_b, std::vector<std::uint64_t>{31});
+  EXPECT_EQ(sizes, std::vector<std::size_t>{2});
+
+  batcher.close();
+  EXPECT_FALSE(batcher.submit("cam_a", make_byte_frame(32)));
+  const na::DynamicBatcherStats s = batcher.stats();
+  EXPECT_EQ(s.rejected, 2u);
+  EXPECT_EQ(s.failed, 2u);
+  EXPECT_EQ(s.deadline_batches, 1u);
+}
+
+TEST(DynamicBatcher, WorkItemsFromManyThreadsAllArrive) {
+  std::vector<std::size_t> sizes;
+  nc::Pipeline pipeline = make_batching_pipeline(&sizes);
+  Recorder recorder;
+  std::vector<std::pair<std::string, nc::Frame>> work_items;
+  for (int i = 0; i < 200; ++i) {
+    work_items.emplace_back(i % 2 == 0 ? "cam_a" : "cam_b", make_byte_frame(100));
+  }
+  {
+    na::DynamicBatcher batcher(pipeline, recorder.callbacks(),
+                               {.max_batch_size = 16, .max_wait = std::chrono::microseconds(1ms)});
+    EXPECT_EQ(batcher.submit(work_items, 4), 200u);
+  }  // the destructor delivers what is still queued
+  EXPECT_EQ(recorder.cam_a.size(), 100u);
+  EXPECT_EQ(recorder.cam_b.size(), 100u);
+  std::size_t batched = 0;
+  for (std::size_t n : sizes) {
+    EXPECT_LE(n, 16u);
+    batched += n;
+  }
+  EXPECT_EQ(batched, 200u);
+}
@@ -1,10 +1,13 @@
 #ifdef NORMITRI_HAS_TBB
 
 #include <normitri/app/pipeline_runner_tbb.hpp>
+#include <normitri/app/result_queue.hpp>
 #include <normitri/core/defect.hpp>
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_replicas.hpp>
+#include <normitri/core/pipeline_stage.hpp>
 #include <normitri/vision/defect_decoder.hpp>
 #include <normitri/vision/defect_detection_stage.hpp>
 #include <normitri/vision/mock_inference_backend.hpp>
@@ -13,6 +16,10 @@
 #include <gtest/gtest.h>
 #include <atomic>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -43,6 +50,30 @@ normitri::core::Frame make_dummy_frame(std::uint32_t w = 64, std::uint32_t h = 6
   return normitri::core::Frame(w, h, normitri::core::PixelFormat::RGB8, std::move(buffer));
 }
 
+/// A stateful last stage: fails the test if entered concurrently, and reports the frame width as
+/// frame_id so callers can check delivery order.
+class SerialProbeStage : public normitri::core::IPipelineStage {
+ public:
+  std::expected<normitri::core::StageOutput, normitri::core::PipelineError> process(
+      const normitri::core::Frame& input) override {
+    EXPECT_FALSE(inside_.exchange(true));
+    normitri::core::DefectResult result;
+    result.frame_id = input.width();
+    inside_.store(false);
+    return normitri::core::StageOutput{std::move(result)};
+  }
+
+ private:
+  std::atomic<bool> inside_{false};
+};
+
+normitri::core::Pipeline make_probe_pipeline() {
+  normitri::core::Pipeline p;
+  p.add_stage(std::make_unique<normitri::vision::NormalizeStage>(0.f, 1.f));
+  p.add_stage(std::make_unique<SerialProbeStage>());
+  return p;
+}
+
 }  // namespace
 
 TEST(PipelineRunnerTbbTest, MultiCameraRunsCallbackPerWorkItem) {
@@ -75,6 +106,34 @@ TEST(PipelineRunnerTbbTest, MultiCameraRunsCallbackPerWorkItem) {
   EXPECT_TRUE(std::find(unit_ids.begin(), unit_ids.end(), "cam_2") != unit_ids.end());
 }
 
+TEST(PipelineRunnerTbbTest, MultiCameraSerializesEachUnitAndTakesTurns) {
+  normitri::core::Pipeline busy = make_probe_pipeline();
+  normitri::core::Pipeline quiet = make_probe_pipeline();
+  std::unordered_map<std::string, normitri::core::Pipeline*> pipelines{{"busy", &busy},
+                                                                       {"quiet", &quiet}};
+  std::vector<std::pair<std::string, normitri::core::Frame>> work_items;
+  for (std::uint32_t w = 1; w <= 200; ++w) work_items.emplace_back("busy", make_dummy_frame(w, 8));
+  work_items.emplace_back("quiet", make_dummy_frame(7, 8));
+
+  std::mutex mutex;
+  std::vector<std::uint64_t> busy_ids;
+  std::size_t quiet_position = 0;
+  normitri::app::run_pipeline_multi_camera_tbb(
+      pipelines, work_items,
+      [&](const normitri::core::DefectResult& r, const std::string& unit_id) {
+        std::lock_guard lock(mutex);
+        if (unit_id == "quiet") {
+          quiet_position = busy_ids.size();
+        } else {
+          busy_ids.push_back(r.frame_id);
+        }
+      });
+  ASSERT_EQ(busy_ids.size(), 200u);
+  for (std::size_t i = 0; i < busy_ids.size(); ++i) EXPECT_EQ(busy_ids[i], i + 1);
+  // The quiet unit's only frame is last in work_items but gets the second turn, not the 201st.
+  EXPECT_LT(quiet_position, 8u);
+}
+
 TEST(PipelineRunnerTbbTest, EmptyWorkItemsDoesNotCallCallback) {
   normitri::core::Pipeline p = make_mock_pipeline();
   std::unordered_map<std::string, normitri::core::Pipeline*> pipelines;
@@ -87,4 +146,125 @@ TEST(PipelineRunnerTbbTest, EmptyWorkItemsDoesNotCallCallback) {
   EXPECT_EQ(calls.load(), 0u);
 }
 
+TEST(PipelineRunnerTbbTest, ReplicasRunOneUnitOnManyThreads) {
+  normitri::core::PipelineReplicas cam_1(make_mock_pipeline());
+  std::unordered_map<std::string, normitri::core::PipelineReplicas*> replicas;
+  replicas["cam_1"] = &cam_1;
+
+  std::vector<std::pair<std::string, normitri::core::Frame>> work_items;
+  for (int i = 0; i < 64; ++i) work_items.emplace_back("cam_1", make_dummy_frame());
+  work_items.emplace_back("cam_unknown", make_dummy_frame());
+
+  std::atomic<std::size_t> calls{0};
+  normitri::app::run_pipeline_multi_camera_tbb(
+      replicas, work_items,
+      [&calls](const normitri::core::DefectResult& r, const std::string& unit_id) {
+        EXPECT_EQ(unit_id, "cam_1");
+        EXPECT_EQ(r.defects.size(), 1u);
+        calls++;
+      });
+  EXPECT_EQ(calls.load(), 64u);
+  EXPECT_GE(cam_1.size(), 1u);
+}
+
+TEST(PipelineRunnerTbbTest, ResultQueueReceivesEveryResult) {
+  normitri::core::Pipeline pipeline = make_mock_pipeline();
+  normitri::core::PipelineReplicas cam_2(make_mock_pipeline());
+  std::unordered_map<std::string, normitri::core::Pipeline*> pipelines{{"cam_1", &pipeline}};
+  std::unordered_map<std::string, normitri::core::PipelineReplicas*> replicas{{"cam_2", &cam_2}};
+  std::vector<std::pair<std::string, normitri::core::Frame>> cam_1_items;
+  std::vector<std::pair<std::string, normitri::core::Frame>> cam_2_items;
+  for (int i = 0; i < 40; ++i) {
+    cam_1_items.emplace_back("cam_1", make_dummy_frame());
+    cam_2_items.emplace_back("cam_2", make_dummy_frame());
+  }
+
+  normitri::app::ResultQueue queue(8);
+  normitri::app::run_pipeline_multi_camera_tbb(pipelines, cam_1_items, queue);
+  normitri::app::run_pipeline_multi_camera_tbb(replicas, cam_2_items, queue);
+  queue.close();
+  std::unordered_map<std::string, std::size_t> per_camera;
+  while (queue.wait()) {
+    queue.drain([&](std::span<const normitri::core::DefectResult> batch) {
+      EXPECT_LE(batch.size(), 8u);
+      for (const auto& r : batch) ++per_camera[r.camera_id.value_or("")];
+    });
+  }
+  EXPECT_EQ(per_camera["cam_1"], 40u);
+  EXPECT_EQ(per_camera["cam_2"], 40u);
+}
+
+TEST(PipelineRunnerTbbTest, PipelinedRunsSerialStagesInFrameOrder) {
+  normitri::core::Pipeline pipeline = make_probe_pipeline();
+  std::vector<normitri::core::Frame> frames;
+  for (std::uint32_t w = 1; w <= 48; ++w) frames.push_back(make_dummy_frame(w, 8));
+
+  std::vector<std::uint64_t> order;
+  normitri::app::run_pipeline_pipelined_tbb(
+      pipeline, frames, [&order](const normitri::core::DefectResult& r) {
+        order.push_back(r.frame_id);
+      }, normitri::app::PipelinedTbbOptions{.max_tokens = 4});
+  ASSERT_EQ(order.size(), frames.size());
+  for (std::size_t i = 0; i < order.size(); ++i) EXPECT_EQ(order[i], i + 1);
+}
+
+TEST(PipelineRunnerTbbTest, PipelinedMultiCameraKeepsOrderPerUnit) {
+  normitri::core::Pipeline pipeline1 = make_probe_pipeline();
+  normitri::core::Pipeline pipeline2 = make_probe_pipeline();
+  std::unordered_map<std::string, normitri::core::Pipeline*> pipelines{{"cam_1", &pipeline1},
+                                                                       {"cam_2", &pipeline2}};
+  std::vector<std::pair<std::string, normitri::core::Frame>> work_items;
+  for (std::uint32_t w = 1; w <= 32; ++w) {
+    work_items.emplace_back("cam_1", make_dummy_frame(w, 8));
+    work_items.emplace_back("cam_2", make_dummy_frame(w, 8));
+  }
+  work_items.emplace_back("cam_unknown", make_dummy_frame());
+
+  std::mutex mutex;
+  std::unordered_map<std::string, std::vector<std::uint64_t>> order;
+  normitri::app::run_pipeline_multi_camera_pipelined_tbb(
+      pipelines, work_items,
+      [&](const normitri::core::DefectResult& r, const std::string& unit_id) {
+        EXPECT_EQ(r.camera_id.value_or(""), unit_id);
+        std::lock_guard lock(mutex);
+        order[unit_id].push_back(r.frame_id);
+      });
+  ASSERT_EQ(order.size(), 2u);
+  for (const auto& [unit_id, ids] : order) {
+    ASSERT_EQ(ids.size(), 32u) << unit_id;
+    for (std::size_t i = 0; i < ids.size(); ++i) EXPECT_EQ(ids[i], i + 1) << unit_id;
+  }
+}
+
+TEST(PipelineRunnerTbbTest, PipelinedSharesOneLaneForAliasedPipelines) {
+  normitri::core::Pipeline shared = make_probe_pipeline();
+  std::unordered_map<std::string, normitri::core::Pipeline*> pipelines{{"cam_1", &shared},
+                                                                       {"cam_2", &shared}};
+  std::vector<std::pair<std::string, normitri::core::Frame>> work_items;
+  for (std::uint32_t w = 1; w <= 64; ++w) {
+    work_items.emplace_back(w % 2 == 0 ? "cam_2" : "cam_1", make_dummy_frame(w, 8));
+  }
+  std::vector<std::uint64_t> order;  // the shared lane emits one result at a time
+  normitri::app::run_pipeline_multi_camera_pipelined_tbb(
+      pipelines, work_items,
+      [&](const normitri::core::DefectResult& r, const std::string& unit_id) {
+        EXPECT_EQ(unit_id, r.frame_id % 2 == 0 ? "cam_2" : "cam_1");
+        order.push_back(r.frame_id);
+      });
+  ASSERT_EQ(order.size(), 64u);
+  for (std::size_t i = 0; i < order.size(); ++i) EXPECT_EQ(order[i], i + 1);
+}
+
+TEST(PipelineRunnerTbbTest, PipelinedPropagatesStageExceptions) {
+  normitri::core::Pipeline pipeline = make_probe_pipeline();
+  std::vector<normitri::core::Frame> frames;
+  for (std::uint32_t w = 1; w <= 32; ++w) frames.push_back(make_dummy_frame(w, 8));
+  EXPECT_THROW(normitri::app::run_pipeline_pipelined_tbb(
+                   pipeline, frames,
+                   [](const normitri::core::DefectResult& r) {
+                     if (r.frame_id == 3) throw std::runtime_error("sink full");
+                   }),
+               std::runtime_error);
+}
+
 #endif  // NORMITRI_HAS_TBB
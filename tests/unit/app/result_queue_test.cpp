@@ -0,0 +1,105 @@
+#include <normitri/app/pipeline_runner.hpp>
+#include <normitri/app/result_queue.hpp>
+#include <normitri/core/defect_result.hpp>
+#include <normitri/core/executor.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_replicas.hpp>
+#include <normitri/core/pipeline_stage.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace na = normitri::app;
+namespace nc = normitri::core;
+
+namespace {
+
+/// Emits a DefectResult whose frame_id is the frame's width; fails frames of width 0 mod 10.
+class WidthStage : public nc::IPipelineStage {
+ public:
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    if (input.width() % 10 == 0) return std::unexpected(nc::PipelineError::InvalidFrame);
+    nc::DefectResult r;
+    r.frame_id = input.width();
+    return nc::StageOutput{std::move(r)};
+  }
+  std::unique_ptr<nc::IPipelineStage> clone() const override {
+    return std::make_unique<WidthStage>(*this);
+  }
+};
+
+nc::Pipeline make_width_pipeline() {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<WidthStage>());
+  return p;
+}
+
+nc::DefectResult result_with_id(std::uint64_t id) {
+  nc::DefectResult r;
+  r.frame_id = id;
+  return r;
+}
+
+}  // namespace
+
+TEST(ResultQueue, WritersFlushInBatchesOfFlushSize) {
+  na::ResultQueue queue(3);
+  {
+    na::ResultQueue::Writer writer = queue.writer();
+    for (std::uint64_t i = 0; i < 7; ++i) writer.add(result_with_id(i));
+    std::vector<std::size_t> sizes;
+    EXPECT_EQ(queue.drain([&](std::span<const nc::DefectResult> b) { sizes.push_back(b.size()); }),
+              6u);
+    EXPECT_EQ(sizes, (std::vector<std::size_t>{3, 3}));
+  }  // the writer's last result is pushed on destruction
+  queue.close();
+  ASSERT_TRUE(queue.wait());
+  std::vector<std::uint64_t> ids;
+  queue.drain([&](std::span<const nc::DefectResult> b) {
+    for (const auto& r : b) ids.push_back(r.frame_id);
+  });
+  EXPECT_EQ(ids, std::vector<std::uint64_t>{6});
+  EXPECT_FALSE(queue.wait());
+}
+
+TEST(ResultQueue, ConsumerDrainsWhileRunnersProduce) {
+  constexpr std::size_t kFrames = 500;
+  std::vector<nc::Frame> frames;
+  std::vector<std::string> camera_ids;
+  for (std::uint32_t w = 1; w <= kFrames; ++w) {
+    frames.emplace_back(w, 1, nc::PixelFormat::Grayscale8, std::vector<std::byte>(w));
+    camera_ids.push_back("cam_" + std::to_string(w));
+  }
+
+  na::ResultQueue queue(16);
+  std::vector<std::size_t> seen(kFrames + 1, 0);
+  std::thread consumer([&] {
+    while (queue.wait()) {
+      queue.drain([&](std::span<const nc::DefectResult> batch) {
+        for (const auto& r : batch) {
+          EXPECT_EQ(r.camera_id.value_or(""), "cam_" + std::to_string(r.frame_id));
+          ++seen[r.frame_id];
+        }
+      });
+    }
+  });
+
+  nc::Executor executor({.num_workers = 4, .cpu_affinity = {}});
+  nc::Pipeline pipeline = make_width_pipeline();
+  nc::PipelineReplicas replicas(make_width_pipeline());
+  na::run_pipeline_batch_parallel(pipeline, frames, queue, 0, &camera_ids, nullptr, &executor);
+  na::run_pipeline_batch_parallel(replicas, frames, queue, 3, &camera_ids, nullptr, &executor);
+  queue.close();
+  consumer.join();
+
+  for (std::size_t w = 1; w <= kFrames; ++w) {
+    EXPECT_EQ(seen[w], w % 10 == 0 ? 0u : 2u) << "frame width " << w;
+  }
+  EXPECT_LE(replicas.size(), 3u);
+}
@@ -0,0 +1,204 @@
+#include <normitri/app/streaming_runner.hpp>
+#include <normitri/core/defect_result.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_stage.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace na = normitri::app;
+namespace nc = normitri::core;
+
+namespace {
+
+/// Holds every frame until open() so tests can fill the queue behind a busy worker.
+struct Gate {
+  std::mutex mutex;
+  std::condition_variable cv;
+  int entered{0};
+  bool is_open{false};
+
+  void open() {
+    std::lock_guard lock(mutex);
+    is_open = true;
+    cv.notify_all();
+  }
+  void wait_entered(int n) {
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&] { return entered >= n; });
+  }
+};
+
+/// Waits at the gate, then emits a DefectResult whose frame_id is the first byte of its input.
+class GatedStage : public nc::IPipelineStage {
+ public:
+  explicit GatedStage(std::shared_ptr<Gate> gate) : gate_(std::move(gate)) {}
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    {
+      std::unique_lock lock(gate_->mutex);
+      ++gate_->entered;
+      gate_->cv.notify_all();
+      gate_->cv.wait(lock, [&] { return gate_->is_open; });
+    }
+    nc::DefectResult r;
+    r.frame_id = static_cast<std::uint64_t>(input.data()[0]);
+    return nc::StageOutput{std::move(r)};
+  }
+  std::unique_ptr<nc::IPipelineStage> clone() const override {
+    return std::make_unique<GatedStage>(gate_);
+  }
+
+ private:
+  std::shared_ptr<Gate> gate_;
+};
+
+nc::Frame make_byte_frame(std::uint8_t value) {
+  return nc::Frame(2, 2, nc::PixelFormat::Grayscale8, std::vector<std::byte>(4, std::byte{value}));
+}
+
+nc::Pipeline make_gated_pipeline(const std::shared_ptr<Gate>& gate) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<GatedStage>(gate));
+  return p;
+}
+
+/// Frame id of a finished future, or -1 if the frame was dropped.
+long long frame_or_dropped(std::future<na::StreamingResult>& f) {
+  const na::StreamingResult r = f.get();
+  if (!r) {
+    EXPECT_EQ(r.error(), nc::PipelineError::Dropped);
+    return -1;
+  }
+  return static_cast<long long>(r->frame_id);
+}
+
+}  // namespace
+
+TEST(StreamingRunner, FutureYieldsTaggedResult) {
+  auto gate = std::make_shared<Gate>();
+  gate->open();
+  nc::Pipeline pipeline = make_gated_pipeline(gate);
+  na::StreamingRunner runner(pipeline);
+  auto f = runner.submit(make_byte_frame(7), "cam_1", "cust_9");
+  const na::StreamingResult r = f.get();
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(r->frame_id, 7u);
+  EXPECT_EQ(r->camera_id, "cam_1");
+  EXPECT_EQ(r->customer_id, "cust_9");
+  runner.wait_idle();
+  const na::StreamingStats s = runner.stats();
+  EXPECT_EQ(s.submitted, 1u);
+  EXPECT_EQ(s.completed, 1u);
+  EXPECT_EQ(s.dropped, 0u);
+  EXPECT_EQ(s.queue_depth, 0u);
+}
+
+TEST(StreamingRunner, DropNewestAndDropOldestWhenFull) {
+  for (na::OverflowPolicy policy : {na::OverflowPolicy::DropNewest, na::OverflowPolicy::DropOldest}) {
+    auto gate = std::make_shared<Gate>();
+    nc::Pipeline pipeline = make_gated_pipeline(gate);
+    na::StreamingRunner runner(pipeline, {.queue_depth = 2, .overflow = policy, .num_workers = 1});
+    auto busy = runner.submit(make_byte_frame(1));
+    gate->wait_entered(1);  // the worker holds frame 1; the queue is empty
+    auto a = runner.submit(make_byte_frame(2));
+    auto b = runner.submit(make_byte_frame(3));
+    auto c = runner.submit(make_byte_frame(4));
+    EXPECT_EQ(runner.stats().queue_depth, 2u);
+    gate->open();
+    EXPECT_EQ(frame_or_dropped(busy), 1);
+    if (policy == na::OverflowPolicy::DropNewest) {
+      EXPECT_EQ(frame_or_dropped(a), 2);
+      EXPECT_EQ(frame_or_dropped(c), -1);
+    } else {
+      EXPECT_EQ(frame_or_dropped(a), -1);
+      EXPECT_EQ(frame_or_dropped(c), 4);
+    }
+    EXPECT_EQ(frame_or_dropped(b), 3);
+    runner.wait_idle();
+    const na::StreamingStats s = runner.stats();
+    EXPECT_EQ(s.submitted, 4u);
+    EXPECT_EQ(s.completed, 3u);
+    EXPECT_EQ(s.dropped, 1u);
+    EXPECT_EQ(s.max_queue_depth, 2u);
+  }
+}
+
+TEST(StreamingRunner, LatestFramePerCameraWins) {
+  auto gate = std::make_shared<Gate>();
+  nc::Pipeline pipeline = make_gated_pipeline(gate);
+  na::StreamingRunner runner(
+      pipeline, {.queue_depth = 4, .overflow = na::OverflowPolicy::LatestPerCamera,
+                 .num_workers = 1});
+  auto busy = runner.submit(make_byte_frame(1), "a");
+  gate->wait_entered(1);
+  auto a_old = runner.submit(make_byte_frame(2), "a");
+  auto b = runner.submit(make_byte_frame(3), "b");
+  auto a_new = runner.submit(make_byte_frame(4), "a");  // replaces frame 2, keeps its place
+
+  std::vector<std::uint64_t> order;
+  std::mutex order_mutex;
+  const auto record = [&](const na::StreamingResult& r) {
+    std::lock_guard lock(order_mutex);
+    order.push_back(r ? r->frame_id : 0u);
+  };
+  EXPECT_TRUE(runner.submit(make_byte_frame(5), record, "c"));
+  EXPECT_EQ(runner.stats().queue_depth, 3u);
+  gate->open();
+  EXPECT_EQ(frame_or_dropped(a_old), -1);
+  EXPECT_EQ(frame_or_dropped(a_new), 4);
+  EXPECT_EQ(frame_or_dropped(b), 3);
+  runner.wait_idle();
+  EXPECT_EQ(order, std::vector<std::uint64_t>{5u});
+  EXPECT_EQ(runner.stats().dropped, 1u);
+}
+
+TEST(StreamingRunner, BlockWaitsForRoomWithoutDropping) {
+  auto gate = std::make_shared<Gate>();
+  nc::Pipeline pipeline = make_gated_pipeline(gate);
+  na::StreamingRunner runner(pipeline, {.queue_depth = 1, .overflow = na::OverflowPolicy::Block,
+                                        .num_workers = 1});
+  auto busy = runner.submit(make_byte_frame(1));
+  gate->wait_entered(1);
+  auto queued = runner.submit(make_byte_frame(2));
+  std::future<na::StreamingResult> blocked;
+  std::thread producer([&] { blocked = runner.submit(make_byte_frame(3)); });
+  while (runner.stats().blocked == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  gate->open();
+  producer.join();
+  EXPECT_EQ(frame_or_dropped(busy), 1);
+  EXPECT_EQ(frame_or_dropped(queued), 2);
+  EXPECT_EQ(frame_or_dropped(blocked), 3);
+  runner.wait_idle();
+  const na::StreamingStats s = runner.stats();
+  EXPECT_EQ(s.dropped, 0u);
+  EXPECT_EQ(s.completed, 3u);
+  EXPECT_GT(s.max_queue_wait_ns, 0u);
+}
+
+TEST(StreamingRunner, CloseDropsLaterFramesAndDrainsQueuedOnes) {
+  auto gate = std::make_shared<Gate>();
+  nc::PipelineReplicas replicas(make_gated_pipeline(gate));
+  std::future<na::StreamingResult> queued;
+  std::future<na::StreamingResult> late;
+  {
+    na::StreamingRunner runner(replicas, {.queue_depth = 4, .overflow = na::OverflowPolicy::Block,
+                                          .num_workers = 2});
+    auto first = runner.submit(make_byte_frame(1));
+    auto second = runner.submit(make_byte_frame(2));
+    gate->wait_entered(2);  // both workers busy, each on its own replica
+    EXPECT_EQ(replicas.size(), 2u);
+    queued = runner.submit(make_byte_frame(3));
+    runner.close();
+    late = runner.submit(make_byte_frame(4));
+    gate->open();
+  }  // the destructor finishes the queued frame
+  EXPECT_EQ(frame_or_dropped(queued), 3);
+  EXPECT_EQ(frame_or_dropped(late), -1);
+}
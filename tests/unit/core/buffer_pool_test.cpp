@@ -0,0 +1,80 @@
+#include <normitri/core/buffer_pool.hpp>
+#include <normitri/core/frame.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace nc = normitri::core;
+
+TEST(BufferPool, BucketSizeRoundsUpWithBoundedSlack) {
+  EXPECT_EQ(nc::BufferPool::bucket_size(1), 256u);
+  EXPECT_EQ(nc::BufferPool::bucket_size(4096), 4096u);
+  EXPECT_EQ(nc::BufferPool::bucket_size(4097), 5120u);
+  const std::size_t tensor = 640u * 640 * 3 * sizeof(float);
+  const std::size_t bucket = nc::BufferPool::bucket_size(tensor);
+  EXPECT_GE(bucket, tensor);
+  EXPECT_LE(bucket, tensor + tensor / 4);
+}
+
+TEST(BufferPool, ReleasedBlockIsReused) {
+  nc::BufferPool pool;
+  const std::byte* first = nullptr;
+  {
+    auto a = pool.acquire(1000);
+    ASSERT_NE(a, nullptr);
+    first = a.get();
+  }
+  auto b = pool.acquire(900);  // same size class
+  EXPECT_EQ(b.get(), first);
+  const auto s = pool.stats();
+  EXPECT_EQ(s.misses, 1u);
+  EXPECT_EQ(s.hits, 1u);
+  EXPECT_EQ(s.returns, 1u);
+}
+
+TEST(BufferPool, BlocksAreAligned) {
+  nc::BufferPool pool;
+  auto a = pool.acquire(12345);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.get()) % 64, 0u);
+}
+
+TEST(BufferPool, CacheCapDiscardsExtraBlocks) {
+  nc::BufferPool pool(4096);
+  {
+    auto a = pool.acquire(4096);
+    auto b = pool.acquire(4096);
+  }
+  const auto s = pool.stats();
+  EXPECT_EQ(s.returns, 1u);
+  EXPECT_EQ(s.discards, 1u);
+  EXPECT_EQ(s.cached_bytes, 4096u);
+  pool.trim();
+  EXPECT_EQ(pool.stats().cached_bytes, 0u);
+}
+
+TEST(BufferPool, BlockMayOutlivePool) {
+  std::shared_ptr<std::byte> block;
+  {
+    nc::BufferPool pool;
+    block = pool.acquire(64);
+  }
+  block.reset();  // freed, not returned; must not crash
+  SUCCEED();
+}
+
+TEST(BufferPool, FrameReturnsBufferOnDestruction) {
+  nc::BufferPool pool;
+  const std::size_t bytes = nc::Frame::min_bytes(32, 32, nc::PixelFormat::RGB8);
+  for (int i = 0; i < 4; ++i) {
+    nc::Frame f = nc::Frame::allocate(32, 32, nc::PixelFormat::RGB8, bytes, &pool);
+    ASSERT_EQ(f.size_bytes(), bytes);
+    EXPECT_TRUE(f.is_pooled());
+    f.data()[0] = std::byte{1};  // writable in place, no copy-on-write
+  }
+  EXPECT_FALSE(nc::Frame::allocate(32, 32, nc::PixelFormat::RGB8, bytes).is_pooled());
+  const auto s = pool.stats();
+  EXPECT_EQ(s.misses, 1u);
+  EXPECT_EQ(s.hits, 3u);
+}
@@ -0,0 +1,164 @@
+#include <normitri/core/compact_defect.hpp>
+#include <normitri/core/inline_vector.hpp>
+#include <normitri/core/interned_string.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nc = normitri::core;
+
+static_assert(sizeof(nc::CompactDefect) <= 40);
+static_assert(std::is_trivially_copyable_v<nc::CompactDefect>);
+
+TEST(InternedString, EqualStringsShareOneHandle) {
+  const nc::InternedString a("produce");
+  const nc::InternedString b(std::string("pro") + "duce");
+  const nc::InternedString c("dairy");
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(a.view(), "produce");
+  EXPECT_TRUE(nc::InternedString("").empty());
+  EXPECT_EQ(nc::InternedString{}.view(), "");
+}
+
+TEST(InternedString, ConcurrentInterningAgrees) {
+  std::vector<std::vector<nc::InternedString>> seen(4);
+  {
+    std::vector<std::jthread> threads;
+    for (auto& out : seen) {
+      threads.emplace_back([&out] {
+        for (int i = 0; i < 2000; ++i) out.emplace_back("lane_" + std::to_string(i % 300));
+      });
+    }
+  }
+  for (std::size_t i = 0; i < seen[0].size(); ++i) {
+    for (const auto& other : seen) ASSERT_EQ(other[i], seen[0][i]);
+    ASSERT_EQ(seen[0][i].view(), "lane_" + std::to_string(i % 300));
+  }
+}
+
+TEST(InlineVector, StaysInlineThenSpillsToHeap) {
+  nc::InlineVector<int, 2> v;
+  v.push_back(1);
+  v.push_back(2);
+  EXPECT_TRUE(v.is_inline());
+  v.push_back(v[0]);  // aliasing an element while growing
+  v.emplace_back(4);
+  EXPECT_FALSE(v.is_inline());
+  ASSERT_EQ(v.size(), 4u);
+  EXPECT_EQ(v[2], 1);
+  EXPECT_EQ(v.back(), 4);
+
+  // Heap to heap: the old heap buffer is freed while the new element is added.
+  nc::InlineVector<int, 2> spilled{5, 6, 7, 8};
+  ASSERT_FALSE(spilled.is_inline());
+  ASSERT_EQ(spilled.size(), spilled.capacity());
+  spilled.emplace_back(spilled[0]);
+  spilled.push_back(spilled[1]);
+  EXPECT_EQ(std::vector<int>(spilled.begin(), spilled.end()), (std::vector<int>{5, 6, 7, 8, 5, 6}));
+
+  nc::InlineVector<int, 2> copy = v;
+  nc::InlineVector<int, 2> moved = std::move(v);
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(std::vector<int>(copy.begin(), copy.end()), (std::vector<int>{1, 2, 1, 4}));
+  EXPECT_EQ(std::vector<int>(moved.begin(), moved.end()), (std::vector<int>{1, 2, 1, 4}));
+
+  nc::InlineVector<int, 2> small{7};
+  nc::InlineVector<int, 2> small_moved = std::move(small);
+  EXPECT_TRUE(small_moved.is_inline());
+  EXPECT_EQ(small_moved[0], 7);
+}
+
+TEST(CompactDefectResult, RoundTripsThroughDefectResult) {
+  nc::DefectResult r;
+  r.frame_id = 17;
+  r.metadata = "shift=early";
+  r.camera_id = "cam_1";
+  nc::Defect with_all;
+  with_all.kind = nc::DefectKind::WrongItem;
+  with_all.bbox = {0.1f, 0.2f, 0.3f, 0.4f};
+  with_all.confidence = 0.9f;
+  with_all.product_id = 42;
+  with_all.category = "produce";
+  r.defects = {with_all, nc::Defect{}};
+
+  const auto compact = nc::CompactDefectResult::from(r);
+  EXPECT_TRUE(compact.defects.is_inline());
+  EXPECT_TRUE(compact.customer_id.empty());
+  const nc::DefectResult back = compact.to_result();
+  EXPECT_EQ(back.frame_id, 17u);
+  EXPECT_EQ(back.metadata, "shift=early");
+  EXPECT_EQ(back.camera_id, "cam_1");
+  EXPECT_FALSE(back.customer_id.has_value());
+  ASSERT_EQ(back.defects.size(), 2u);
+  EXPECT_EQ(back.defects[0].kind, nc::DefectKind::WrongItem);
+  EXPECT_EQ(back.defects[0].product_id, 42u);
+  EXPECT_EQ(back.defects[0].category, "produce");
+  EXPECT_FLOAT_EQ(back.defects[0].bbox.h, 0.4f);
+  EXPECT_FALSE(back.defects[1].product_id.has_value());
+  EXPECT_FALSE(back.defects[1].category.has_value());
+}
+
+TEST(DefectBatch, StoresDefectsAsColumnsWithFrameOffsets) {
+  nc::DefectBatch batch;
+  nc::DefectResult first;
+  first.frame_id = 1;
+  first.camera_id = "cam_1";
+  first.defects.resize(2);
+  first.defects[1].confidence = 0.7f;
+  first.defects[1].product_id = 5;
+  nc::DefectResult empty;
+  empty.frame_id = 2;
+  nc::CompactDefectResult third;
+  third.frame_id = 3;
+  nc::CompactDefect d;
+  d.kind = nc::DefectKind::WrongQuantity;
+  d.confidence = 0.8f;
+  third.defects.push_back(d);
+
+  batch.append(first);
+  batch.append(empty);
+  batch.append(third);
+  EXPECT_EQ(batch.size(), 3u);
+  EXPECT_EQ(batch.frames(), 3u);
+  EXPECT_EQ(std::vector<std::uint32_t>(batch.frame_offsets().begin(), batch.frame_offsets().end()),
+            (std::vector<std::uint32_t>{0, 2, 2, 3}));
+  EXPECT_EQ(batch.frame_index()[2], 2u);
+  EXPECT_FLOAT_EQ(batch.confidences()[1], 0.7f);
+  EXPECT_EQ(batch.product_ids()[1], 5u);
+  EXPECT_EQ(batch.has_product_id()[0], 0u);
+  EXPECT_EQ(batch.kinds()[2], nc::DefectKind::WrongQuantity);
+  EXPECT_EQ(batch.camera_ids()[0].view(), "cam_1");
+
+  const auto back = batch.result(0).to_result();
+  EXPECT_EQ(back.camera_id, "cam_1");
+  ASSERT_EQ(back.defects.size(), 2u);
+  EXPECT_EQ(back.defects[1].product_id, 5u);
+  EXPECT_TRUE(batch.result(1).defects.empty());
+
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(batch.frames(), 0u);
+  EXPECT_EQ(batch.frame_offsets().size(), 1u);
+}
+
+TEST(DefectBatch, KeepsMetadataOutOfTheInternTable) {
+  nc::DefectBatch batch;
+  nc::DefectResult r;
+  r.camera_id = "cam_1";
+  batch.append(r);  // interns cam_1 before counting
+  const std::size_t interned = nc::interned_string_count();
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    r.frame_id = i;
+    r.metadata = "{\"frame\":" + std::to_string(i) + "}";
+    batch.append(r);
+    EXPECT_EQ(nc::CompactDefectResult::from(r).metadata, r.metadata);
+  }
+  EXPECT_EQ(nc::interned_string_count(), interned);
+  EXPECT_EQ(batch.metadata(0), "");
+  EXPECT_EQ(batch.metadata(1), "{\"frame\":0}");
+  EXPECT_EQ(batch.result(1000).to_result().metadata, "{\"frame\":999}");
+}
@@ -0,0 +1,77 @@
+#include <normitri/core/executor.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace nc = normitri::core;
+
+TEST(Executor, ParallelForVisitsEveryIndexOnce) {
+  nc::Executor executor({.num_workers = 3, .cpu_affinity = {}});
+  EXPECT_EQ(executor.num_workers(), 3u);
+  for (std::size_t n : {0u, 1u, 2u, 8u, 1000u}) {
+    std::vector<std::atomic<int>> hits(n);
+    executor.parallel_for(n, [&](std::size_t i) { ++hits[i]; });
+    for (std::size_t i = 0; i < n; ++i) ASSERT_EQ(hits[i].load(), 1) << "n=" << n << " i=" << i;
+  }
+}
+
+TEST(Executor, MaxParallelismOneRunsOnTheCaller) {
+  nc::Executor executor({.num_workers = 2, .cpu_affinity = {}});
+  const auto caller = std::this_thread::get_id();
+  std::atomic<int> elsewhere{0};
+  executor.parallel_for(64, [&](std::size_t) {
+    if (std::this_thread::get_id() != caller) ++elsewhere;
+  }, 1);
+  EXPECT_EQ(elsewhere.load(), 0);
+}
+
+TEST(Executor, NestedParallelForDoesNotDeadlock) {
+  nc::Executor executor({.num_workers = 2, .cpu_affinity = {}});
+  std::atomic<int> total{0};
+  executor.parallel_for(8, [&](std::size_t) {
+    executor.parallel_for(8, [&](std::size_t) { ++total; });
+  });
+  EXPECT_EQ(total.load(), 64);
+}
+
+TEST(Executor, RethrowsTheFirstException) {
+  nc::Executor executor({.num_workers = 2, .cpu_affinity = {}});
+  EXPECT_THROW(executor.parallel_for(100, [](std::size_t i) {
+    if (i == 10) throw std::runtime_error("bad frame");
+  }), std::runtime_error);
+  std::atomic<int> after{0};
+  executor.parallel_for(10, [&](std::size_t) { ++after; });  // still usable
+  EXPECT_EQ(after.load(), 10);
+}
+
+TEST(Executor, IdleWorkersStealFromABusyOne) {
+  nc::Executor executor({.num_workers = 4, .cpu_affinity = {}});
+  std::atomic<int> done{0};
+  // One task fans out from a worker onto its own deque; the other workers can only get those
+  // tasks by stealing.
+  executor.submit([&] {
+    for (int i = 0; i < 64; ++i) {
+      executor.submit([&] {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        ++done;
+      });
+    }
+    ++done;
+  });
+  while (done.load() < 65) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_GT(executor.stats().steals, 0u);
+  EXPECT_GE(executor.stats().tasks_run, 64u);
+}
+
+TEST(Executor, DestructorRunsQueuedTasks) {
+  std::atomic<int> ran{0};
+  {
+    nc::Executor executor({.num_workers = 1, .cpu_affinity = {0}});
+    for (int i = 0; i < 100; ++i) executor.submit([&] { ++ran; });
+  }
+  EXPECT_EQ(ran.load(), 100);
+}
@@ -1,5 +1,9 @@
 #include <normitri/core/frame.hpp>
 #include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace nc = normitri::core;
@@ -28,3 +32,101 @@ TEST(Frame, MinBytes) {
   EXPECT_EQ(nc::Frame::min_bytes(10, 10, nc::PixelFormat::RGB8), 300u);
   EXPECT_EQ(nc::Frame::min_bytes(10, 10, nc::PixelFormat::Float32Planar), 10u * 10 * 3 * 4);
 }
+
+TEST(Frame, CopySharesBuffer) {
+  std::vector<std::byte> buf(4 * 4 * 3, std::byte{7});
+  nc::Frame a(4, 4, nc::PixelFormat::RGB8, std::move(buf));
+  nc::Frame b = a;
+  EXPECT_TRUE(b.shares_buffer_with(a));
+  EXPECT_EQ(std::as_const(b).data().data(), std::as_const(a).data().data());
+}
+
+TEST(Frame, MutableAccessCopiesOnWrite) {
+  std::vector<std::byte> buf(4 * 4 * 3, std::byte{7});
+  nc::Frame a(4, 4, nc::PixelFormat::RGB8, std::move(buf));
+  nc::Frame b = a;
+  b.data()[0] = std::byte{1};
+  EXPECT_FALSE(b.shares_buffer_with(a));
+  EXPECT_EQ(std::as_const(a).data()[0], std::byte{7});
+  EXPECT_EQ(std::as_const(b).data()[0], std::byte{1});
+
+  // Sole owner writes in place.
+  const std::byte* before = std::as_const(b).data().data();
+  b.data()[1] = std::byte{2};
+  EXPECT_EQ(std::as_const(b).data().data(), before);
+}
+
+TEST(Frame, ViewBorrowsWithoutCopy) {
+  std::vector<std::byte> pixels(8 * 2, std::byte{3});
+  nc::Frame v = nc::Frame::view(8, 2, nc::PixelFormat::Grayscale8, pixels);
+  EXPECT_TRUE(v.is_view());
+  EXPECT_EQ(std::as_const(v).data().data(), pixels.data());
+  EXPECT_EQ(v.size_bytes(), pixels.size());
+
+  v.data()[0] = std::byte{9};  // detaches; borrowed memory is never written
+  EXPECT_FALSE(v.is_view());
+  EXPECT_EQ(pixels[0], std::byte{3});
+}
+
+TEST(Frame, SharedImmutableBuffer) {
+  auto owner = std::make_shared<std::vector<std::byte>>(30, std::byte{5});
+  std::shared_ptr<const std::byte> bytes(owner, owner->data());
+  nc::Frame f(10, 1, nc::PixelFormat::RGB8, bytes, owner->size());
+  EXPECT_FALSE(f.is_view());
+  EXPECT_EQ(std::as_const(f).data().data(), owner->data());
+
+  nc::Frame relabeled(10, 1, nc::PixelFormat::BGR8, f.buffer(), f.size_bytes());
+  EXPECT_TRUE(relabeled.shares_buffer_with(f));
+}
+
+TEST(Frame, MoveLeavesSourceEmpty) {
+  std::vector<std::byte> buf(12);
+  nc::Frame a(2, 2, nc::PixelFormat::RGB8, std::move(buf));
+  nc::Frame b = std::move(a);
+  EXPECT_TRUE(a.empty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(a.size_bytes(), 0u);
+  EXPECT_EQ(b.size_bytes(), 12u);
+}
+
+TEST(Frame, PrepareReusesExclusiveBuffer) {
+  nc::Frame f;
+  const std::byte* first = f.prepare(8, 8, nc::PixelFormat::RGB8, 8 * 8 * 3).data();
+  const std::byte* second = f.prepare(4, 4, nc::PixelFormat::Grayscale8, 16).data();
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(f.width(), 4u);
+  EXPECT_EQ(f.format(), nc::PixelFormat::Grayscale8);
+  EXPECT_EQ(f.size_bytes(), 16u);
+
+  nc::Frame keep = f;  // shared: prepare must not overwrite keep's bytes
+  const std::byte* third = f.prepare(4, 4, nc::PixelFormat::Grayscale8, 16).data();
+  EXPECT_NE(third, std::as_const(keep).data().data());
+}
+
+TEST(Frame, LayoutDefaultsToHwcAndPrepareResetsIt) {
+  nc::Frame f;
+  EXPECT_EQ(f.layout(), nc::TensorLayout::HWC);
+  f.prepare(2, 2, nc::PixelFormat::Float32Planar, 2 * 2 * 3 * sizeof(float));
+  f.set_layout(nc::TensorLayout::CHW);
+  nc::Frame copy = f;
+  EXPECT_EQ(copy.layout(), nc::TensorLayout::CHW);
+  f.prepare(2, 2, nc::PixelFormat::RGB8, 12);
+  EXPECT_EQ(f.layout(), nc::TensorLayout::HWC);
+}
+
+TEST(Frame, ElementTypeAndLayoutAwareSizes) {
+  EXPECT_EQ(nc::Frame::min_bytes(10, 10, nc::PixelFormat::Float32Planar, nc::ElementType::Float16),
+            10u * 10 * 3 * 2);
+  EXPECT_EQ(nc::Frame::min_bytes(10, 10, nc::PixelFormat::RGB8, nc::ElementType::Int8), 300u);
+
+  std::vector<std::byte> buf(4 * 2 * 3 * sizeof(float));
+  nc::Frame f(4, 2, nc::PixelFormat::Float32Planar, std::move(buf));
+  EXPECT_EQ(f.element_type(), nc::ElementType::Float32);
+  EXPECT_EQ(f.shape(), (std::array<std::uint32_t, 3>{2, 4, 3}));
+  f.set_layout(nc::TensorLayout::CHW);
+  EXPECT_EQ(f.shape(), (std::array<std::uint32_t, 3>{3, 2, 4}));
+  f.set_element_type(nc::ElementType::Float16);
+  EXPECT_EQ(f.min_bytes(), 4u * 2 * 3 * 2);
+
+  f.prepare(4, 2, nc::PixelFormat::RGB8, 24);
+  EXPECT_EQ(f.element_type(), nc::ElementType::UInt8);
+}
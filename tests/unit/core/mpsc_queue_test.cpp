@@ -0,0 +1,46 @@
+#include <normitri/core/mpsc_queue.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using normitri::core::MpscQueue;
+
+TEST(MpscQueue, PopsInPushOrder) {
+  MpscQueue<std::string> queue;
+  EXPECT_FALSE(queue.pop().has_value());
+  queue.push("a");
+  queue.push("b");
+  EXPECT_EQ(queue.pop().value_or(""), "a");
+  queue.push("c");
+  EXPECT_EQ(queue.pop().value_or(""), "b");
+  EXPECT_EQ(queue.pop().value_or(""), "c");
+  EXPECT_FALSE(queue.pop().has_value());
+  queue.push("left behind");  // freed by the destructor
+}
+
+TEST(MpscQueue, ManyProducersKeepTheirOwnOrder) {
+  constexpr std::size_t kProducers = 4;
+  constexpr std::size_t kPerProducer = 20000;
+  MpscQueue<std::size_t> queue;
+  std::vector<std::jthread> producers;
+  for (std::size_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&queue, p] {
+      for (std::size_t i = 0; i < kPerProducer; ++i) queue.push(p * kPerProducer + i);
+    });
+  }
+  std::vector<std::size_t> next(kProducers, 0);
+  for (std::size_t received = 0; received < kProducers * kPerProducer;) {
+    const auto value = queue.pop();
+    if (!value) {
+      std::this_thread::yield();
+      continue;
+    }
+    const std::size_t p = *value / kPerProducer;
+    ASSERT_EQ(*value % kPerProducer, next[p]++);
+    ++received;
+  }
+  EXPECT_FALSE(queue.pop().has_value());
+}
@@ -1,9 +1,15 @@
+#include <normitri/core/buffer_pool.hpp>
 #include <normitri/core/defect_result.hpp>
 #include <normitri/core/frame.hpp>
 #include <normitri/core/pipeline.hpp>
+#include <normitri/core/pipeline_replicas.hpp>
 #include <normitri/core/pipeline_stage.hpp>
 #include <gtest/gtest.h>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace nc = normitri::core;
@@ -18,6 +24,9 @@ class PassThroughStage : public nc::IPipelineStage {
     return nc::StageOutput{nc::Frame(input.width(), input.height(),
                                       input.format(), std::move(buf))};
   }
+  std::unique_ptr<nc::IPipelineStage> clone() const override {
+    return std::make_unique<PassThroughStage>(*this);
+  }
 };
 
 class EmitDefectResultStage : public nc::IPipelineStage {
@@ -31,6 +40,70 @@ class EmitDefectResultStage : public nc::IPipelineStage {
   }
 };
 
+/// Frame -> Frame stage with an in-place path: writes input bytes + 1 into the output.
+class IncrementIntoStage : public nc::IPipelineStage {
+ public:
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame&) override {
+    ++process_calls;
+    return std::unexpected(nc::PipelineError::InvalidConfig);  // must not be used
+  }
+  bool supports_process_into() const noexcept override { return true; }
+  std::expected<nc::StageIntoResult, nc::PipelineError> process_into(
+      const nc::Frame& input, nc::Frame& output) override {
+    if (pass_through) return nc::StageIntoResult::PassThrough;
+    auto out =
+        output.prepare(input.width(), input.height(), input.format(), input.size_bytes(), pool);
+    const auto in = input.data();
+    for (std::size_t i = 0; i < in.size(); ++i) {
+      out[i] = std::byte{static_cast<unsigned char>(static_cast<unsigned char>(in[i]) + 1)};
+    }
+    outputs.push_back(std::as_const(output).data().data());
+    return nc::StageIntoResult::Written;
+  }
+  int process_calls{0};
+  bool pass_through{false};
+  nc::BufferPool* pool{nullptr};
+  std::vector<const std::byte*> outputs;
+};
+
+/// Emits a DefectResult whose frame_id is the first byte of its input.
+class EmitFirstByteStage : public nc::IPipelineStage {
+ public:
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    nc::DefectResult r;
+    r.frame_id = static_cast<std::uint64_t>(input.data()[0]);
+    return nc::StageOutput{std::move(r)};
+  }
+  std::unique_ptr<nc::IPipelineStage> clone() const override {
+    return std::make_unique<EmitFirstByteStage>(*this);
+  }
+};
+
+/// Fails frames whose first byte is zero; passes the others through unchanged.
+class RejectZeroStage : public nc::IPipelineStage {
+ public:
+  std::expected<nc::StageOutput, nc::PipelineError> process(const nc::Frame& input) override {
+    if (input.data()[0] == std::byte{0}) return std::unexpected(nc::PipelineError::InvalidFrame);
+    return nc::StageOutput{input};
+  }
+};
+
+/// Batch-capable EmitFirstByteStage that records the size of every batch it receives.
+class BatchEmitStage : public EmitFirstByteStage {
+ public:
+  bool supports_batch() const noexcept override { return true; }
+  std::vector<std::expected<nc::StageOutput, nc::PipelineError>> process_batch(
+      std::span<const nc::Frame> inputs) override {
+    batch_sizes.push_back(inputs.size());
+    return nc::IPipelineStage::process_batch(inputs);
+  }
+  std::vector<std::size_t> batch_sizes;
+};
+
+nc::Frame make_byte_frame(std::uint8_t value) {
+  return nc::Frame(2, 2, nc::PixelFormat::Grayscale8, std::vector<std::byte>(4, std::byte{value}));
+}
+
 }  // namespace
 
 TEST(Pipeline, EmptyPipelineReturnsError) {
@@ -65,3 +138,221 @@ TEST(Pipeline, PassThroughThenEmit) {
   ASSERT_TRUE(result.has_value());
   EXPECT_EQ(result->defects.size(), 1u);
 }
+
+TEST(Pipeline, PrefersProcessIntoAndPingPongs) {
+  nc::Pipeline p;
+  auto first = std::make_unique<IncrementIntoStage>();
+  auto second = std::make_unique<IncrementIntoStage>();
+  IncrementIntoStage* s1 = first.get();
+  IncrementIntoStage* s2 = second.get();
+  p.add_stage(std::move(first));
+  p.add_stage(std::move(second));
+  p.add_stage(std::make_unique<EmitFirstByteStage>());
+
+  std::vector<std::byte> buf(16, std::byte{5});
+  nc::Frame f(4, 4, nc::PixelFormat::Grayscale8, std::move(buf));
+  for (int run = 0; run < 3; ++run) {
+    auto result = p.run(f);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->frame_id, 7u);
+  }
+  EXPECT_EQ(s1->process_calls, 0);
+  EXPECT_EQ(s2->process_calls, 0);
+  ASSERT_EQ(s1->outputs.size(), 3u);
+  // Two scratch frames alternate and are reused across runs; the input is never written.
+  EXPECT_NE(s1->outputs[0], s2->outputs[0]);
+  EXPECT_EQ(s1->outputs[0], s1->outputs[2]);
+  EXPECT_EQ(s2->outputs[0], s2->outputs[2]);
+  EXPECT_EQ(std::as_const(f).data()[0], std::byte{5});
+}
+
+TEST(Pipeline, PooledScratchReturnsToThePoolAfterEachRun) {
+  nc::BufferPool pool;
+  nc::Pipeline p;
+  auto stage = std::make_unique<IncrementIntoStage>();
+  stage->pool = &pool;
+  p.add_stage(std::move(stage));
+  p.add_stage(std::make_unique<EmitFirstByteStage>());
+  nc::Frame f(16, 16, nc::PixelFormat::Grayscale8, std::vector<std::byte>(256, std::byte{1}));
+  for (int run = 0; run < 3; ++run) {
+    auto result = p.run(f);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->frame_id, 2u);
+    // Nothing stays checked out between runs; later runs reuse the cached block.
+    EXPECT_EQ(pool.stats().returns, static_cast<std::uint64_t>(run + 1));
+  }
+  EXPECT_EQ(pool.stats().misses, 1u);
+  EXPECT_EQ(pool.stats().hits, 2u);
+}
+
+TEST(Pipeline, ReleaseThreadScratchFreesHeapScratch) {
+  nc::Pipeline p;
+  auto stage = std::make_unique<IncrementIntoStage>();
+  IncrementIntoStage* s = stage.get();
+  p.add_stage(std::move(stage));
+  p.add_stage(std::make_unique<EmitFirstByteStage>());
+  nc::Frame f(16, 16, nc::PixelFormat::Grayscale8, std::vector<std::byte>(256, std::byte{1}));
+  ASSERT_TRUE(p.run(f).has_value());
+  ASSERT_TRUE(p.run(f).has_value());
+  EXPECT_EQ(s->outputs[0], s->outputs[1]);  // heap scratch is kept between runs
+  nc::Pipeline::release_thread_scratch();
+  auto result = p.run(f);  // allocates fresh scratch
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->frame_id, 2u);
+  EXPECT_EQ(s->outputs.size(), 3u);
+}
+
+TEST(Pipeline, ProcessIntoPassThroughKeepsInput) {
+  nc::Pipeline p;
+  auto stage = std::make_unique<IncrementIntoStage>();
+  stage->pass_through = true;
+  p.add_stage(std::move(stage));
+  p.add_stage(std::make_unique<PassThroughStage>());
+  p.add_stage(std::make_unique<EmitFirstByteStage>());
+  std::vector<std::byte> buf(4, std::byte{9});
+  nc::Frame f(2, 2, nc::PixelFormat::Grayscale8, std::move(buf));
+  auto result = p.run(f);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->frame_id, 9u);
+}
+
+TEST(Pipeline, RunBatchPreprocessesPerFrameThenCallsBatchStageOnce) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<IncrementIntoStage>());
+  auto emit = std::make_unique<BatchEmitStage>();
+  BatchEmitStage* batch_stage = emit.get();
+  p.add_stage(std::move(emit));
+
+  std::vector<nc::Frame> frames;
+  for (std::uint8_t v = 10; v < 14; ++v) frames.push_back(make_byte_frame(v));
+  auto results = p.run_batch(frames, 1);  // IncrementIntoStage records outputs; one worker
+  ASSERT_EQ(results.size(), 4u);
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    ASSERT_TRUE(results[i].has_value());
+    EXPECT_EQ(results[i]->frame_id, 11u + i);
+  }
+  ASSERT_EQ(batch_stage->batch_sizes.size(), 1u);
+  EXPECT_EQ(batch_stage->batch_sizes[0], 4u);
+  EXPECT_EQ(std::as_const(frames[0]).data()[0], std::byte{10});
+}
+
+TEST(Pipeline, RunBatchKeepsFailedFramesOutOfTheBatch) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<RejectZeroStage>());
+  p.add_stage(std::make_unique<PassThroughStage>());
+  auto emit = std::make_unique<BatchEmitStage>();
+  BatchEmitStage* batch_stage = emit.get();
+  p.add_stage(std::move(emit));
+
+  std::vector<nc::Frame> frames{make_byte_frame(3), make_byte_frame(0), make_byte_frame(5),
+                                make_byte_frame(0), make_byte_frame(7)};
+  auto results = p.run_batch(frames, 4);
+  ASSERT_EQ(results.size(), 5u);
+  ASSERT_TRUE(results[0].has_value());
+  EXPECT_EQ(results[0]->frame_id, 3u);
+  ASSERT_FALSE(results[1].has_value());
+  EXPECT_EQ(results[1].error(), nc::PipelineError::InvalidFrame);
+  ASSERT_TRUE(results[2].has_value());
+  EXPECT_EQ(results[2]->frame_id, 5u);
+  EXPECT_FALSE(results[3].has_value());
+  ASSERT_TRUE(results[4].has_value());
+  EXPECT_EQ(results[4]->frame_id, 7u);
+  ASSERT_EQ(batch_stage->batch_sizes.size(), 1u);
+  EXPECT_EQ(batch_stage->batch_sizes[0], 3u);
+}
+
+TEST(Pipeline, RunBatchWithoutBatchStageMatchesRun) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<PassThroughStage>());
+  p.add_stage(std::make_unique<EmitFirstByteStage>());
+  std::vector<nc::Frame> frames{make_byte_frame(1), make_byte_frame(2)};
+  auto results = p.run_batch(frames);
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0]->frame_id, 1u);
+  EXPECT_EQ(results[1]->frame_id, 2u);
+
+  nc::Pipeline empty;
+  auto none = empty.run_batch(frames);
+  ASSERT_EQ(none.size(), 2u);
+  EXPECT_EQ(none[1].error(), nc::PipelineError::InvalidConfig);
+}
+
+TEST(Pipeline, RunToAndFromBatchStageSplitsRunBatch) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<IncrementIntoStage>());
+  p.add_stage(std::make_unique<RejectZeroStage>());
+  auto emit = std::make_unique<BatchEmitStage>();
+  BatchEmitStage* batch_stage = emit.get();
+  p.add_stage(std::move(emit));
+  EXPECT_EQ(p.batch_stage(), 2u);
+
+  std::vector<nc::Frame> prepared;
+  for (std::uint8_t v : {std::uint8_t{4}, std::uint8_t{255}, std::uint8_t{6}}) {
+    auto out = p.run_to_batch_stage(make_byte_frame(v));
+    if (v == 255) {  // incremented to 0 and rejected
+      ASSERT_FALSE(out.has_value());
+      continue;
+    }
+    ASSERT_TRUE(out.has_value());
+    prepared.push_back(std::get<nc::Frame>(std::move(*out)));
+  }
+  EXPECT_TRUE(batch_stage->batch_sizes.empty());
+  auto results = p.run_from_batch_stage(prepared);
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0]->frame_id, 5u);
+  EXPECT_EQ(results[1]->frame_id, 7u);
+  EXPECT_EQ(batch_stage->batch_sizes, std::vector<std::size_t>{2});
+
+  nc::Pipeline early;
+  early.add_stage(std::make_unique<EmitFirstByteStage>());
+  early.add_stage(std::make_unique<BatchEmitStage>());
+  auto finished = early.run_to_batch_stage(make_byte_frame(9));
+  ASSERT_TRUE(finished.has_value());
+  EXPECT_EQ(std::get<nc::DefectResult>(*finished).frame_id, 9u);
+}
+
+TEST(Pipeline, CloneRunsLikeTheOriginal) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<PassThroughStage>());
+  p.add_stage(std::make_unique<EmitFirstByteStage>());
+  auto replica = p.clone();
+  ASSERT_TRUE(replica.has_value());
+  EXPECT_EQ(replica->stage_count(), 2u);
+  auto result = replica->run(make_byte_frame(9));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->frame_id, 9u);
+
+  p.add_stage(std::make_unique<EmitDefectResultStage>());  // no clone()
+  auto failed = p.clone();
+  ASSERT_FALSE(failed.has_value());
+  EXPECT_EQ(failed.error(), nc::PipelineError::InvalidConfig);
+}
+
+TEST(PipelineReplicas, ReusesIdleReplicasAndClonesWhenAllAreBusy) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<EmitFirstByteStage>());
+  nc::PipelineReplicas replicas(std::move(p));
+  EXPECT_EQ(replicas.size(), 1u);
+
+  nc::Pipeline* first = nullptr;
+  {
+    auto a = replicas.acquire();
+    auto b = replicas.acquire();
+    EXPECT_NE(&*a, &*b);
+    EXPECT_EQ(replicas.size(), 2u);
+    first = &*a;
+    auto result = b->run(make_byte_frame(4));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->frame_id, 4u);
+  }
+  auto c = replicas.acquire();
+  auto d = replicas.acquire();
+  EXPECT_TRUE(&*c == first || &*d == first);
+  EXPECT_EQ(replicas.size(), 2u);
+}
+
+TEST(PipelineReplicas, RejectsPipelinesThatCannotBeCloned) {
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<EmitDefectResultStage>());
+  EXPECT_THROW(nc::PipelineReplicas replicas(std::move(p)), std::invalid_argument);
+}
@@ -0,0 +1,73 @@
+#include <normitri/core/executor.hpp>
+#include <normitri/core/reorder_ring.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using normitri::core::Executor;
+using normitri::core::ReorderRing;
+
+TEST(ReorderRing, ReleasesInIndexOrderAndSkipsEmptySlots) {
+  std::vector<int> out;
+  ReorderRing<int> ring(4, [&](int& v) { out.push_back(v); });
+  EXPECT_EQ(ring.window(), 4u);
+  ring.push(2, 20);
+  ring.push(1, std::nullopt);
+  EXPECT_TRUE(out.empty());
+  EXPECT_EQ(ring.next(), 0u);
+  ring.push(0, 0);
+  EXPECT_EQ(out, (std::vector<int>{0, 20}));
+  EXPECT_EQ(ring.next(), 3u);
+  ring.push(4, 40);
+  ring.push(3, 30);
+  EXPECT_EQ(out, (std::vector<int>{0, 20, 30, 40}));
+  EXPECT_EQ(ReorderRing<int>(5, [](int&) {}).window(), 8u);
+}
+
+TEST(ReorderRing, ProducerTooFarAheadWaitsForTheWindow) {
+  std::vector<int> out;
+  ReorderRing<int> ring(2, [&](int& v) { out.push_back(v); });
+  ring.push(1, 1);
+  std::atomic<bool> pushed{false};
+  std::thread ahead([&] {
+    ring.push(2, 2);  // two ahead of index 0: waits until 0 is released
+    pushed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(pushed.load());
+  ring.push(0, 0);
+  ahead.join();
+  EXPECT_EQ(out, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(ReorderRing, ParallelProducersDeliverInOrder) {
+  constexpr std::size_t kN = 5000;
+  Executor executor({.num_workers = 4, .cpu_affinity = {}});
+  std::vector<std::size_t> out;
+  ReorderRing<std::size_t> ring(8, [&](std::size_t& v) { out.push_back(v); });
+  executor.parallel_for(kN, [&](std::size_t i) {
+    ring.push(i, i % 7 == 3 ? std::nullopt : std::optional(i));
+  });
+  ASSERT_EQ(ring.next(), kN);
+  std::size_t expected = 0;
+  for (std::size_t v : out) {
+    if (expected % 7 == 3) ++expected;
+    ASSERT_EQ(v, expected++);
+  }
+  EXPECT_EQ(expected, kN);
+}
+
+TEST(ReorderRing, SinkExceptionStopsTheRing) {
+  ReorderRing<int> ring(2, [](int& v) {
+    if (v == 1) throw std::runtime_error("sink failed");
+  });
+  ring.push(0, 0);
+  EXPECT_THROW(ring.push(1, 1), std::runtime_error);
+  ring.push(5, 5);  // would wait for index 4 otherwise
+  SUCCEED();
+}
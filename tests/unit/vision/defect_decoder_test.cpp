@@ -2,6 +2,8 @@
 #include <normitri/vision/defect_decoder.hpp>
 #include <normitri/vision/inference_result.hpp>
 #include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace nv = normitri::vision;
@@ -42,3 +44,116 @@ TEST(DefectDecoder, AboveThresholdDecoded) {
   EXPECT_FLOAT_EQ(out[0].bbox.w, 0.3f);
   EXPECT_FLOAT_EQ(out[0].bbox.h, 0.3f);
 }
+
+TEST(DefectDecoder, ShortBoxAndClassArraysKeepThePresentEntries) {
+  nv::InferenceResult r;
+  r.num_detections = 3;
+  r.scores = {0.9f, 0.8f, 0.7f};
+  r.boxes = {0.1f, 0.2f, 0.4f, 0.5f, 0.f, 0.f};  // a box for detection 0 only
+  r.class_ids = {1, 0};                          // no class id for detection 2
+  nv::DefectDecoder dec(0.5f, {nc::DefectKind::WrongItem, nc::DefectKind::WrongQuantity});
+  const auto out = dec.decode(r);
+  ASSERT_EQ(out.size(), 3u);
+  EXPECT_EQ(out[0].kind, nc::DefectKind::WrongQuantity);
+  EXPECT_FLOAT_EQ(out[0].bbox.w, 0.3f);
+  EXPECT_EQ(out[1].kind, nc::DefectKind::WrongItem);
+  EXPECT_EQ(out[1].product_id, 0u);
+  EXPECT_FLOAT_EQ(out[1].bbox.w, 0.f);
+  EXPECT_EQ(out[2].kind, nc::DefectKind::ProcessError);
+  EXPECT_FALSE(out[2].product_id.has_value());
+
+  const nv::InferenceResult copy = nv::DetectionView::of(r).materialize();
+  EXPECT_EQ(copy.boxes.size(), 4u);
+  EXPECT_EQ(copy.class_ids, (std::vector<std::int64_t>{1, 0}));
+}
+
+TEST(DefectDecoder, StridedViewMatchesInferenceResult) {
+  // Column-major [6, N] YOLO output: rows x1, y1, x2, y2, score, class id.
+  constexpr std::size_t kN = 5;
+  const std::vector<float> out = {
+      0.1f, 0.2f, 0.3f, 0.4f, 0.5f,  // x1
+      0.1f, 0.2f, 0.3f, 0.4f, 0.5f,  // y1
+      0.2f, 0.4f, 0.6f, 0.8f, 0.9f,  // x2
+      0.3f, 0.5f, 0.7f, 0.9f, 1.0f,  // y2
+      0.9f, 0.2f, 0.6f, 0.5f, 0.1f,  // score
+      0.f,  1.f,  1.f,  7.f,  0.f,   // class id
+  };
+  nv::DetectionView view;
+  view.count = kN;
+  view.boxes = out.data();
+  view.box_stride = 1;
+  view.coord_stride = kN;
+  view.scores = out.data() + 4 * kN;
+  view.class_ids_f32 = out.data() + 5 * kN;
+
+  nv::DefectDecoder dec(0.5f, {nc::DefectKind::WrongItem, nc::DefectKind::WrongQuantity});
+  const auto from_view = dec.decode(view);
+  ASSERT_EQ(from_view.size(), 3u);
+  EXPECT_EQ(from_view[0].kind, nc::DefectKind::WrongItem);
+  EXPECT_EQ(from_view[1].kind, nc::DefectKind::WrongQuantity);
+  EXPECT_EQ(from_view[2].kind, nc::DefectKind::ProcessError);  // unmapped class 7
+  EXPECT_FLOAT_EQ(from_view[1].bbox.x, 0.3f);
+  EXPECT_FLOAT_EQ(from_view[1].bbox.w, 0.3f);
+  EXPECT_FLOAT_EQ(from_view[1].bbox.h, 0.4f);
+
+  const auto from_result = dec.decode(view.materialize());
+  ASSERT_EQ(from_result.size(), from_view.size());
+  for (std::size_t i = 0; i < from_view.size(); ++i) {
+    EXPECT_EQ(from_result[i].kind, from_view[i].kind);
+    EXPECT_EQ(from_result[i].product_id, from_view[i].product_id);
+    EXPECT_FLOAT_EQ(from_result[i].confidence, from_view[i].confidence);
+    EXPECT_FLOAT_EQ(from_result[i].bbox.x, from_view[i].bbox.x);
+    EXPECT_FLOAT_EQ(from_result[i].bbox.h, from_view[i].bbox.h);
+  }
+}
+
+TEST(DefectDecoder, NmsSuppressesOverlapsOfTheSameClassOnly) {
+  nv::InferenceResult r;
+  r.num_detections = 4;
+  r.boxes = {
+      0.10f, 0.10f, 0.50f, 0.50f,  // class 0
+      0.12f, 0.11f, 0.52f, 0.50f,  // class 0, duplicate of the first
+      0.11f, 0.10f, 0.50f, 0.51f,  // class 1, same place
+      0.60f, 0.60f, 0.90f, 0.90f,  // class 0, elsewhere
+  };
+  r.scores = {0.8f, 0.9f, 0.7f, 0.6f};
+  r.class_ids = {0, 0, 1, 0};
+  nv::DefectDecoder dec(0.5f, {nc::DefectKind::WrongItem, nc::DefectKind::WrongQuantity},
+                        {.iou_threshold = 0.5f});
+  auto out = dec.decode(r);
+  ASSERT_EQ(out.size(), 3u);
+  EXPECT_FLOAT_EQ(out[0].confidence, 0.9f);  // highest score first; 0.8 suppressed by it
+  EXPECT_FLOAT_EQ(out[1].confidence, 0.7f);
+  EXPECT_EQ(out[1].kind, nc::DefectKind::WrongQuantity);
+  EXPECT_FLOAT_EQ(out[2].confidence, 0.6f);
+
+  dec.set_nms({.iou_threshold = 0.5f, .class_aware = false});
+  out = dec.decode(r);
+  ASSERT_EQ(out.size(), 2u);
+  EXPECT_FLOAT_EQ(out[0].confidence, 0.9f);
+  EXPECT_FLOAT_EQ(out[1].confidence, 0.6f);
+}
+
+TEST(DefectDecoder, TopKAndMaxDetectionsKeepTheHighestScores) {
+  constexpr std::uint32_t kN = 40;
+  nv::InferenceResult r;
+  r.num_detections = kN;
+  for (std::uint32_t i = 0; i < kN; ++i) {
+    const float x = static_cast<float>(i) * 0.02f;  // disjoint boxes
+    r.boxes.insert(r.boxes.end(), {x, 0.f, x + 0.01f, 0.01f});
+    r.scores.push_back(0.5f + static_cast<float>((i * 7u) % kN) / 100.f);
+    r.class_ids.push_back(i % 2);
+  }
+  nv::DefectDecoder dec(0.5f, {nc::DefectKind::WrongItem, nc::DefectKind::WrongQuantity},
+                        {.iou_threshold = 0.5f, .top_k = 10});
+  auto out = dec.decode(r);
+  ASSERT_EQ(out.size(), 10u);
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    EXPECT_NEAR(out[i].confidence, 0.89f - static_cast<float>(i) / 100.f, 1e-6f);
+  }
+
+  dec.set_nms({.max_detections = 3});
+  out = dec.decode(r);
+  ASSERT_EQ(out.size(), 3u);
+  EXPECT_NEAR(out[2].confidence, 0.87f, 1e-6f);
+}
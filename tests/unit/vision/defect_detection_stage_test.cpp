@@ -0,0 +1,64 @@
+#include <normitri/core/defect.hpp>
+#include <normitri/core/error.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/core/pipeline.hpp>
+#include <normitri/vision/defect_decoder.hpp>
+#include <normitri/vision/defect_detection_stage.hpp>
+#include <normitri/vision/mock_inference_backend.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace nv = normitri::vision;
+namespace nc = normitri::core;
+
+namespace {
+
+/// Mock backend that counts single and batched inference calls.
+class CountingBackend : public nv::MockInferenceBackend {
+ public:
+  std::expected<nv::InferenceResult, nc::PipelineError> infer(const nc::Frame& input) override {
+    ++infer_calls;
+    return MockInferenceBackend::infer(input);
+  }
+  std::expected<std::vector<nv::InferenceResult>, nc::PipelineError> infer_batch(
+      std::span<const nc::Frame> inputs) override {
+    batch_sizes.push_back(inputs.size());
+    return MockInferenceBackend::infer_batch(inputs);
+  }
+  int infer_calls{0};
+  std::vector<std::size_t> batch_sizes;
+};
+
+nc::Frame make_frame() {
+  return nc::Frame(4, 4, nc::PixelFormat::RGB8, std::vector<std::byte>(48));
+}
+
+}  // namespace
+
+TEST(DefectDetectionStage, RunBatchMakesOneInferBatchCall) {
+  auto backend = std::make_unique<CountingBackend>();
+  backend->set_defects({{nc::DefectKind::WrongItem, {0.f, 0.f, 1.f, 1.f}, 0.9f, std::nullopt,
+                         std::nullopt}});
+  CountingBackend* counting = backend.get();
+  nc::Pipeline p;
+  p.add_stage(std::make_unique<nv::DefectDetectionStage>(
+      std::move(backend), nv::DefectDecoder(0.5f, {nc::DefectKind::WrongItem})));
+
+  std::vector<nc::Frame> frames{make_frame(), nc::Frame{}, make_frame(), make_frame()};
+  auto results = p.run_batch(frames);
+  ASSERT_EQ(results.size(), 4u);
+  for (std::size_t i : {0u, 2u, 3u}) {
+    ASSERT_TRUE(results[i].has_value());
+    ASSERT_EQ(results[i]->defects.size(), 1u);
+    EXPECT_EQ(results[i]->defects[0].kind, nc::DefectKind::WrongItem);
+  }
+  ASSERT_FALSE(results[1].has_value());
+  EXPECT_EQ(results[1].error(), nc::PipelineError::InvalidFrame);
+
+  // The empty frame fails validation and is left out; the rest share one backend call.
+  EXPECT_EQ(counting->infer_calls, 0);
+  ASSERT_EQ(counting->batch_sizes.size(), 1u);
+  EXPECT_EQ(counting->batch_sizes[0], 3u);
+}
@@ -0,0 +1,165 @@
+#include <normitri/core/error.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/vision/inference_session_pool.hpp>
+#include <normitri/vision/mock_inference_backend.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace nv = normitri::vision;
+namespace nc = normitri::core;
+
+namespace {
+
+/// Factory for mock sessions that counts how many were created.
+nv::InferenceSessionPool::Factory counting_factory(std::shared_ptr<std::atomic<int>> created) {
+  return [created] {
+    ++*created;
+    auto mock = std::make_unique<nv::MockInferenceBackend>();
+    mock->set_defects({{nc::DefectKind::WrongItem, {0.1f, 0.1f, 0.2f, 0.2f}, 0.9f,
+                        std::nullopt, std::nullopt}});
+    return mock;
+  };
+}
+
+nc::Frame make_frame() {
+  std::vector<std::byte> buf(12);
+  return nc::Frame(2, 2, nc::PixelFormat::RGB8, std::move(buf));
+}
+
+}  // namespace
+
+TEST(InferenceSessionPool, CapacityLimitedByMemoryBudget) {
+  auto created = std::make_shared<std::atomic<int>>(0);
+  nv::SessionPoolOptions options;
+  options.max_sessions = 8;
+  options.memory_budget_bytes = 300;
+  options.session_memory_bytes = 100;
+  nv::InferenceSessionPool pool(counting_factory(created), options);
+  EXPECT_EQ(pool.capacity(), 3u);
+
+  options.memory_budget_bytes = 50;  // below one session: still one
+  nv::InferenceSessionPool tiny(counting_factory(created), options);
+  EXPECT_EQ(tiny.capacity(), 1u);
+  EXPECT_EQ(created->load(), 0);  // sessions are created on demand
+
+  options.session_memory_bytes = 0;  // a budget without a session size would be ignored
+  EXPECT_THROW(nv::InferenceSessionPool(counting_factory(created), options),
+               std::invalid_argument);
+}
+
+TEST(InferenceSessionPool, WarmsUpLazilyCreatedSessions) {
+  class WarmupCounting : public nv::MockInferenceBackend {
+   public:
+    explicit WarmupCounting(std::atomic<int>* warmed) : warmed_(warmed) {}
+    void warmup() override { ++*warmed_; }
+
+   private:
+    std::atomic<int>* warmed_;
+  };
+  std::atomic<int> warmed{0};
+  nv::InferenceSessionPool pool([&warmed] { return std::make_unique<WarmupCounting>(&warmed); },
+                                {.max_sessions = 3});
+  {
+    auto a = pool.checkout();
+    EXPECT_EQ(warmed.load(), 1);
+    auto b = pool.try_checkout();
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(warmed.load(), 2);
+  }
+  auto reused = pool.checkout();  // an idle session: no second warmup
+  EXPECT_EQ(warmed.load(), 2);
+  pool.warmup();
+  EXPECT_EQ(warmed.load(), 3);
+  EXPECT_EQ(pool.stats().sessions, 3u);
+}
+
+TEST(InferenceSessionPool, CreatesLazilyAndReusesReturnedSessions) {
+  auto created = std::make_shared<std::atomic<int>>(0);
+  nv::InferenceSessionPool pool(counting_factory(created), {.max_sessions = 2});
+  {
+    auto a = pool.checkout();
+    auto b = pool.checkout();
+    EXPECT_NE(&*a, &*b);
+    EXPECT_FALSE(pool.try_checkout().has_value());
+    EXPECT_EQ(pool.stats().in_use, 2u);
+  }
+  auto again = pool.checkout();
+  EXPECT_EQ(created->load(), 2);
+  const auto stats = pool.stats();
+  EXPECT_EQ(stats.sessions, 2u);
+  EXPECT_EQ(stats.in_use, 1u);
+  EXPECT_EQ(stats.checkouts, 3u);
+  EXPECT_EQ(stats.waits, 0u);
+}
+
+TEST(InferenceSessionPool, BlockedCheckoutRecordsWaitTime) {
+  auto created = std::make_shared<std::atomic<int>>(0);
+  nv::InferenceSessionPool pool(counting_factory(created), {.max_sessions = 1});
+  auto held = std::make_unique<nv::InferenceSessionPool::Lease>(pool.checkout());
+  std::atomic<bool> checking_out{false};
+  std::jthread waiter([&] {
+    checking_out.store(true);
+    auto lease = pool.checkout();
+  });
+  // Release only once the waiter is about to block, then give it time to get into checkout().
+  while (!checking_out.load()) std::this_thread::yield();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  held.reset();
+  waiter.join();
+
+  const auto stats = pool.stats();
+  EXPECT_EQ(stats.waits, 1u);
+  EXPECT_GT(stats.max_wait_ns, 0u);
+  EXPECT_EQ(stats.total_wait_ns, stats.max_wait_ns);
+  EXPECT_EQ(stats.in_use, 0u);
+}
+
+TEST(InferenceSessionPool, FailedCreationFreesTheSlot) {
+  int calls = 0;
+  nv::InferenceSessionPool pool(
+      [&calls]() -> std::unique_ptr<nv::IInferenceBackend> {
+        if (++calls == 1) throw std::runtime_error("model not found");
+        return std::make_unique<nv::MockInferenceBackend>();
+      },
+      {.max_sessions = 1});
+  EXPECT_THROW((void)pool.checkout(), std::runtime_error);
+  auto lease = pool.checkout();
+  EXPECT_EQ(pool.stats().sessions, 1u);
+}
+
+TEST(PooledInferenceBackend, ManyCamerasShareFewSessions) {
+  auto created = std::make_shared<std::atomic<int>>(0);
+  auto pool = std::make_shared<nv::InferenceSessionPool>(counting_factory(created),
+                                                         nv::SessionPoolOptions{.max_sessions = 2});
+  constexpr int kCameras = 8;
+  std::vector<std::unique_ptr<nv::PooledInferenceBackend>> backends;
+  for (int i = 0; i < kCameras; ++i) {
+    backends.push_back(std::make_unique<nv::PooledInferenceBackend>(pool));
+  }
+  backends.front()->warmup();
+  EXPECT_EQ(created->load(), 2);
+
+  std::atomic<int> failures{0};
+  {
+    std::vector<std::jthread> threads;
+    for (auto& backend : backends) {
+      threads.emplace_back([&failures, b = backend.get()] {
+        const nc::Frame frame = make_frame();
+        for (int i = 0; i < 50; ++i) {
+          auto valid = b->validate_input(frame);
+          auto result = b->infer(frame);
+          if (!valid || !result || result->num_detections != 1u) ++failures;
+        }
+      });
+    }
+  }
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_EQ(created->load(), 2);
+  EXPECT_EQ(pool->stats().checkouts, 50u * kCameras);
+  EXPECT_EQ(pool->stats().in_use, 0u);
+}
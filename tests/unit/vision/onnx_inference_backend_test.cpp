@@ -8,11 +8,14 @@
 #include <normitri/vision/onnx_inference_backend.hpp>
 #include <onnxruntime_cxx_api.h>
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace nv = normitri::vision;
@@ -101,6 +104,32 @@ TEST(OnnxInferenceBackend, ValidateInputAcceptsMatchingFrame) {
   ASSERT_TRUE(valid.has_value());
 }
 
+TEST(OnnxInferenceBackend, ValidateInputRejectsWrongElementType) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  nv::OnnxInferenceBackend backend(path);  // float32 model
+  nc::Frame f = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  f.set_element_type(nc::ElementType::Float16);
+  auto valid = backend.validate_input(f);
+  ASSERT_FALSE(valid.has_value());
+  EXPECT_EQ(valid.error(), nc::PipelineError::InvalidFrame);
+}
+
+TEST(OnnxInferenceBackend, InferAcceptsChwFrame) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  nv::OnnxInferenceBackend backend(path);  // NCHW model: bound without a transpose
+  nc::Frame f = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  f.set_layout(nc::TensorLayout::CHW);
+  auto result = backend.infer(f);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->scores.size(), result->num_detections);
+}
+
 TEST(OnnxInferenceBackend, InferReturnsSaneResult) {
   const std::string path = get_test_model_path();
   if (path.empty()) {
@@ -128,3 +157,187 @@ TEST(OnnxInferenceBackend, WarmupDoesNotThrow) {
   nv::OnnxInferenceBackend backend(path);
   EXPECT_NO_THROW(backend.warmup());
 }
+
+TEST(OnnxInferenceBackend, InferBatchMatchesPerFrameInfer) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  nv::OnnxInferenceBackend backend(path);  // batched if the model's batch dim is dynamic
+  std::vector<nc::Frame> frames;
+  for (int i = 0; i < 3; ++i) {
+    frames.push_back(make_float_frame(kDefaultModelWidth, kDefaultModelHeight));
+  }
+  frames[1].set_layout(nc::TensorLayout::CHW);  // mixed layouts share one tensor
+  auto batch = backend.infer_batch(frames);
+  ASSERT_TRUE(batch.has_value());
+  ASSERT_EQ(batch->size(), frames.size());
+  auto single = backend.infer(frames[0]);
+  ASSERT_TRUE(single.has_value());
+  for (const auto& result : *batch) {
+    ASSERT_EQ(result.num_detections, single->num_detections);
+    ASSERT_EQ(result.scores.size(), single->scores.size());
+    for (std::size_t i = 0; i < result.scores.size(); ++i) {
+      EXPECT_NEAR(result.scores[i], single->scores[i], 1e-4f);
+    }
+  }
+}
+
+TEST(OnnxInferenceBackend, CloneOutlivesOriginalAndMatchesIt) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  auto backend = std::make_unique<nv::OnnxInferenceBackend>(path);
+  const nc::Frame f = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  auto expected = backend->infer(f);
+  ASSERT_TRUE(expected.has_value());
+  std::unique_ptr<nv::IInferenceBackend> replica = backend->clone();
+  ASSERT_NE(replica, nullptr);
+  backend.reset();  // the replica keeps the shared session alive
+  auto result = replica->infer(f);
+  ASSERT_TRUE(result.has_value());
+  ASSERT_EQ(result->scores.size(), expected->scores.size());
+  for (std::size_t i = 0; i < result->scores.size(); ++i) {
+    EXPECT_FLOAT_EQ(result->scores[i], expected->scores[i]);
+  }
+}
+
+TEST(OnnxInferenceBackend, OptimizedModelCacheMissThenHit) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  const auto cache_dir = std::filesystem::temp_directory_path() / "normitri_onnx_cache_test";
+  std::filesystem::remove_all(cache_dir);
+  nv::OnnxSessionOptions options;
+  options.optimized_model_cache_dir = cache_dir.string();
+
+  nv::OnnxInferenceBackend cold(path, {}, {}, options);
+  EXPECT_EQ(cold.cache_status(), nv::OnnxCacheStatus::Miss);
+  nv::OnnxInferenceBackend warm(path, {}, {}, options);
+  EXPECT_EQ(warm.cache_status(), nv::OnnxCacheStatus::Hit);
+
+  // A different optimization level is a different entry.
+  options.graph_optimization = nv::OnnxGraphOptimization::Basic;
+  nv::OnnxInferenceBackend other(path, {}, {}, options);
+  EXPECT_EQ(other.cache_status(), nv::OnnxCacheStatus::Miss);
+
+  auto result = warm.infer(make_float_frame(kDefaultModelWidth, kDefaultModelHeight));
+  ASSERT_TRUE(result.has_value());
+  std::filesystem::remove_all(cache_dir);
+}
+
+TEST(OnnxInferenceBackend, SharedModelWeightsMatchPrivateSession) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  const auto cache_dir = std::filesystem::temp_directory_path() / "normitri_onnx_share_test";
+  std::filesystem::remove_all(cache_dir);
+  nv::OnnxSessionOptions options;
+  options.optimized_model_cache_dir = cache_dir.string();
+  options.share_model_weights = true;
+
+  nv::OnnxInferenceBackend reference(path);
+  nv::OnnxInferenceBackend cold(path, {}, {}, options);
+  nv::OnnxInferenceBackend first(path, {}, {}, options);
+  nv::OnnxInferenceBackend second(path, {}, {}, options);  // same registry entry as first
+  EXPECT_EQ(second.cache_status(), nv::OnnxCacheStatus::Hit);
+
+  const auto frame = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  auto expected = reference.infer(frame);
+  ASSERT_TRUE(expected.has_value());
+  for (nv::OnnxInferenceBackend* backend : {&cold, &first, &second}) {
+    auto result = backend->infer(frame);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->num_detections, expected->num_detections);
+    ASSERT_EQ(result->scores.size(), expected->scores.size());
+    for (std::size_t i = 0; i < expected->scores.size(); ++i) {
+      EXPECT_NEAR(result->scores[i], expected->scores[i], 1e-4f);
+    }
+  }
+  std::filesystem::remove_all(cache_dir);
+}
+
+// One backend, many threads: run under NORMITRI_ENABLE_TSAN to check infer() for data races.
+TEST(OnnxInferenceBackend, ConcurrentInferOnOneBackend) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  nv::OnnxInferenceBackend backend(path);
+  const nc::Frame hwc = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  nc::Frame chw = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  chw.set_layout(nc::TensorLayout::CHW);
+  auto expected = backend.infer(chw);
+  ASSERT_TRUE(expected.has_value());
+
+  constexpr int kThreads = 8;
+  constexpr int kIterations = 16;
+  std::atomic<int> failures{0};
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < kIterations; ++i) {
+          // Alternate the zero-copy path and the per-thread transpose path; batch now and then.
+          const nc::Frame& frame = (t + i) % 2 == 0 ? hwc : chw;
+          std::expected<std::vector<nv::InferenceResult>, nc::PipelineError> results;
+          if (i % 4 == 3) {
+            const std::vector<nc::Frame> batch{hwc, chw};
+            results = backend.infer_batch(batch);
+          } else {
+            auto single = backend.infer(frame);
+            if (single) {
+              results = std::vector<nv::InferenceResult>{std::move(*single)};
+            } else {
+              results = std::unexpected(single.error());
+            }
+          }
+          if (!results) {
+            ++failures;
+            continue;
+          }
+          for (const auto& r : *results) {
+            if (r.num_detections != expected->num_detections) ++failures;
+          }
+        }
+      });
+    }
+  }
+  EXPECT_EQ(failures.load(), 0);
+}
+
+// Bindings persist between runs: a different input buffer or batch size must be rebound.
+TEST(OnnxInferenceBackend, RebindsWhenInputOrBatchChanges) {
+  const std::string path = get_test_model_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_ONNX_MODEL to run (path to .onnx file)";
+  }
+  nv::OnnxInferenceBackend backend(path);
+  nc::Frame zeros = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  zeros.set_layout(nc::TensorLayout::CHW);
+  nc::Frame gray = make_float_frame(kDefaultModelWidth, kDefaultModelHeight);
+  gray.set_layout(nc::TensorLayout::CHW);
+  auto bytes = gray.data();
+  auto* values = reinterpret_cast<float*>(bytes.data());
+  for (std::size_t i = 0; i < bytes.size() / sizeof(float); ++i) values[i] = 0.5f;
+
+  auto first = backend.infer(zeros);
+  auto other = backend.infer(gray);
+  const std::vector<nc::Frame> pair{gray, zeros};
+  auto batch = backend.infer_batch(pair);
+  auto again = backend.infer(zeros);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(other.has_value());
+  ASSERT_TRUE(batch.has_value());
+  ASSERT_TRUE(again.has_value());
+  ASSERT_EQ(batch->size(), 2u);
+  EXPECT_EQ(again->scores, first->scores);
+  EXPECT_EQ(again->boxes, first->boxes);
+  ASSERT_EQ((*batch)[0].scores.size(), other->scores.size());
+  for (std::size_t i = 0; i < other->scores.size(); ++i) {
+    EXPECT_NEAR((*batch)[0].scores[i], other->scores[i], 1e-4f);
+  }
+}
@@ -0,0 +1,92 @@
+#include <normitri/core/error.hpp>
+#include <normitri/core/frame.hpp>
+#include <normitri/vision/preprocess_stage.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstring>
+#include <variant>
+#include <vector>
+
+namespace nv = normitri::vision;
+namespace nc = normitri::core;
+
+namespace {
+
+nc::Frame make_frame(std::uint32_t w, std::uint32_t h, nc::PixelFormat fmt,
+                     const std::vector<std::uint8_t>& pixels) {
+  std::vector<std::byte> buf(pixels.size());
+  std::memcpy(buf.data(), pixels.data(), pixels.size());
+  return nc::Frame(w, h, fmt, std::move(buf));
+}
+
+std::vector<float> planes(const nc::Frame& f) {
+  std::vector<float> out(f.size_bytes() / sizeof(float));
+  std::memcpy(out.data(), f.data().data(), f.size_bytes());
+  return out;
+}
+
+}  // namespace
+
+TEST(PreprocessStage, SameSizeTransposesToChw) {
+  // 2x1 BGR: pixel0 = (1,2,3), pixel1 = (4,5,6)
+  auto in = make_frame(2, 1, nc::PixelFormat::BGR8, {1, 2, 3, 4, 5, 6});
+  nv::PreprocessStage stage({.width = 2, .height = 1, .mean = 0.f, .scale = 1.f});
+  auto out = stage.process(in);
+  ASSERT_TRUE(out.has_value());
+  const auto& f = std::get<nc::Frame>(*out);
+  EXPECT_EQ(f.format(), nc::PixelFormat::Float32Planar);
+  EXPECT_EQ(f.layout(), nc::TensorLayout::CHW);
+  EXPECT_EQ(planes(f), (std::vector<float>{1, 4, 2, 5, 3, 6}));
+}
+
+TEST(PreprocessStage, SwapsChannelsAndNormalizes) {
+  auto in = make_frame(1, 1, nc::PixelFormat::BGRA8, {10, 20, 30, 255});
+  nv::PreprocessStage stage({.width = 1,
+                             .height = 1,
+                             .mean = 10.f,
+                             .scale = 0.5f,
+                             .channel_order = nc::PixelFormat::RGB8});
+  auto out = stage.process(in);
+  ASSERT_TRUE(out.has_value());
+  EXPECT_EQ(planes(std::get<nc::Frame>(*out)), (std::vector<float>{10, 5, 0}));
+}
+
+TEST(PreprocessStage, DownscaleByTwoAveragesPixelBlocks) {
+  // 2x2 gray -> 1x1: the pixel center lands between all four source pixels.
+  auto in = make_frame(2, 2, nc::PixelFormat::Grayscale8, {0, 10, 20, 30});
+  nv::PreprocessStage stage({.width = 1, .height = 1, .mean = 0.f, .scale = 1.f});
+  auto out = stage.process(in);
+  ASSERT_TRUE(out.has_value());
+  EXPECT_EQ(planes(std::get<nc::Frame>(*out)), (std::vector<float>{15, 15, 15}));
+}
+
+TEST(PreprocessStage, UpscaleInterpolatesAndClampsEdges) {
+  auto in = make_frame(2, 1, nc::PixelFormat::Grayscale8, {0, 100});
+  nv::PreprocessStage stage({.width = 4, .height = 1, .mean = 0.f, .scale = 1.f});
+  auto out = stage.process(in);
+  ASSERT_TRUE(out.has_value());
+  const auto p = planes(std::get<nc::Frame>(*out));
+  ASSERT_EQ(p.size(), 12u);
+  EXPECT_FLOAT_EQ(p[0], 0.f);
+  EXPECT_FLOAT_EQ(p[1], 25.f);
+  EXPECT_FLOAT_EQ(p[2], 75.f);
+  EXPECT_FLOAT_EQ(p[3], 100.f);
+}
+
+TEST(PreprocessStage, ProcessIntoReusesOutputBuffer) {
+  auto in = make_frame(4, 4, nc::PixelFormat::RGB8, std::vector<std::uint8_t>(4 * 4 * 3, 9));
+  nv::PreprocessStage stage({.width = 2, .height = 2});
+  nc::Frame out;
+  ASSERT_TRUE(stage.process_into(in, out).has_value());
+  const std::byte* first = out.data().data();
+  ASSERT_TRUE(stage.process_into(in, out).has_value());
+  EXPECT_EQ(out.data().data(), first);
+}
+
+TEST(PreprocessStage, RejectsUnsupportedInput) {
+  nv::PreprocessStage stage({});
+  EXPECT_EQ(stage.process(nc::Frame{}).error(), nc::PipelineError::InvalidFrame);
+  std::vector<std::byte> buf(2 * 2 * 3 * sizeof(float));
+  nc::Frame planar(2, 2, nc::PixelFormat::Float32Planar, std::move(buf));
+  EXPECT_EQ(stage.process(planar).error(), nc::PipelineError::InvalidFrame);
+}
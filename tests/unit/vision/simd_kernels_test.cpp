@@ -0,0 +1,158 @@
+#include <normitri/vision/simd_kernels.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace simd = normitri::vision::simd;
+
+namespace {
+
+// Odd sizes exercise the vector bodies and the scalar tails.
+constexpr std::size_t kPixels[] = {0, 1, 7, 8, 17, 33, 257};
+
+std::vector<simd::SimdLevel> supported_levels() {
+  std::vector<simd::SimdLevel> levels;
+  for (auto level : {simd::SimdLevel::Scalar, simd::SimdLevel::SSE41, simd::SimdLevel::AVX2,
+                     simd::SimdLevel::AVX512}) {
+    if (level <= simd::detected_simd_level()) levels.push_back(level);
+  }
+  return levels;
+}
+
+std::vector<std::uint8_t> pattern_u8(std::size_t n) {
+  std::vector<std::uint8_t> v(n);
+  for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<std::uint8_t>(i * 37u + 11u);
+  return v;
+}
+
+}  // namespace
+
+TEST(SimdKernels, LevelSelectionClampsToDetected) {
+  EXPECT_EQ(simd::simd_kernels(simd::SimdLevel::Scalar).level, simd::SimdLevel::Scalar);
+  EXPECT_LE(simd::simd_kernels().level, simd::detected_simd_level());
+  EXPECT_EQ(simd::simd_kernels(simd::SimdLevel::AVX512).level, simd::detected_simd_level());
+}
+
+TEST(SimdKernels, DeinterleaveMatchesReference) {
+  for (auto level : supported_levels()) {
+    const auto& k = simd::simd_kernels(level);
+    for (std::size_t n : kPixels) {
+      std::vector<float> src(3 * n);
+      for (std::size_t i = 0; i < src.size(); ++i) src[i] = static_cast<float>(i);
+      std::vector<float> d0(n, -1.f), d1(n, -1.f), d2(n, -1.f);
+      k.deinterleave3_f32(src.data(), n, d0.data(), d1.data(), d2.data());
+      for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(d0[i], src[3 * i]) << simd::simd_level_name(level) << " n=" << n;
+        ASSERT_EQ(d1[i], src[3 * i + 1]) << simd::simd_level_name(level) << " n=" << n;
+        ASSERT_EQ(d2[i], src[3 * i + 2]) << simd::simd_level_name(level) << " n=" << n;
+      }
+    }
+  }
+}
+
+TEST(SimdKernels, U8ToPlanarMatchesReferenceWithChannelSwap) {
+  const std::array<std::uint32_t, 3> swap{2, 1, 0};
+  const float scale = 1.f / 255.f;
+  const float bias = -0.5f;
+  for (auto level : supported_levels()) {
+    const auto& k = simd::simd_kernels(level);
+    for (std::uint32_t channels : {1u, 3u, 4u}) {
+      const std::array<std::uint32_t, 3> map =
+          channels == 1 ? std::array<std::uint32_t, 3>{0, 0, 0} : swap;
+      for (std::size_t n : kPixels) {
+        const auto src = pattern_u8(n * channels);
+        std::vector<float> d0(n), d1(n), d2(n);
+        k.u8_to_f32_planar(src.data(), n, channels, map, scale, bias, d0.data(), d1.data(),
+                           d2.data());
+        const std::vector<float>* planes[3] = {&d0, &d1, &d2};
+        for (std::size_t c = 0; c < 3; ++c) {
+          for (std::size_t i = 0; i < n; ++i) {
+            const float expected = static_cast<float>(src[i * channels + map[c]]) * scale + bias;
+            ASSERT_NEAR((*planes[c])[i], expected, 1e-6f)
+                << simd::simd_level_name(level) << " channels=" << channels << " n=" << n;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(SimdKernels, U8ToF32MatchesReference) {
+  for (auto level : supported_levels()) {
+    const auto& k = simd::simd_kernels(level);
+    for (std::size_t n : kPixels) {
+      const auto src = pattern_u8(n * 3);
+      std::vector<float> dst(src.size());
+      k.u8_to_f32(src.data(), src.size(), 2.f, 1.f, dst.data());
+      for (std::size_t i = 0; i < src.size(); ++i) {
+        ASSERT_FLOAT_EQ(dst[i], static_cast<float>(src[i]) * 2.f + 1.f)
+            << simd::simd_level_name(level);
+      }
+    }
+  }
+}
+
+TEST(SimdKernels, SelectAtLeastMatchesReference) {
+  const float threshold = 0.5f;
+  for (auto level : supported_levels()) {
+    const auto& k = simd::simd_kernels(level);
+    for (std::size_t stride : {std::size_t{1}, std::size_t{6}}) {
+      for (std::size_t n : kPixels) {
+        std::vector<float> src(n * stride, -1.f);
+        for (std::size_t i = 0; i < n; ++i) {
+          src[i * stride] = static_cast<float>((i * 37u + 11u) % 100u) / 100.f;
+        }
+        if (n > 5) src[5 * stride] = std::numeric_limits<float>::quiet_NaN();
+        std::vector<std::uint32_t> expected;
+        for (std::size_t i = 0; i < n; ++i) {
+          if (!(src[i * stride] < threshold)) expected.push_back(static_cast<std::uint32_t>(i));
+        }
+        std::vector<std::uint32_t> indices(n + 1, 0xFFFFFFFFu);
+        const std::size_t kept = k.select_at_least(src.data(), n, stride, threshold,
+                                                   indices.data());
+        ASSERT_EQ(kept, expected.size())
+            << simd::simd_level_name(level) << " n=" << n << " stride=" << stride;
+        for (std::size_t i = 0; i < kept; ++i) {
+          ASSERT_EQ(indices[i], expected[i])
+              << simd::simd_level_name(level) << " n=" << n << " stride=" << stride;
+        }
+      }
+    }
+  }
+}
+
+TEST(SimdKernels, SuppressOverlapsMatchesReference) {
+  const float iou_threshold = 0.45f;
+  for (auto level : supported_levels()) {
+    const auto& k = simd::simd_kernels(level);
+    for (std::size_t n : kPixels) {
+      if (n == 0) continue;
+      std::vector<float> x1(n), y1(n), x2(n), y2(n), area(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        x1[i] = static_cast<float>((i * 13u) % 17u);
+        y1[i] = static_cast<float>((i * 7u) % 11u);
+        x2[i] = x1[i] + 4.f + static_cast<float>(i % 5u);
+        y2[i] = y1[i] + 3.f + static_cast<float>(i % 3u);
+        area[i] = (x2[i] - x1[i]) * (y2[i] - y1[i]);
+      }
+      const simd::BoxesSoA boxes{x1.data(), y1.data(), x2.data(), y2.data(), area.data()};
+      std::vector<std::uint32_t> suppressed(n, 0u);
+      if (n > 3) suppressed[n - 1] = 1u;  // already suppressed stays so
+      k.suppress_overlaps(boxes, 0, 1, n, iou_threshold, suppressed.data());
+      for (std::size_t j = 1; j < n; ++j) {
+        const float iw = std::max(0.f, std::min(x2[0], x2[j]) - std::max(x1[0], x1[j]));
+        const float ih = std::max(0.f, std::min(y2[0], y2[j]) - std::max(y1[0], y1[j]));
+        const float inter = iw * ih;
+        const bool expected = inter / (area[0] + area[j] - inter) > iou_threshold ||
+                              (n > 3 && j == n - 1);
+        ASSERT_EQ(suppressed[j] != 0u, expected) << simd::simd_level_name(level) << " n=" << n
+                                                 << " j=" << j;
+      }
+      EXPECT_EQ(suppressed[0], 0u);
+    }
+  }
+}
@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <filesystem>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -126,3 +127,20 @@ TEST(TensorRTInferenceBackend, WarmupDoesNotThrow) {
   nv::TensorRTInferenceBackend backend(path);
   EXPECT_NO_THROW(backend.warmup());
 }
+
+TEST(TensorRTInferenceBackend, CloneRunsOnTheSameEngine) {
+  const std::string path = get_test_engine_path();
+  if (path.empty()) {
+    GTEST_SKIP() << "Set NORMITRI_TEST_TENSORRT_ENGINE to run (path to .engine file)";
+  }
+  nv::TensorRTInferenceBackend backend(path);
+  std::unique_ptr<nv::IInferenceBackend> replica = backend.clone();
+  ASSERT_NE(replica, nullptr);
+  const nc::Frame f = make_float_frame(kDefaultEngineWidth, kDefaultEngineHeight);
+  auto expected = backend.infer(f);
+  auto result = replica->infer(f);
+  ASSERT_TRUE(expected.has_value());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->num_detections, expected->num_detections);
+  EXPECT_EQ(result->scores, expected->scores);
+}